@@ -787,6 +787,19 @@ This can be used to identify if a command is long-running to display a progress
 )");
   virtual float GetCurrentProcessingTime() = 0;
 
+  DOCUMENT(R"(Make a tagged non-blocking invoke call onto the query thread.
+
+The query thread runs alongside the replay thread, so that quick lookups aren't stuck behind long
+replay work such as pixel history or saving textures. The callback must only use the functions of
+:class:`~renderdoc.ReplayController` which are documented as being safe to call from any thread.
+
+As with the tagged :meth:`AsyncInvoke`, any request still queued with the same tag is removed.
+
+:param str tag: The tag to identify this callback.
+:param InvokeCallback method: The function to callback on the query thread.
+)");
+  virtual void QueryInvoke(const rdcstr &tag, InvokeCallback method) = 0;
+
   DOCUMENT(R"(Make a tagged non-blocking invoke call onto the replay thread.
 
 This tagged function is for cases when we might send a request - e.g. to pick a vertex or pixel -
@@ -266,19 +266,33 @@ private:
   QThread *m_Thread;
   QSemaphore completed;
   bool m_SelfDelete = false;
+  bool m_Joinable = false;
 
 public slots:
   void process()
   {
     m_func();
     m_Thread->quit();
-    m_Thread = NULL;
+    if(!m_Joinable)
+      m_Thread = NULL;
     if(m_SelfDelete)
       deleteLater();
     completed.acquire();
   }
 
   void selfDelete(bool d) { m_SelfDelete = d; }
+  // a joinable thread keeps its QThread until the LambdaThread is deleted, so the owner can wait()
+  // for the thread to exit and then delete it directly. Must be set before start().
+  void joinable(bool j)
+  {
+    if(j == m_Joinable)
+      return;
+    m_Joinable = j;
+    if(j)
+      QObject::disconnect(m_Thread, &QThread::finished, m_Thread, &QThread::deleteLater);
+    else
+      QObject::connect(m_Thread, &QThread::finished, m_Thread, &QThread::deleteLater);
+  }
 public:
   explicit LambdaThread(std::function<void()> f)
   {
@@ -290,6 +304,15 @@ public:
     QObject::connect(m_Thread, &QThread::finished, m_Thread, &QThread::deleteLater);
   }
 
+  ~LambdaThread()
+  {
+    if(m_Joinable)
+    {
+      m_Thread->wait();
+      delete m_Thread;
+    }
+  }
+
   void start(QThread::Priority prio = QThread::InheritPriority) { m_Thread->start(prio); }
   bool isRunning() { return completed.available(); }
   bool wait(unsigned long time = ULONG_MAX)
@@ -242,19 +242,7 @@ void ReplayManager::AsyncInvoke(const rdcstr &tag, ReplayManager::InvokeCallback
 
   {
     QMutexLocker autolock(&m_RenderLock);
-    for(int i = 0; i < m_RenderQueue.count();)
-    {
-      if(m_RenderQueue[i]->tag == qtag)
-      {
-        InvokeHandle *cmd = m_RenderQueue.takeAt(i);
-        if(cmd->selfdelete)
-          delete cmd;
-      }
-      else
-      {
-        i++;
-      }
-    }
+    RemoveTagged(m_RenderQueue, qtag);
   }
 
   InvokeHandle *cmd = new InvokeHandle(m, qtag);
@@ -271,6 +259,24 @@ void ReplayManager::AsyncInvoke(ReplayManager::InvokeCallback m)
   PushInvoke(cmd);
 }
 
+void ReplayManager::QueryInvoke(const rdcstr &tag, ReplayManager::InvokeCallback m)
+{
+  QString qtag(tag);
+
+  QMutexLocker autolock(&m_QueryLock);
+
+  if(!m_QueryRunning)
+    return;
+
+  RemoveTagged(m_QueryQueue, qtag);
+
+  InvokeHandle *cmd = new InvokeHandle(m, qtag);
+  cmd->selfdelete = true;
+
+  m_QueryQueue.enqueue(cmd);
+  m_QueryCondition.wakeAll();
+}
+
 void ReplayManager::BlockInvoke(ReplayManager::InvokeCallback m)
 {
   InvokeHandle *cmd = new InvokeHandle(m);
@@ -415,6 +421,39 @@ void ReplayManager::PushInvoke(ReplayManager::InvokeHandle *cmd)
   m_RenderCondition.wakeAll();
 }
 
+void ReplayManager::RemoveTagged(QQueue<InvokeHandle *> &queue, const QString &tag)
+{
+  for(int i = 0; i < queue.count();)
+  {
+    if(queue[i]->tag == tag)
+    {
+      InvokeHandle *cmd = queue.takeAt(i);
+      if(cmd->selfdelete)
+        delete cmd;
+    }
+    else
+    {
+      i++;
+    }
+  }
+}
+
+void ReplayManager::ReleaseQueue(QQueue<InvokeHandle *> &queue)
+{
+  for(InvokeHandle *cmd : queue)
+  {
+    if(cmd == NULL)
+      continue;
+
+    if(cmd->selfdelete)
+      delete cmd;
+    else
+      cmd->processed.release();
+  }
+
+  queue.clear();
+}
+
 void ReplayManager::run(int proxyRenderer, const QString &capturefile,
                         RENDERDOC_ProgressCallback progress)
 {
@@ -448,6 +487,15 @@ void ReplayManager::run(int proxyRenderer, const QString &capturefile,
 
   m_Running = true;
 
+  {
+    QMutexLocker autolock(&m_QueryLock);
+    m_QueryRunning = true;
+  }
+
+  m_QueryThread = new LambdaThread([this]() { runQueries(); });
+  m_QueryThread->joinable(true);
+  m_QueryThread->start();
+
   // main render command loop
   while(m_Running)
   {
@@ -498,18 +546,20 @@ void ReplayManager::run(int proxyRenderer, const QString &capturefile,
       m_RenderQueue.swap(queue);
     }
 
-    for(InvokeHandle *cmd : queue)
-    {
-      if(cmd == NULL)
-        continue;
+    ReleaseQueue(queue);
+  }
 
-      if(cmd->selfdelete)
-        delete cmd;
-      else
-        cmd->processed.release();
-    }
+  // the query thread must be finished before the renderer goes away
+  {
+    QMutexLocker autolock(&m_QueryLock);
+    m_QueryRunning = false;
+    m_QueryCondition.wakeAll();
   }
 
+  m_QueryThread->wait();
+  delete m_QueryThread;
+  m_QueryThread = NULL;
+
   // close the core renderer
   if(m_Remote)
     m_Remote->CloseCapture(m_Renderer);
@@ -522,3 +572,38 @@ void ReplayManager::run(int proxyRenderer, const QString &capturefile,
     m_CaptureFile->Shutdown();
   m_CaptureFile = NULL;
 }
+
+void ReplayManager::runQueries()
+{
+  for(;;)
+  {
+    InvokeHandle *cmd = NULL;
+
+    {
+      QMutexLocker autolock(&m_QueryLock);
+      while(m_QueryRunning && m_QueryQueue.isEmpty())
+        m_QueryCondition.wait(&m_QueryLock);
+
+      if(!m_QueryRunning)
+        break;
+
+      cmd = m_QueryQueue.dequeue();
+    }
+
+    if(cmd->method != NULL)
+      cmd->method(m_Renderer);
+
+    // query invokes are never blocking, so they are always deleted here
+    delete cmd;
+  }
+
+  QQueue<InvokeHandle *> queue;
+
+  {
+    QMutexLocker autolock(&m_QueryLock);
+    m_QueryQueue.swap(queue);
+  }
+
+  ReleaseQueue(queue);
+}
+
@@ -62,6 +62,7 @@ public:
   // comes in, we remove any other requests in the queue before it that have the same tag
   void AsyncInvoke(const rdcstr &tag, InvokeCallback m);
   void AsyncInvoke(InvokeCallback m);
+  void QueryInvoke(const rdcstr &tag, InvokeCallback m);
   void BlockInvoke(InvokeCallback m);
 
   void CancelReplayLoop();
@@ -114,6 +115,10 @@ private:
   };
 
   void run(int proxyRenderer, const QString &capturefile, RENDERDOC_ProgressCallback progress);
+  void runQueries();
+
+  static void RemoveTagged(QQueue<InvokeHandle *> &queue, const QString &tag);
+  static void ReleaseQueue(QQueue<InvokeHandle *> &queue);
 
   QMutex m_TimerLock;
   QElapsedTimer m_CommandTimer;
@@ -127,6 +132,14 @@ private:
 
   void PushInvoke(InvokeHandle *cmd);
 
+  // requests that only read immutable data from the controller are run on a second thread, so they
+  // don't wait behind the replay.
+  QMutex m_QueryLock;
+  QQueue<InvokeHandle *> m_QueryQueue;
+  QWaitCondition m_QueryCondition;
+  LambdaThread *m_QueryThread = NULL;
+  volatile bool m_QueryRunning = false;
+
   QMutex m_RemoteLock;
   RemoteHost *m_RemoteHost = NULL;
   IRemoteServer *m_Remote = NULL;
@@ -403,6 +403,54 @@ struct TypeConversion<rdcpair<A, B>, false>
   static PyObject *ConvertToPy(const rdcpair<A, B> &in) { return ConvertToPy(in, NULL); }
 };
 
+// bytebufs are normally given to python as bytes. The *DataView readback functions instead return a
+// memoryview over an object that owns the data, so large readbacks can be handed to e.g.
+// numpy.frombuffer without copying them again. The data lives as long as anything in python still
+// references it.
+struct PyBytebufStorage
+{
+  PyObject_HEAD;
+  bytebuf *buf;
+};
+
+inline int PyBytebufStorage_getbuffer(PyObject *self, Py_buffer *view, int flags)
+{
+  static byte empty = 0;
+  bytebuf *buf = ((PyBytebufStorage *)self)->buf;
+  return PyBuffer_FillInfo(view, self, buf->empty() ? &empty : buf->data(),
+                           (Py_ssize_t)buf->size(), 0, flags);
+}
+
+inline void PyBytebufStorage_dealloc(PyObject *self)
+{
+  delete((PyBytebufStorage *)self)->buf;
+  Py_TYPE(self)->tp_free(self);
+}
+
+inline PyTypeObject *GetBytebufStorageType()
+{
+  static PyBufferProcs bufferProcs = {&PyBytebufStorage_getbuffer, NULL};
+  static PyTypeObject type = {PyVarObject_HEAD_INIT(NULL, 0)};
+
+  if(type.tp_name == NULL)
+  {
+    type.tp_name = "renderdoc.BytebufStorage";
+    type.tp_basicsize = sizeof(PyBytebufStorage);
+    type.tp_flags = Py_TPFLAGS_DEFAULT;
+    type.tp_doc = "Owns the memory behind a memoryview of data returned from RenderDoc.";
+    type.tp_dealloc = &PyBytebufStorage_dealloc;
+    type.tp_as_buffer = &bufferProcs;
+
+    if(PyType_Ready(&type) < 0)
+    {
+      type.tp_name = NULL;
+      return NULL;
+    }
+  }
+
+  return &type;
+}
+
 // specialisation for bytebuf
 template <>
 struct TypeConversion<bytebuf, false>
@@ -411,13 +459,21 @@ struct TypeConversion<bytebuf, false>
   // nicer failure error messages out with the index that failed
   static int ConvertFromPy(PyObject *in, bytebuf &out, int *failIdx)
   {
-    if(!PyBytes_Check(in))
+    // accept bytes as well as anything else exposing contiguous memory, such as memoryviews or
+    // numpy arrays.
+    if(!PyObject_CheckBuffer(in))
       return SWIG_TypeError;
 
-    Py_ssize_t len = PyBytes_Size(in);
+    Py_buffer view;
+    if(PyObject_GetBuffer(in, &view, PyBUF_SIMPLE) != 0)
+    {
+      PyErr_Clear();
+      return SWIG_TypeError;
+    }
+
+    out.assign((const byte *)view.buf, (size_t)view.len);
 
-    out.resize((size_t)len);
-    memcpy(out.data(), PyBytes_AsString(in), out.size());
+    PyBuffer_Release(&view);
 
     return SWIG_OK;
   }
@@ -429,6 +485,26 @@ struct TypeConversion<bytebuf, false>
     return SWIG_Py_Void();
   }
 
+  // returns a memoryview instead of bytes, and takes ownership of the bytebuf
+  static PyObject *ConvertToPyView(bytebuf *owned)
+  {
+    PyTypeObject *type = GetBytebufStorageType();
+    PyBytebufStorage *storage = type ? PyObject_New(PyBytebufStorage, type) : NULL;
+
+    if(!storage)
+    {
+      delete owned;
+      return NULL;
+    }
+
+    storage->buf = owned;
+
+    // the memoryview holds the only reference to the storage
+    PyObject *ret = PyMemoryView_FromObject((PyObject *)storage);
+    Py_DECREF(storage);
+    return ret;
+  }
+
   static PyObject *ConvertToPy(const bytebuf &in, int *failIdx)
   {
     return PyBytes_FromStringAndSize((const char *)in.data(), (Py_ssize_t)in.size());
@@ -190,6 +190,48 @@ TEMPLATE_ARRAY_DECLARE(rdcarray);
   %rename("%s") count;
 }
 
+// python-only readback functions that hand the data over as a memoryview instead of copying it into
+// bytes
+%extend IReplayController {
+  DOCUMENT(R"(Retrieve the contents of a range of a buffer as a ``memoryview``.
+
+This is the same as :meth:`GetBufferData`, but the data isn't copied into a ``bytes``. The
+memoryview owns its data, so it can be passed to e.g. ``numpy.frombuffer`` without any further copy.
+
+:param ResourceId buff: The id of the buffer to retrieve data from.
+:param int offset: The byte offset to the start of the range.
+:param int len: The length of the range, or 0 to retrieve the rest of the bytes in the buffer.
+:return: The requested buffer contents.
+:rtype: ``memoryview``
+)");
+  PyObject *GetBufferDataView(ResourceId buff, uint64_t offset, uint64_t len) {
+    bytebuf *owned = new bytebuf;
+    bytebuf data = $self->GetBufferData(buff, offset, len);
+    owned->swap(data);
+    return TypeConversion<bytebuf>::ConvertToPyView(owned);
+  }
+
+  DOCUMENT(R"(Retrieve the contents of one subresource of a texture as a ``memoryview``.
+
+This is the same as :meth:`GetTextureData`, but the data isn't copied into a ``bytes``. The
+memoryview owns its data, so it can be passed to e.g. ``numpy.frombuffer`` without any further copy.
+
+:param ResourceId tex: The id of the texture to retrieve data from.
+:param int arrayIdx: The slice of an array or 3D texture, or face of a cubemap texture.
+:param int mip: The mip level to pick from.
+:return: The requested texture contents.
+:rtype: ``memoryview``
+)");
+  PyObject *GetTextureDataView(ResourceId tex, uint32_t arrayIdx, uint32_t mip) {
+    bytebuf *owned = new bytebuf;
+    bytebuf data = $self->GetTextureData(tex, arrayIdx, mip);
+    owned->swap(data);
+    return TypeConversion<bytebuf>::ConvertToPyView(owned);
+  }
+}
+
+%feature("docstring") "";
+
 // add python array members that aren't in slots
 EXTEND_ARRAY_CLASS_METHODS(rdcarray)
 EXTEND_ARRAY_CLASS_METHODS(StructuredChunkList)
@@ -218,6 +260,7 @@ TEMPLATE_ARRAY_INSTANTIATE(rdcarray, EnvironmentModification)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, EventUsage)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, PathEntry)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, PixelModification)
+TEMPLATE_ARRAY_INSTANTIATE(rdcarray, ProbeStatistics)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, ResourceDescription)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, ResourceId)
 TEMPLATE_ARRAY_INSTANTIATE(rdcarray, ShaderCompileFlag)
@@ -27,6 +27,7 @@
 #include <QMouseEvent>
 #include <QPainter>
 #include <QProxyStyle>
+#include <QStack>
 #include <QStylePainter>
 #include <QToolTip>
 #include <QWheelEvent>
@@ -327,6 +328,30 @@ void RDTreeView::drawBranches(QPainter *painter, const QRect &rect, const QModel
   if(m_fillBranchRect)
     fillBranchesRect(painter, rect, index);
 
+  QStack<QModelIndex> parents;
+
+  if(m_ColoredBranches)
+  {
+    QModelIndex parent = index.parent();
+
+    while(parent.isValid())
+    {
+      parents.push(parent);
+      parent = parent.parent();
+    }
+
+    // fill in the background behind the lines for the whole row, since by default it doesn't show
+    // up behind the tree lines.
+    QVariant back = index.data(Qt::BackgroundRole);
+
+    if(back.isValid() && !selectionModel()->isSelected(index))
+    {
+      QRect allLinesRect(rect.left(), rect.top(), (parents.count() + 1) * indentation(),
+                         rect.height());
+      painter->fillRect(allLinesRect, back.value<QBrush>());
+    }
+  }
+
   if(m_VisibleBranches)
   {
     QTreeView::drawBranches(painter, rect, index);
@@ -336,25 +361,52 @@ void RDTreeView::drawBranches(QPainter *painter, const QRect &rect, const QModel
     // draw only the expand item, not the branches
     QRect primitive(0, rect.top(), qMin(rect.width(), indentation()), rect.height());
 
-    // if root isn't decorated, skip
-    if(!rootIsDecorated() && !index.parent().isValid())
-      return;
+    // skip if root isn't decorated, or if there are no children as there's nothing to render. We
+    // don't return early since there may still be coloured branches to draw.
+    if((rootIsDecorated() || index.parent().isValid()) && model()->rowCount(index) > 0)
+    {
+      QStyleOptionViewItem opt = viewOptions();
 
-    // if no children, nothing to render
-    if(model()->rowCount(index) == 0)
-      return;
+      opt.rect = primitive;
 
-    QStyleOptionViewItem opt = viewOptions();
+      // unfortunately QStyle::State_Children doesn't render ONLY the
+      // open-toggle-button, but the vertical line upwards to a previous sibling.
+      // For consistency, draw one downwards too.
+      opt.state = QStyle::State_Children | QStyle::State_Sibling;
+      if(isExpanded(index))
+        opt.state |= QStyle::State_Open;
 
-    opt.rect = primitive;
+      style()->drawPrimitive(QStyle::PE_IndicatorBranch, &opt, painter, this);
+    }
+  }
+
+  if(parents.isEmpty())
+    return;
+
+  // iterate from the top-most parent down, moving in from the left. This is drawn after the
+  // built-in branches so that we paint on top of them
+  QRect branchRect(rect.left(), rect.top(), indentation(), rect.height());
+
+  QPen oldPen = painter->pen();
+  while(!parents.isEmpty())
+  {
+    QVariant pen = parents.pop().data(TreeLinePenRole);
 
-    // unfortunately QStyle::State_Children doesn't render ONLY the
-    // open-toggle-button, but the vertical line upwards to a previous sibling.
-    // For consistency, draw one downwards too.
-    opt.state = QStyle::State_Children | QStyle::State_Sibling;
-    if(isExpanded(index))
-      opt.state |= QStyle::State_Open;
+    if(pen.isValid())
+    {
+      // draw a centred pen vertically down the middle of branchRect
+      painter->setPen(pen.value<QPen>());
+
+      QPoint topCentre = QRect(branchRect).center();
+      QPoint bottomCentre = topCentre;
+
+      topCentre.setY(branchRect.top());
+      bottomCentre.setY(branchRect.bottom());
+
+      painter->drawLine(topCentre, bottomCentre);
+    }
 
-    style()->drawPrimitive(QStyle::PE_IndicatorBranch, &opt, painter, this);
+    branchRect.moveLeft(branchRect.left() + indentation());
   }
+  painter->setPen(oldPen);
 }
@@ -80,6 +80,10 @@ public:
   explicit RDTreeView(QWidget *parent = 0);
   virtual ~RDTreeView();
 
+  // with coloured branches enabled, a model can return a QPen for this role on a parent to draw a
+  // vertical line down the branches of all its children.
+  static const int TreeLinePenRole = Qt::UserRole + 0x1000;
+
   void showBranches() { m_VisibleBranches = true; }
   void hideBranches() { m_VisibleBranches = false; }
   void showGridLines() { m_VisibleGridLines = true; }
@@ -91,6 +95,8 @@ public:
   int verticalItemMargin() { return m_VertMargin; }
   void setIgnoreIconSize(bool ignore) { m_IgnoreIconSize = ignore; }
   bool ignoreIconSize() { return m_IgnoreIconSize; }
+  void setColoredBranches(bool colored) { m_ColoredBranches = colored; }
+  bool coloredBranches() { return m_ColoredBranches; }
   void setItemDelegate(QAbstractItemDelegate *delegate);
   QAbstractItemDelegate *itemDelegate() const;
 
@@ -126,6 +132,7 @@ private:
 
   int m_VertMargin = 6;
   bool m_IgnoreIconSize = false;
+  bool m_ColoredBranches = false;
 
   bool m_fillBranchRect = true;
 };
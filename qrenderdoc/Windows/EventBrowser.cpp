@@ -24,12 +24,15 @@
 
 #include "EventBrowser.h"
 #include <QAbstractSpinBox>
+#include <QBitArray>
 #include <QComboBox>
 #include <QDialogButtonBox>
 #include <QKeyEvent>
 #include <QLineEdit>
 #include <QMenu>
+#include <QPainter>
 #include <QShortcut>
+#include <QStyledItemDelegate>
 #include <QTextEdit>
 #include <QTimer>
 #include "3rdparty/flowlayout/FlowLayout.h"
@@ -38,23 +41,9 @@
 #include "Code/Resources.h"
 #include "Widgets/Extended/RDHeaderView.h"
 #include "Widgets/Extended/RDListWidget.h"
+#include "Widgets/Extended/RDTreeView.h"
 #include "ui_EventBrowser.h"
 
-struct EventItemTag
-{
-  EventItemTag() = default;
-  EventItemTag(uint32_t eventId) : EID(eventId), lastEID(eventId) {}
-  EventItemTag(uint32_t eventId, uint32_t lastEventID) : EID(eventId), lastEID(lastEventID) {}
-  uint32_t EID = 0;
-  uint32_t lastEID = 0;
-  double duration = -1.0;
-  bool current = false;
-  bool find = false;
-  bool bookmark = false;
-};
-
-Q_DECLARE_METATYPE(EventItemTag);
-
 enum
 {
   COL_NAME,
@@ -64,6 +53,625 @@ enum
   COL_COUNT,
 };
 
+// the event tree is indexed as a flat array of nodes that point into the drawcall tree, with each
+// node's children allocated contiguously. This lets the model create and navigate indices for
+// rows without having any per-row objects, and everything displayed is read from the drawcall on
+// demand.
+struct EventNode
+{
+  // NULL for the frame root and the 'Frame Start' node
+  const DrawcallDescription *draw;
+  int parent;
+  int row;
+  int firstChild;
+  int childCount;
+};
+
+class EventItemModel : public QAbstractItemModel
+{
+public:
+  EventItemModel(RDTreeView *view, ICaptureContext &ctx) : QAbstractItemModel(view), m_Ctx(ctx)
+  {
+    m_View = view;
+
+    // the header can be queried before the browser first applies the time unit
+    m_TimeUnit = m_Ctx.Config().EventBrowser_TimeUnit;
+  }
+
+  void Populate()
+  {
+    emit beginResetModel();
+
+    ClearData();
+
+    const rdcarray<DrawcallDescription> &draws = m_Ctx.CurDrawcalls();
+
+    // the frame root, whose children are the 'Frame Start' node and then the top-level draws
+    m_Nodes.push_back({NULL, -1, 0, 1, draws.count() + 1});
+    m_Nodes.push_back({NULL, 0, 0, 0, 0});
+
+    AddDrawcalls(0, 1, draws);
+
+    emit endResetModel();
+  }
+
+  void Clear()
+  {
+    emit beginResetModel();
+
+    ClearData();
+
+    emit endResetModel();
+  }
+
+  QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override
+  {
+    if(row < 0 || row >= rowCount(parent) || column < 0 || column >= columnCount())
+      return QModelIndex();
+
+    if(!parent.isValid())
+      return createIndex(row, column, quintptr(0));
+
+    return createIndex(row, column, quintptr(m_Nodes[node(parent)].firstChild + row));
+  }
+
+  QModelIndex parent(const QModelIndex &index) const override
+  {
+    if(!index.isValid())
+      return QModelIndex();
+
+    int parent = m_Nodes[node(index)].parent;
+
+    if(parent < 0)
+      return QModelIndex();
+
+    return createIndex(m_Nodes[parent].row, 0, quintptr(parent));
+  }
+
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override
+  {
+    if(!parent.isValid())
+      return m_Nodes.isEmpty() ? 0 : 1;
+
+    if(parent.column() != 0)
+      return 0;
+
+    return m_Nodes[node(parent)].childCount;
+  }
+
+  int columnCount(const QModelIndex &parent = QModelIndex()) const override { return COL_COUNT; }
+  QVariant headerData(int section, Qt::Orientation orientation,
+                      int role = Qt::DisplayRole) const override
+  {
+    if(orientation == Qt::Horizontal && role == Qt::DisplayRole)
+    {
+      switch(section)
+      {
+        case COL_NAME: return EventBrowser::tr("Name");
+        case COL_EID: return lit("EID");
+        case COL_DRAW: return lit("Draw #");
+        case COL_DURATION: return EventBrowser::tr("Duration (%1)").arg(UnitSuffix(m_TimeUnit));
+        default: break;
+      }
+    }
+
+    return QVariant();
+  }
+
+  QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override
+  {
+    if(!index.isValid())
+      return QVariant();
+
+    int n = node(index);
+    const DrawcallDescription *draw = m_Nodes[n].draw;
+    int col = index.column();
+
+    if(role == Qt::DisplayRole)
+    {
+      if(col == COL_NAME)
+      {
+        if(n == 0)
+          return QFormatStr("Frame #%1").arg(m_Ctx.FrameInfo().frameNumber);
+        else if(draw == NULL)
+          return EventBrowser::tr("Frame Start");
+
+        // initialising rich resource text is expensive, so only do it the first time a row is
+        // displayed.
+        auto it = m_Names.find(n);
+        if(it == m_Names.end())
+        {
+          QVariant name = QString(draw->name);
+          RichResourceTextInitialise(name);
+          it = m_Names.insert(n, name);
+        }
+
+        return it.value();
+      }
+      else if(col == COL_EID || col == COL_DRAW)
+      {
+        if(n == 0)
+          return QString();
+        else if(draw == NULL)
+          return lit("0");
+
+        uint32_t first = col == COL_EID ? draw->eventId : draw->drawcallId;
+        uint32_t last = col == COL_EID ? GetLastEID(n) : GetLastDraw(n);
+
+        // only parents display a range, set markers still list their own event
+        if(m_Nodes[n].childCount > 0 && GetLastEID(n) > draw->eventId)
+          return QFormatStr("%1-%2").arg(first).arg(last);
+
+        return QString::number(first);
+      }
+      else if(col == COL_DURATION)
+      {
+        if(m_Durations.isEmpty())
+          return draw ? lit("---") : QString();
+
+        double secs = m_Durations[n];
+
+        if(secs < 0.0)
+          return QString();
+
+        if(m_TimeUnit == TimeUnit::Milliseconds)
+          secs *= 1000.0;
+        else if(m_TimeUnit == TimeUnit::Microseconds)
+          secs *= 1000000.0;
+        else if(m_TimeUnit == TimeUnit::Nanoseconds)
+          secs *= 1000000000.0;
+
+        return Formatter::Format(secs);
+      }
+    }
+    else if(role == Qt::DecorationRole && col == COL_NAME)
+    {
+      if(n == m_Current)
+        return Icons::flag_green();
+      else if(m_Bookmarks.contains(n))
+        return Icons::asterisk_orange();
+      else if(!m_FindResults.isEmpty() && m_FindResults.testBit(n))
+        return Icons::find();
+    }
+    else if(role == Qt::TextAlignmentRole && col == COL_DURATION)
+    {
+      return QVariant(Qt::AlignRight | Qt::AlignCenter);
+    }
+    else if(role == RDTreeView::TreeLinePenRole)
+    {
+      QColor col = GetMarkerColor(n);
+
+      if(col.isValid())
+        return QPen(QBrush(col), 3.0f);
+    }
+    else if((role == Qt::BackgroundRole || role == Qt::ForegroundRole) &&
+            m_Ctx.Config().EventBrowser_ColorEventRow)
+    {
+      QColor col = GetMarkerColor(n);
+
+      if(col.isValid())
+      {
+        if(role == Qt::BackgroundRole)
+          return QBrush(col);
+
+        return QBrush(contrastingColor(col, m_View->palette().color(QPalette::Text)));
+      }
+    }
+
+    return QVariant();
+  }
+
+  uint32_t GetEID(const QModelIndex &idx) const
+  {
+    if(!idx.isValid())
+      return 0;
+
+    const DrawcallDescription *draw = m_Nodes[node(idx)].draw;
+    return draw ? draw->eventId : 0;
+  }
+
+  uint32_t GetLastEID(const QModelIndex &idx) const
+  {
+    if(!idx.isValid())
+      return 0;
+
+    return GetLastEID(node(idx));
+  }
+
+  // find the row for an event. This is the deepest row whose range ends at or after the event,
+  // preferring an exact match on a leaf so that set markers that inherit the event of the next real
+  // draw don't take over that draw.
+  QModelIndex Find(uint32_t eventId) const
+  {
+    if(m_Nodes.isEmpty())
+      return QModelIndex();
+
+    int n = 0;
+
+    while(m_Nodes[n].childCount > 0)
+    {
+      const EventNode &parent = m_Nodes[n];
+      int end = parent.firstChild + parent.childCount;
+
+      // siblings are in event order, so binary search for the first child whose range reaches the
+      // event.
+      int first = parent.firstChild, count = parent.childCount;
+      while(count > 0)
+      {
+        int step = count / 2;
+        if(GetLastEID(first + step) < eventId)
+        {
+          first += step + 1;
+          count -= step + 1;
+        }
+        else
+        {
+          count = step;
+        }
+      }
+
+      if(first == end)
+        break;
+
+      if(GetLastEID(first) == eventId)
+      {
+        while(first + 1 < end && GetLastEID(first + 1) == eventId)
+          first++;
+      }
+
+      n = first;
+    }
+
+    if(n == 0)
+      return QModelIndex();
+
+    return createIndex(m_Nodes[n].row, 0, quintptr(n));
+  }
+
+  // mark the rows for the events returned by a search. The replay side only indexes events it
+  // knows about, so markers and other rows that exist only in the UI are matched on their name
+  // here instead.
+  int SetFindResults(const QString &filter, const rdcarray<uint32_t> &eventIds)
+  {
+    ClearFind();
+
+    if(filter.isEmpty() || m_Nodes.isEmpty())
+      return 0;
+
+    m_FindResults.resize(m_Nodes.count());
+
+    // a result can be any API call, not only a draw, so mark the row that contains it. A marker's
+    // own event is the same as its first child's, which Find() resolves to the child, so markers
+    // are only matched on their name below.
+    for(uint32_t eid : eventIds)
+    {
+      QModelIndex idx = Find(eid);
+
+      if(idx.isValid() && node(idx) > 0)
+        m_FindResults.setBit(node(idx));
+    }
+
+    // the frame root isn't searched
+    for(int n = 1; n < m_Nodes.count(); n++)
+    {
+      if((m_Nodes[n].childCount > 0 || !m_Nodes[n].draw) &&
+         GetName(n).contains(filter, Qt::CaseInsensitive))
+        m_FindResults.setBit(n);
+    }
+
+    m_FindEIDs.clear();
+
+    for(int n = 1; n < m_Nodes.count(); n++)
+    {
+      if(m_FindResults.testBit(n))
+        m_FindEIDs.push_back(GetLastEID(n));
+    }
+
+    std::sort(m_FindEIDs.begin(), m_FindEIDs.end());
+    m_FindEIDs.erase(std::unique(m_FindEIDs.begin(), m_FindEIDs.end()), m_FindEIDs.end());
+
+    if(!m_FindEIDs.isEmpty())
+      RefreshAll();
+
+    return m_FindEIDs.count();
+  }
+
+  // return the event of the next or previous search result after the given event, wrapping around
+  // at either end.
+  int NextFindResult(uint32_t after, bool forward) const
+  {
+    if(m_FindEIDs.isEmpty())
+      return -1;
+
+    if(forward)
+    {
+      auto it = std::upper_bound(m_FindEIDs.begin(), m_FindEIDs.end(), after);
+      return int(it == m_FindEIDs.end() ? m_FindEIDs.front() : *it);
+    }
+
+    auto it = std::lower_bound(m_FindEIDs.begin(), m_FindEIDs.end(), after);
+    return int(it == m_FindEIDs.begin() ? m_FindEIDs.back() : *(it - 1));
+  }
+
+  void ClearFind()
+  {
+    m_FindEIDs.clear();
+
+    if(m_FindResults.isEmpty())
+      return;
+
+    m_FindResults.clear();
+    RefreshAll();
+  }
+
+  void SetCurrent(const QModelIndex &idx)
+  {
+    int prev = m_Current;
+
+    m_Current = idx.isValid() ? node(idx) : -1;
+
+    RefreshIcon(prev);
+    RefreshIcon(m_Current);
+  }
+
+  void SetBookmark(uint32_t eventId, bool bookmark)
+  {
+    QModelIndex idx = Find(eventId);
+
+    if(!idx.isValid())
+      return;
+
+    if(bookmark)
+      m_Bookmarks.insert(node(idx));
+    else
+      m_Bookmarks.remove(node(idx));
+
+    RefreshIcon(node(idx));
+  }
+
+  void SetTimes(const rdcarray<CounterResult> &results)
+  {
+    QHash<uint32_t, double> times;
+    times.reserve(results.count());
+    for(const CounterResult &r : results)
+      times[r.eventId] = r.value.d;
+
+    m_Durations.resize(m_Nodes.count());
+
+    // children are always allocated after their parent, so walking backwards means every parent's
+    // children are done before it is.
+    for(int n = m_Nodes.count() - 1; n >= 0; n--)
+    {
+      const EventNode &node = m_Nodes[n];
+
+      // look up leaf nodes in the results
+      if(node.childCount == 0)
+      {
+        m_Durations[n] = times.value(node.draw ? node.draw->eventId : 0, -1.0);
+        continue;
+      }
+
+      // parent nodes take the value of the sum of their children
+      double duration = 0.0;
+
+      for(int c = node.firstChild; c < node.firstChild + node.childCount; c++)
+      {
+        if(m_Durations[c] > 0.0)
+          duration += m_Durations[c];
+      }
+
+      m_Durations[n] = duration;
+    }
+
+    RefreshAll();
+  }
+
+  void SetTimeUnit(TimeUnit unit)
+  {
+    m_TimeUnit = unit;
+
+    emit headerDataChanged(Qt::Horizontal, COL_DURATION, COL_DURATION);
+
+    if(!m_Durations.isEmpty())
+      RefreshAll();
+  }
+
+private:
+  ICaptureContext &m_Ctx;
+  RDTreeView *m_View;
+
+  QVector<EventNode> m_Nodes;
+
+  // per-node state is kept in side arrays, so most nodes cost nothing beyond their entry above.
+  mutable QHash<int, QVariant> m_Names;
+  QVector<double> m_Durations;
+  QBitArray m_FindResults;
+  QVector<uint32_t> m_FindEIDs;
+  QSet<int> m_Bookmarks;
+  int m_Current = -1;
+
+  TimeUnit m_TimeUnit = TimeUnit::Count;
+
+  static int node(const QModelIndex &idx) { return (int)idx.internalId(); }
+  void ClearData()
+  {
+    m_Nodes.clear();
+    m_Names.clear();
+    m_Durations.clear();
+    m_FindResults.clear();
+    m_FindEIDs.clear();
+    m_Bookmarks.clear();
+    m_Current = -1;
+  }
+
+  void AddDrawcalls(int parent, int firstRow, const rdcarray<DrawcallDescription> &draws)
+  {
+    // allocate all the children together first so they're contiguous, then recurse.
+    int first = m_Nodes.count();
+
+    for(int32_t i = 0; i < draws.count(); i++)
+      m_Nodes.push_back({&draws[i], parent, firstRow + i, 0, 0});
+
+    for(int32_t i = 0; i < draws.count(); i++)
+    {
+      if(draws[i].children.empty())
+        continue;
+
+      m_Nodes[first + i].firstChild = m_Nodes.count();
+      m_Nodes[first + i].childCount = draws[i].children.count();
+
+      AddDrawcalls(first + i, 0, draws[i].children);
+    }
+  }
+
+  uint32_t GetLastEID(int n) const
+  {
+    // set markers take the event of the next real draw
+    const EventNode &leaf = m_Nodes[n];
+    if(leaf.childCount == 0 && leaf.draw && (leaf.draw->flags & DrawFlags::SetMarker))
+    {
+      const EventNode &parent = m_Nodes[leaf.parent];
+      if(leaf.row + 1 < parent.childCount)
+        return m_Nodes[parent.firstChild + leaf.row + 1].draw->eventId;
+    }
+
+    // parents cover up to the last event of their last child
+    while(m_Nodes[n].childCount > 0)
+      n = m_Nodes[n].firstChild + m_Nodes[n].childCount - 1;
+
+    return m_Nodes[n].draw ? m_Nodes[n].draw->eventId : 0;
+  }
+
+  uint32_t GetLastDraw(int n) const
+  {
+    while(m_Nodes[n].childCount > 0)
+      n = m_Nodes[n].firstChild + m_Nodes[n].childCount - 1;
+
+    return m_Nodes[n].draw ? m_Nodes[n].draw->drawcallId : 0;
+  }
+
+  QString GetName(int n) const
+  {
+    if(m_Nodes[n].draw)
+      return QString(m_Nodes[n].draw->name);
+
+    return data(createIndex(m_Nodes[n].row, COL_NAME, quintptr(n))).toString();
+  }
+
+  QColor GetMarkerColor(int n) const
+  {
+    const DrawcallDescription *draw = m_Nodes[n].draw;
+
+    // if alpha isn't 0, assume the colour is valid
+    if(draw && m_Ctx.Config().EventBrowser_ApplyColors &&
+       (draw->flags & (DrawFlags::PushMarker | DrawFlags::SetMarker)) &&
+       draw->markerColor[3] > 0.0f)
+    {
+      return QColor::fromRgb(qRgb(draw->markerColor[0] * 255.0f, draw->markerColor[1] * 255.0f,
+                                  draw->markerColor[2] * 255.0f));
+    }
+
+    return QColor();
+  }
+
+  void RefreshIcon(int n)
+  {
+    if(n < 0 || n >= m_Nodes.count())
+      return;
+
+    QModelIndex idx = createIndex(m_Nodes[n].row, COL_NAME, quintptr(n));
+    emit dataChanged(idx, idx, {Qt::DecorationRole});
+  }
+
+  void RefreshAll()
+  {
+    // nothing is cached per-row, so when many rows could change at once we just repaint. The view
+    // only fetches the rows it displays.
+    m_View->viewport()->update();
+  }
+};
+
+// paints rich resource text in the name column, the same as RDTreeWidget does for its items.
+class EventItemDelegate : public QStyledItemDelegate
+{
+public:
+  EventItemDelegate(RDTreeView *view) : QStyledItemDelegate(view), m_View(view) {}
+  void paint(QPainter *painter, const QStyleOptionViewItem &option,
+             const QModelIndex &index) const override
+  {
+    QVariant v = index.data(Qt::DisplayRole);
+
+    if(!RichResourceTextCheck(v))
+      return QStyledItemDelegate::paint(painter, option, index);
+
+    // draw the item without text, so we get the proper background/selection/etc.
+    QStyleOptionViewItem opt = option;
+    initStyleOption(&opt, index);
+    opt.text.clear();
+    m_View->style()->drawControl(QStyle::CE_ItemViewItem, &opt, painter, m_View);
+
+    painter->save();
+
+    RichResourceTextPaint(m_View, painter, textRect(opt), option.font, option.palette,
+                          option.state & QStyle::State_MouseOver,
+                          m_View->viewport()->mapFromGlobal(QCursor::pos()), v);
+
+    painter->restore();
+  }
+
+  QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override
+  {
+    QVariant v = index.data(Qt::DisplayRole);
+
+    if(RichResourceTextCheck(v))
+      return QSize(RichResourceTextWidthHint(m_View, v), option.fontMetrics.height());
+
+    return QStyledItemDelegate::sizeHint(option, index);
+  }
+
+  bool editorEvent(QEvent *event, QAbstractItemModel *model, const QStyleOptionViewItem &option,
+                   const QModelIndex &index) override
+  {
+    if(event->type() == QEvent::MouseButtonRelease && index.isValid())
+    {
+      QVariant v = index.data(Qt::DisplayRole);
+
+      if(RichResourceTextCheck(v))
+      {
+        QStyleOptionViewItem opt = option;
+        initStyleOption(&opt, index);
+
+        // ignore the return value, we always consume clicks on this cell
+        RichResourceTextMouseEvent(m_View, v, textRect(opt), (QMouseEvent *)event);
+        return true;
+      }
+    }
+
+    return QStyledItemDelegate::editorEvent(event, model, option, index);
+  }
+
+private:
+  RDTreeView *m_View;
+
+  QRect textRect(const QStyleOptionViewItem &opt) const
+  {
+    QRect rect = opt.rect;
+    if(!opt.icon.isNull())
+    {
+      QIcon::Mode mode;
+      if((opt.state & QStyle::State_Enabled) == 0)
+        mode = QIcon::Disabled;
+      else if(opt.state & QStyle::State_Selected)
+        mode = QIcon::Selected;
+      else
+        mode = QIcon::Normal;
+      QIcon::State state = opt.state & QStyle::State_Open ? QIcon::On : QIcon::Off;
+      rect.setX(rect.x() + opt.icon.actualSize(opt.decorationSize, mode, state).width());
+    }
+    return rect;
+  }
+};
+
 static bool textEditControl(QWidget *sender)
 {
   if(qobject_cast<QLineEdit *>(sender) || qobject_cast<QTextEdit *>(sender) ||
@@ -90,8 +698,15 @@ EventBrowser::EventBrowser(ICaptureContext &ctx, QWidget *parent)
   ui->find->setFont(Formatter::PreferredFont());
   ui->events->setFont(Formatter::PreferredFont());
 
-  ui->events->setColumns(
-      {tr("Name"), lit("EID"), lit("Draw #"), lit("Duration - replaced in UpdateDurationColumn")});
+  m_Model = new EventItemModel(ui->events, m_Ctx);
+
+  ui->events->setModel(m_Model);
+  ui->events->setItemDelegate(new EventItemDelegate(ui->events));
+
+  // every row is a single line of text, and this saves the view from measuring every row in the
+  // frame whenever the layout changes.
+  ui->events->setUniformRowHeights(true);
+  ui->events->setColoredBranches(true);
 
   ui->events->setHeader(new RDHeaderView(Qt::Horizontal, this));
   ui->events->header()->setStretchLastSection(true);
@@ -103,8 +718,6 @@ EventBrowser::EventBrowser(ICaptureContext &ctx, QWidget *parent)
   ui->events->header()->setSectionResizeMode(COL_DRAW, QHeaderView::Interactive);
   ui->events->header()->setSectionResizeMode(COL_DURATION, QHeaderView::Interactive);
 
-  ui->events->setColumnAlignment(COL_DURATION, Qt::AlignRight | Qt::AlignCenter);
-
   ui->events->header()->setMinimumSectionSize(40);
 
   ui->events->header()->setSectionsMovable(true);
@@ -134,7 +747,9 @@ EventBrowser::EventBrowser(ICaptureContext &ctx, QWidget *parent)
 
   QObject::connect(ui->closeFind, &QToolButton::clicked, this, &EventBrowser::on_HideFindJump);
   QObject::connect(ui->closeJump, &QToolButton::clicked, this, &EventBrowser::on_HideFindJump);
-  QObject::connect(ui->events, &RDTreeWidget::keyPress, this, &EventBrowser::events_keyPress);
+  QObject::connect(ui->events, &RDTreeView::keyPress, this, &EventBrowser::events_keyPress);
+  QObject::connect(ui->events->selectionModel(), &QItemSelectionModel::currentChanged, this,
+                   &EventBrowser::events_currentChanged);
   ui->jumpStrip->hide();
   ui->findStrip->hide();
   ui->bookmarkStrip->hide();
@@ -182,7 +797,7 @@ EventBrowser::EventBrowser(ICaptureContext &ctx, QWidget *parent)
                                         [this](QWidget *) { on_HideFindJump(); });
 
   ui->events->setContextMenuPolicy(Qt::CustomContextMenu);
-  QObject::connect(ui->events, &RDTreeWidget::customContextMenuRequested, this,
+  QObject::connect(ui->events, &RDTreeView::customContextMenuRequested, this,
                    &EventBrowser::events_contextMenu);
 
   ui->events->header()->setContextMenuPolicy(Qt::CustomContextMenu);
@@ -226,21 +841,11 @@ EventBrowser::~EventBrowser()
 
 void EventBrowser::OnCaptureLoaded()
 {
-  RDTreeWidgetItem *frame = new RDTreeWidgetItem(
-      {QFormatStr("Frame #%1").arg(m_Ctx.FrameInfo().frameNumber), QString(), QString(), QString()});
-
-  RDTreeWidgetItem *framestart =
-      new RDTreeWidgetItem({tr("Frame Start"), lit("0"), lit("0"), QString()});
-  framestart->setTag(QVariant::fromValue(EventItemTag(0, 0)));
-
-  frame->addChild(framestart);
+  m_Model->Populate();
 
-  QPair<uint32_t, uint32_t> lastEIDDraw = AddDrawcalls(frame, m_Ctx.CurDrawcalls());
-  frame->setTag(QVariant::fromValue(EventItemTag(0, lastEIDDraw.first)));
+  QModelIndex frame = m_Model->index(0, 0);
 
-  ui->events->addTopLevelItem(frame);
-
-  ui->events->expandItem(frame);
+  ui->events->expand(frame);
 
   clearBookmarks();
   repopulateBookmarks();
@@ -253,14 +858,17 @@ void EventBrowser::OnCaptureLoaded()
   ui->stepPrev->setEnabled(true);
   ui->stepNext->setEnabled(true);
 
-  m_Ctx.SetEventID({this}, lastEIDDraw.first, lastEIDDraw.first);
+  uint32_t lastEID = m_Model->GetLastEID(frame);
+
+  m_Ctx.SetEventID({this}, lastEID, lastEID);
 }
 
 void EventBrowser::OnCaptureClosed()
 {
   clearBookmarks();
 
-  ui->events->clear();
+  m_SearchText = QString();
+  m_Model->Clear();
 
   ui->find->setEnabled(false);
   ui->gotoEID->setEnabled(false);
@@ -278,132 +886,6 @@ void EventBrowser::OnEventChanged(uint32_t eventId)
   highlightBookmarks();
 }
 
-QPair<uint32_t, uint32_t> EventBrowser::AddDrawcalls(RDTreeWidgetItem *parent,
-                                                     const rdcarray<DrawcallDescription> &draws)
-{
-  uint lastEID = 0, lastDraw = 0;
-
-  for(int32_t i = 0; i < draws.count(); i++)
-  {
-    const DrawcallDescription &d = draws[i];
-
-    QVariant name = QString(d.name);
-
-    RichResourceTextInitialise(name);
-
-    RDTreeWidgetItem *child = new RDTreeWidgetItem(
-        {name, QString::number(d.eventId), QString::number(d.drawcallId), lit("---")});
-
-    QPair<uint32_t, uint32_t> last = AddDrawcalls(child, d.children);
-    lastEID = last.first;
-    lastDraw = last.second;
-
-    if(lastEID > d.eventId)
-    {
-      child->setText(COL_EID, QFormatStr("%1-%2").arg(d.eventId).arg(lastEID));
-      child->setText(COL_DRAW, QFormatStr("%1-%2").arg(d.drawcallId).arg(lastDraw));
-    }
-
-    if(lastEID == 0)
-    {
-      lastEID = d.eventId;
-      lastDraw = d.drawcallId;
-
-      if((draws[i].flags & DrawFlags::SetMarker) && i + 1 < draws.count())
-        lastEID = draws[i + 1].eventId;
-    }
-
-    child->setTag(QVariant::fromValue(EventItemTag(draws[i].eventId, lastEID)));
-
-    if(m_Ctx.Config().EventBrowser_ApplyColors)
-    {
-      // if alpha isn't 0, assume the colour is valid
-      if((d.flags & (DrawFlags::PushMarker | DrawFlags::SetMarker)) && d.markerColor[3] > 0.0f)
-      {
-        QColor col = QColor::fromRgb(
-            qRgb(d.markerColor[0] * 255.0f, d.markerColor[1] * 255.0f, d.markerColor[2] * 255.0f));
-
-        child->setTreeColor(col, 3.0f);
-
-        if(m_Ctx.Config().EventBrowser_ColorEventRow)
-        {
-          QColor textCol = ui->events->palette().color(QPalette::Text);
-
-          child->setBackgroundColor(col);
-          child->setForegroundColor(contrastingColor(col, textCol));
-        }
-      }
-    }
-
-    parent->addChild(child);
-  }
-
-  return qMakePair(lastEID, lastDraw);
-}
-
-void EventBrowser::SetDrawcallTimes(RDTreeWidgetItem *node, const rdcarray<CounterResult> &results)
-{
-  if(node == NULL)
-    return;
-
-  // parent nodes take the value of the sum of their children
-  double duration = 0.0;
-
-  // look up leaf nodes in the dictionary
-  if(node->childCount() == 0)
-  {
-    uint32_t eid = node->tag().value<EventItemTag>().EID;
-
-    duration = -1.0;
-
-    for(const CounterResult &r : results)
-    {
-      if(r.eventId == eid)
-        duration = r.value.d;
-    }
-
-    double secs = duration;
-
-    if(m_TimeUnit == TimeUnit::Milliseconds)
-      secs *= 1000.0;
-    else if(m_TimeUnit == TimeUnit::Microseconds)
-      secs *= 1000000.0;
-    else if(m_TimeUnit == TimeUnit::Nanoseconds)
-      secs *= 1000000000.0;
-
-    node->setText(COL_DURATION, duration < 0.0f ? QString() : Formatter::Format(secs));
-    EventItemTag tag = node->tag().value<EventItemTag>();
-    tag.duration = duration;
-    node->setTag(QVariant::fromValue(tag));
-
-    return;
-  }
-
-  for(int i = 0; i < node->childCount(); i++)
-  {
-    SetDrawcallTimes(node->child(i), results);
-
-    double nd = node->child(i)->tag().value<EventItemTag>().duration;
-
-    if(nd > 0.0)
-      duration += nd;
-  }
-
-  double secs = duration;
-
-  if(m_TimeUnit == TimeUnit::Milliseconds)
-    secs *= 1000.0;
-  else if(m_TimeUnit == TimeUnit::Microseconds)
-    secs *= 1000000.0;
-  else if(m_TimeUnit == TimeUnit::Nanoseconds)
-    secs *= 1000000000.0;
-
-  node->setText(COL_DURATION, duration < 0.0f ? QString() : Formatter::Format(secs));
-  EventItemTag tag = node->tag().value<EventItemTag>();
-  tag.duration = duration;
-  node->setTag(QVariant::fromValue(tag));
-}
-
 void EventBrowser::on_find_clicked()
 {
   ui->jumpStrip->hide();
@@ -420,10 +902,10 @@ void EventBrowser::on_gotoEID_clicked()
 
 void EventBrowser::on_bookmark_clicked()
 {
-  RDTreeWidgetItem *n = ui->events->currentItem();
+  QModelIndex idx = ui->events->currentIndex();
 
-  if(n)
-    toggleBookmark(n->tag().value<EventItemTag>().lastEID);
+  if(idx.isValid())
+    toggleBookmark(m_Model->GetLastEID(idx));
 }
 
 void EventBrowser::on_timeDraws_clicked()
@@ -436,44 +918,33 @@ void EventBrowser::on_timeDraws_clicked()
 
     m_Times = r->FetchCounters({GPUCounter::EventGPUDuration});
 
-    GUIInvoke::call([this]() {
-      SetDrawcallTimes(ui->events->topLevelItem(0), m_Times);
-      ui->events->update();
-    });
+    GUIInvoke::call([this]() { m_Model->SetTimes(m_Times); });
   });
 }
 
-void EventBrowser::on_events_currentItemChanged(RDTreeWidgetItem *current, RDTreeWidgetItem *previous)
+void EventBrowser::events_currentChanged(const QModelIndex &current, const QModelIndex &previous)
 {
-  if(previous)
-  {
-    EventItemTag tag = previous->tag().value<EventItemTag>();
-    tag.current = false;
-    previous->setTag(QVariant::fromValue(tag));
-    RefreshIcon(previous, tag);
-  }
+  m_Model->SetCurrent(current);
 
-  if(!current)
+  if(!current.isValid())
     return;
 
-  EventItemTag tag = current->tag().value<EventItemTag>();
-  tag.current = true;
-  current->setTag(QVariant::fromValue(tag));
-  RefreshIcon(current, tag);
+  uint32_t EID = m_Model->GetEID(current);
+  uint32_t lastEID = m_Model->GetLastEID(current);
 
-  m_Ctx.SetEventID({this}, tag.EID, tag.lastEID);
+  m_Ctx.SetEventID({this}, EID, lastEID);
 
-  const DrawcallDescription *draw = m_Ctx.GetDrawcall(tag.lastEID);
+  const DrawcallDescription *draw = m_Ctx.GetDrawcall(lastEID);
 
   ui->stepPrev->setEnabled(draw && draw->previous);
   ui->stepNext->setEnabled(draw && draw->next);
 
   // special case for the first draw in the frame
-  if(tag.lastEID == 0)
+  if(lastEID == 0)
     ui->stepNext->setEnabled(true);
 
   // special case for the first 'virtual' draw at EID 0
-  if(m_Ctx.GetFirstDrawcall() && tag.lastEID == m_Ctx.GetFirstDrawcall()->eventId)
+  if(m_Ctx.GetFirstDrawcall() && lastEID == m_Ctx.GetFirstDrawcall()->eventId)
     ui->stepPrev->setEnabled(true);
 
   highlightBookmarks();
@@ -502,14 +973,7 @@ void EventBrowser::on_jumpToEID_returnPressed()
 
 void EventBrowser::findHighlight_timeout()
 {
-  ClearFindIcons();
-
-  int results = SetFindIcons(ui->findEvent->text());
-
-  if(results > 0)
-    ui->findEvent->setPalette(palette());
-  else
-    ui->findEvent->setPalette(m_redPalette);
+  Search(ui->findEvent->text(), 0);
 }
 
 void EventBrowser::on_findEvent_textEdited(const QString &arg1)
@@ -533,10 +997,7 @@ void EventBrowser::on_findEvent_returnPressed()
   if(m_FindHighlight->isActive())
     m_FindHighlight->stop();
 
-  if(!ui->findEvent->text().isEmpty())
-    Find(true);
-
-  findHighlight_timeout();
+  Find(true);
 }
 
 void EventBrowser::on_findEvent_keyPress(QKeyEvent *event)
@@ -547,10 +1008,7 @@ void EventBrowser::on_findEvent_keyPress(QKeyEvent *event)
     if(m_FindHighlight->isActive())
       m_FindHighlight->stop();
 
-    if(!ui->findEvent->text().isEmpty())
-      Find(event->modifiers() & Qt::ShiftModifier ? false : true);
-
-    findHighlight_timeout();
+    Find(event->modifiers() & Qt::ShiftModifier ? false : true);
 
     event->accept();
   }
@@ -626,7 +1084,8 @@ void EventBrowser::on_exportDraws_clicked()
 
         if(!m_Times.empty())
         {
-          line += QFormatStr(" | %1").arg(ui->events->headerText(COL_DURATION));
+          line += QFormatStr(" | %1")
+                      .arg(m_Model->headerData(COL_DURATION, Qt::Horizontal).toString());
         }
 
         stream << line << "\n";
@@ -678,7 +1137,8 @@ void EventBrowser::on_colSelect_clicked()
   {
     int logIdx = ui->events->header()->logicalIndex(visIdx);
 
-    QListWidgetItem *item = new QListWidgetItem(ui->events->headerText(logIdx), &list);
+    QListWidgetItem *item =
+        new QListWidgetItem(m_Model->headerData(logIdx, Qt::Horizontal).toString(), &list);
 
     item->setData(Qt::UserRole, logIdx);
 
@@ -843,7 +1303,7 @@ QVariant EventBrowser::persistData()
       ui->events->header()->hideSection(i);
 
     // name is just informative
-    col[lit("name")] = ui->events->headerText(i);
+    col[lit("name")] = m_Model->headerData(i, Qt::Horizontal).toString();
     col[lit("index")] = ui->events->header()->visualIndex(i);
     col[lit("hidden")] = hidden;
     col[lit("size")] = size;
@@ -920,7 +1380,10 @@ void EventBrowser::events_keyPress(QKeyEvent *event)
 
 void EventBrowser::events_contextMenu(const QPoint &pos)
 {
-  RDTreeWidgetItem *item = ui->events->itemAt(pos);
+  QModelIndex item = ui->events->indexAt(pos);
+
+  if(item.isValid())
+    item = item.sibling(item.row(), COL_NAME);
 
   QMenu contextMenu(this);
 
@@ -936,14 +1399,12 @@ void EventBrowser::events_contextMenu(const QPoint &pos)
   collapseAll.setIcon(Icons::arrow_in());
   selectCols.setIcon(Icons::timeline_marker());
 
-  expandAll.setEnabled(item && item->childCount() > 0);
-  collapseAll.setEnabled(item && item->childCount() > 0);
+  expandAll.setEnabled(item.isValid() && m_Model->rowCount(item) > 0);
+  collapseAll.setEnabled(item.isValid() && m_Model->rowCount(item) > 0);
 
-  QObject::connect(&expandAll, &QAction::triggered,
-                   [this, item]() { ui->events->expandAllItems(item); });
+  QObject::connect(&expandAll, &QAction::triggered, [this, item]() { ExpandAll(item, true); });
 
-  QObject::connect(&collapseAll, &QAction::triggered,
-                   [this, item]() { ui->events->collapseAllItems(item); });
+  QObject::connect(&collapseAll, &QAction::triggered, [this, item]() { ExpandAll(item, false); });
 
   QObject::connect(&selectCols, &QAction::triggered, this, &EventBrowser::on_colSelect_clicked);
 
@@ -987,16 +1448,7 @@ void EventBrowser::repopulateBookmarks()
 
       highlightBookmarks();
 
-      RDTreeWidgetItem *found = NULL;
-      FindEventNode(found, ui->events->topLevelItem(0), EID);
-
-      if(found)
-      {
-        EventItemTag tag = found->tag().value<EventItemTag>();
-        tag.bookmark = true;
-        found->setTag(QVariant::fromValue(tag));
-        RefreshIcon(found, tag);
-      }
+      m_Model->SetBookmark(EID, true);
 
       m_BookmarkStripLayout->removeItem(m_BookmarkSpacer);
       m_BookmarkStripLayout->addWidget(but);
@@ -1012,16 +1464,7 @@ void EventBrowser::repopulateBookmarks()
       delete m_BookmarkButtons[EID];
       m_BookmarkButtons.remove(EID);
 
-      RDTreeWidgetItem *found = NULL;
-      FindEventNode(found, ui->events->topLevelItem(0), EID);
-
-      if(found)
-      {
-        EventItemTag tag = found->tag().value<EventItemTag>();
-        tag.bookmark = false;
-        found->setTag(QVariant::fromValue(tag));
-        RefreshIcon(found, tag);
-      }
+      m_Model->SetBookmark(EID, false);
     }
   }
 
@@ -1059,70 +1502,38 @@ void EventBrowser::highlightBookmarks()
   }
 }
 
-bool EventBrowser::hasBookmark(RDTreeWidgetItem *node)
-{
-  if(node)
-    return hasBookmark(node->tag().value<EventItemTag>().EID);
-
-  return false;
-}
-
 bool EventBrowser::hasBookmark(uint32_t EID)
 {
   return m_Ctx.GetBookmarks().contains(EventBookmark(EID));
 }
 
-void EventBrowser::RefreshIcon(RDTreeWidgetItem *item, EventItemTag tag)
+void EventBrowser::ExpandNode(const QModelIndex &idx)
 {
-  if(tag.current)
-    item->setIcon(COL_NAME, Icons::flag_green());
-  else if(tag.bookmark)
-    item->setIcon(COL_NAME, Icons::asterisk_orange());
-  else if(tag.find)
-    item->setIcon(COL_NAME, Icons::find());
-  else
-    item->setIcon(COL_NAME, QIcon());
-}
-
-bool EventBrowser::FindEventNode(RDTreeWidgetItem *&found, RDTreeWidgetItem *parent, uint32_t eventId)
-{
-  // do a reverse search to find the last match (in case of 'set' markers that
-  // inherit the event of the next real draw).
-  for(int i = parent->childCount() - 1; i >= 0; i--)
+  QModelIndex parent = idx;
+  while(parent.isValid())
   {
-    RDTreeWidgetItem *n = parent->child(i);
-
-    uint nEID = n->tag().value<EventItemTag>().lastEID;
-    uint fEID = found ? found->tag().value<EventItemTag>().lastEID : 0;
-
-    if(nEID >= eventId && (found == NULL || nEID <= fEID))
-      found = n;
-
-    if(nEID == eventId && n->childCount() == 0)
-      return true;
-
-    if(n->childCount() > 0)
-    {
-      bool exact = FindEventNode(found, n, eventId);
-      if(exact)
-        return true;
-    }
+    ui->events->expand(parent);
+    parent = parent.parent();
   }
 
-  return false;
+  if(idx.isValid())
+    ui->events->scrollTo(idx);
 }
 
-void EventBrowser::ExpandNode(RDTreeWidgetItem *node)
+void EventBrowser::ExpandAll(const QModelIndex &idx, bool expand)
 {
-  RDTreeWidgetItem *n = node;
-  while(node != NULL)
-  {
-    ui->events->expandItem(node);
-    node = node->parent();
-  }
+  int count = m_Model->rowCount(idx);
 
-  if(n)
-    ui->events->scrollToItem(n);
+  if(count == 0)
+    return;
+
+  for(int i = 0; i < count; i++)
+    ExpandAll(m_Model->index(i, 0, idx), expand);
+
+  if(expand)
+    ui->events->expand(idx);
+  else
+    ui->events->collapse(idx);
 }
 
 bool EventBrowser::SelectEvent(uint32_t eventId)
@@ -1130,12 +1541,10 @@ bool EventBrowser::SelectEvent(uint32_t eventId)
   if(!m_Ctx.IsCaptureLoaded())
     return false;
 
-  RDTreeWidgetItem *found = NULL;
-  FindEventNode(found, ui->events->topLevelItem(0), eventId);
-  if(found != NULL)
+  QModelIndex found = m_Model->Find(eventId);
+  if(found.isValid())
   {
-    ui->events->setCurrentItem(found);
-    ui->events->setSelectedItem(found);
+    ui->events->setCurrentIndex(found);
 
     ExpandNode(found);
     return true;
@@ -1144,156 +1553,68 @@ bool EventBrowser::SelectEvent(uint32_t eventId)
   return false;
 }
 
-void EventBrowser::ClearFindIcons(RDTreeWidgetItem *parent)
-{
-  for(int i = 0; i < parent->childCount(); i++)
-  {
-    RDTreeWidgetItem *n = parent->child(i);
-
-    EventItemTag tag = n->tag().value<EventItemTag>();
-    tag.find = false;
-    n->setTag(QVariant::fromValue(tag));
-    RefreshIcon(n, tag);
-
-    if(n->childCount() > 0)
-      ClearFindIcons(n);
-  }
-}
-
 void EventBrowser::ClearFindIcons()
 {
-  if(m_Ctx.IsCaptureLoaded())
-    ClearFindIcons(ui->events->topLevelItem(0));
+  m_SearchText = QString();
+  m_Model->ClearFind();
 }
 
-int EventBrowser::SetFindIcons(RDTreeWidgetItem *parent, QString filter)
+void EventBrowser::Search(const QString &text, int jump)
 {
-  int results = 0;
-
-  for(int i = 0; i < parent->childCount(); i++)
-  {
-    RDTreeWidgetItem *n = parent->child(i);
-
-    if(n->text(COL_NAME).contains(filter, Qt::CaseInsensitive))
-    {
-      EventItemTag tag = n->tag().value<EventItemTag>();
-      tag.find = true;
-      n->setTag(QVariant::fromValue(tag));
-      RefreshIcon(n, tag);
-      results++;
-    }
-
-    if(n->childCount() > 0)
-    {
-      results += SetFindIcons(n, filter);
-    }
-  }
-
-  return results;
-}
-
-int EventBrowser::SetFindIcons(QString filter)
-{
-  if(filter.isEmpty())
-    return 0;
-
-  return SetFindIcons(ui->events->topLevelItem(0), filter);
-}
+  if(text.isEmpty() || !m_Ctx.IsCaptureLoaded())
+    return;
 
-RDTreeWidgetItem *EventBrowser::FindNode(RDTreeWidgetItem *parent, QString filter, uint32_t after)
-{
-  for(int i = 0; i < parent->childCount(); i++)
-  {
-    RDTreeWidgetItem *n = parent->child(i);
+  // the search runs on the query thread, so that neither the UI nor a long replay holds it up.
+  // Searches are coalesced so only the latest text is run if several are queued while typing.
+  m_Ctx.Replay().QueryInvoke(lit("EventSearch"), [this, text, jump](IReplayController *r) {
+    rdcarray<uint32_t> results = r->SearchEvents(text.toUtf8().data());
 
-    uint eid = n->tag().value<EventItemTag>().lastEID;
+    GUIInvoke::call([this, text, jump, results]() {
+      // ignore results for text that has since been edited away
+      if(!m_Ctx.IsCaptureLoaded() || text != ui->findEvent->text())
+        return;
 
-    if(eid > after && n->text(COL_NAME).contains(filter, Qt::CaseInsensitive))
-      return n;
+      m_SearchText = text;
 
-    if(n->childCount() > 0)
-    {
-      RDTreeWidgetItem *found = FindNode(n, filter, after);
+      int count = m_Model->SetFindResults(text, results);
 
-      if(found != NULL)
-        return found;
-    }
-  }
+      if(count > 0)
+        ui->findEvent->setPalette(palette());
+      else
+        ui->findEvent->setPalette(m_redPalette);
 
-  return NULL;
+      if(jump != 0)
+        JumpToResult(jump > 0);
+    });
+  });
 }
 
-int EventBrowser::FindEvent(RDTreeWidgetItem *parent, QString filter, uint32_t after, bool forward)
+void EventBrowser::JumpToResult(bool forward)
 {
-  if(parent == NULL)
-    return -1;
-
-  for(int i = forward ? 0 : parent->childCount() - 1; i >= 0 && i < parent->childCount();
-      i += forward ? 1 : -1)
-  {
-    auto n = parent->child(i);
-
-    uint eid = n->tag().value<EventItemTag>().lastEID;
-
-    bool matchesAfter = (forward && eid > after) || (!forward && eid < after);
-
-    if(matchesAfter)
-    {
-      QString name = n->text(COL_NAME);
-      if(name.contains(filter, Qt::CaseInsensitive))
-        return (int)eid;
-    }
-
-    if(n->childCount() > 0)
-    {
-      int found = FindEvent(n, filter, after, forward);
-
-      if(found > 0)
-        return found;
-    }
-  }
+  uint32_t curEID = m_Ctx.CurEvent();
 
-  return -1;
-}
+  QModelIndex idx = ui->events->currentIndex();
+  if(idx.isValid())
+    curEID = m_Model->GetLastEID(idx);
 
-int EventBrowser::FindEvent(QString filter, uint32_t after, bool forward)
-{
-  if(!m_Ctx.IsCaptureLoaded())
-    return 0;
-
-  return FindEvent(ui->events->topLevelItem(0), filter, after, forward);
+  int eid = m_Model->NextFindResult(curEID, forward);
+  if(eid >= 0)
+    SelectEvent((uint32_t)eid);
 }
 
 void EventBrowser::Find(bool forward)
 {
-  if(ui->findEvent->text().isEmpty())
-    return;
-
-  uint32_t curEID = m_Ctx.CurEvent();
+  QString text = ui->findEvent->text();
 
-  RDTreeWidgetItem *node = ui->events->selectedItem();
-  if(node)
-    curEID = node->tag().value<EventItemTag>().lastEID;
+  if(text.isEmpty())
+    return;
 
-  int eid = FindEvent(ui->findEvent->text(), curEID, forward);
-  if(eid >= 0)
-  {
-    SelectEvent((uint32_t)eid);
-    ui->findEvent->setPalette(palette());
-  }
-  else    // if(WrapSearch)
-  {
-    eid = FindEvent(ui->findEvent->text(), forward ? 0 : ~0U, forward);
-    if(eid >= 0)
-    {
-      SelectEvent((uint32_t)eid);
-      ui->findEvent->setPalette(palette());
-    }
-    else
-    {
-      ui->findEvent->setPalette(m_redPalette);
-    }
-  }
+  // if the results are already up to date we can jump straight away, otherwise the jump happens
+  // once the search completes.
+  if(text == m_SearchText)
+    JumpToResult(forward);
+  else
+    Search(text, forward ? 1 : -1);
 }
 
 void EventBrowser::UpdateDurationColumn()
@@ -1303,8 +1624,5 @@ void EventBrowser::UpdateDurationColumn()
 
   m_TimeUnit = m_Ctx.Config().EventBrowser_TimeUnit;
 
-  ui->events->setHeaderText(COL_DURATION, tr("Duration (%1)").arg(UnitSuffix(m_TimeUnit)));
-
-  if(!m_Times.empty())
-    SetDrawcallTimes(ui->events->topLevelItem(0), m_Times);
+  m_Model->SetTimeUnit(m_TimeUnit);
 }
@@ -26,6 +26,7 @@
 
 #include <QFrame>
 #include <QIcon>
+#include <QModelIndex>
 #include "Code/Interface/QRDInterface.h"
 
 namespace Ui
@@ -35,11 +36,10 @@ class EventBrowser;
 
 class QSpacerItem;
 class QToolButton;
-class RDTreeWidgetItem;
 class QTimer;
 class QTextStream;
 class FlowLayout;
-struct EventItemTag;
+class EventItemModel;
 
 class EventBrowser : public QFrame, public IEventBrowser, public ICaptureViewer
 {
@@ -75,7 +75,6 @@ private slots:
   void on_findEvent_returnPressed();
   void on_findEvent_keyPress(QKeyEvent *event);
   void on_findEvent_textEdited(const QString &arg1);
-  void on_events_currentItemChanged(RDTreeWidgetItem *current, RDTreeWidgetItem *previous);
   void on_findNext_clicked();
   void on_findPrev_clicked();
   void on_stepNext_clicked();
@@ -85,6 +84,7 @@ private slots:
 
   // manual slots
   void findHighlight_timeout();
+  void events_currentChanged(const QModelIndex &current, const QModelIndex &previous);
   void events_keyPress(QKeyEvent *event);
   void events_contextMenu(const QPoint &pos);
 
@@ -95,28 +95,18 @@ public slots:
   void jumpToBookmark(int idx);
 
 private:
-  QPair<uint32_t, uint32_t> AddDrawcalls(RDTreeWidgetItem *parent,
-                                         const rdcarray<DrawcallDescription> &draws);
-  void SetDrawcallTimes(RDTreeWidgetItem *node, const rdcarray<CounterResult> &results);
+  void ExpandNode(const QModelIndex &idx);
+  void ExpandAll(const QModelIndex &idx, bool expand);
 
-  void ExpandNode(RDTreeWidgetItem *node);
-
-  bool FindEventNode(RDTreeWidgetItem *&found, RDTreeWidgetItem *parent, uint32_t eventId);
   bool SelectEvent(uint32_t eventId);
 
-  void ClearFindIcons(RDTreeWidgetItem *parent);
   void ClearFindIcons();
 
-  int SetFindIcons(RDTreeWidgetItem *parent, QString filter);
-  int SetFindIcons(QString filter);
-
   void repopulateBookmarks();
   void highlightBookmarks();
-  bool hasBookmark(RDTreeWidgetItem *node);
 
-  RDTreeWidgetItem *FindNode(RDTreeWidgetItem *parent, QString filter, uint32_t after);
-  int FindEvent(RDTreeWidgetItem *parent, QString filter, uint32_t after, bool forward);
-  int FindEvent(QString filter, uint32_t after, bool forward);
+  void Search(const QString &text, int jump);
+  void JumpToResult(bool forward);
   void Find(bool forward);
 
   QString GetExportDrawcallString(int indent, bool firstchild, const DrawcallDescription &drawcall);
@@ -132,14 +122,15 @@ private:
 
   rdcarray<CounterResult> m_Times;
 
+  EventItemModel *m_Model;
+
   QTimer *m_FindHighlight;
+  QString m_SearchText;
 
   FlowLayout *m_BookmarkStripLayout;
   QSpacerItem *m_BookmarkSpacer;
   QMap<uint32_t, QToolButton *> m_BookmarkButtons;
 
-  void RefreshIcon(RDTreeWidgetItem *item, EventItemTag tag);
-
   Ui::EventBrowser *ui;
   ICaptureContext &m_Ctx;
 };
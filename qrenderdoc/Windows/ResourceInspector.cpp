@@ -177,18 +177,13 @@ void ResourceInspector::Inspect(ResourceId id)
   const SDFile &file = m_Ctx.GetStructuredFile();
   const ResourceDescription *desc = m_Ctx.GetResource(id);
 
-  m_Ctx.Replay().AsyncInvoke([this, id](IReplayController *r) {
+  // usage can be fetched without waiting for the replay, entry points need the driver.
+  m_Ctx.Replay().QueryInvoke(lit("ResourceUsage"), [this, id](IReplayController *r) {
     rdcarray<EventUsage> usage = r->GetUsage(id);
 
-    rdcarray<ShaderEntryPoint> entries = r->GetShaderEntryPoints(id);
-
-    GUIInvoke::call([this, id, entries, usage] {
-
-      if(!entries.isEmpty())
-      {
-        m_Entries = entries;
-        ui->viewContents->setVisible(true);
-      }
+    GUIInvoke::call([this, id, usage] {
+      if(m_Resource != id)
+        return;
 
       CombineUsageEvents(
           m_Ctx, usage, [this, id](uint32_t startEID, uint32_t endEID, ResourceUsage use) {
@@ -209,6 +204,18 @@ void ResourceInspector::Inspect(ResourceId id)
     });
   });
 
+  m_Ctx.Replay().AsyncInvoke([this, id](IReplayController *r) {
+    rdcarray<ShaderEntryPoint> entries = r->GetShaderEntryPoints(id);
+
+    GUIInvoke::call([this, id, entries] {
+      if(m_Resource == id && !entries.isEmpty())
+      {
+        m_Entries = entries;
+        ui->viewContents->setVisible(true);
+      }
+    });
+  });
+
   if(desc)
   {
     ANALYTIC_SET(UIFeatures.ResourceInspect, true);
@@ -786,6 +786,14 @@ void TextureViewer::RT_UpdateVisualRange(IReplayController *)
   }
 }
 
+void TextureViewer::UI_UpdateVisualRange()
+{
+  // the histogram always reflects the latest state when it's calculated, so if several updates are
+  // queued up - e.g. while changing the range - only the newest one needs to run.
+  m_Ctx.Replay().AsyncInvoke(lit("UpdateVisualRange"),
+                             [this](IReplayController *r) { RT_UpdateVisualRange(r); });
+}
+
 void TextureViewer::UI_UpdateStatusText()
 {
   TextureDescription *texptr = GetCurrentTexture();
@@ -1565,7 +1573,7 @@ void TextureViewer::UI_UpdateChannels()
   m_TexDisplay.flipY = ui->flip_y->isChecked();
 
   INVOKE_MEMFN(RT_UpdateAndDisplay);
-  INVOKE_MEMFN(RT_UpdateVisualRange);
+  UI_UpdateVisualRange();
 }
 
 void TextureViewer::SetupTextureTabs()
@@ -2099,7 +2107,7 @@ void TextureViewer::thumb_clicked(QMouseEvent *e)
     }
     else
     {
-      m_Ctx.Replay().AsyncInvoke([this, id](IReplayController *r) {
+      m_Ctx.Replay().QueryInvoke(lit("TextureUsage"), [this, id](IReplayController *r) {
         rdcarray<EventUsage> usage = r->GetUsage(id);
 
         GUIInvoke::call([this, id, usage]() { OpenResourceContextMenu(id, usage); });
@@ -2983,7 +2991,7 @@ void TextureViewer::rangePoint_Update()
 
   ui->rangeHistogram->setRange(black, white);
 
-  INVOKE_MEMFN(RT_UpdateVisualRange);
+  UI_UpdateVisualRange();
 }
 
 void TextureViewer::rangePoint_leave()
@@ -3019,7 +3027,7 @@ void TextureViewer::on_zoomRange_clicked()
 
   ui->rangeHistogram->setRange(black, white);
 
-  INVOKE_MEMFN(RT_UpdateVisualRange);
+  UI_UpdateVisualRange();
 }
 
 void TextureViewer::on_autoFit_clicked()
@@ -3040,7 +3048,7 @@ void TextureViewer::on_reset01_clicked()
 
   ui->autoFit->setChecked(false);
 
-  INVOKE_MEMFN(RT_UpdateVisualRange);
+  UI_UpdateVisualRange();
 }
 
 void TextureViewer::on_visualiseRange_clicked()
@@ -3050,7 +3058,7 @@ void TextureViewer::on_visualiseRange_clicked()
     ui->rangeHistogram->setMinimumSize(QSize(300, 90));
 
     m_Visualise = true;
-    INVOKE_MEMFN(RT_UpdateVisualRange);
+    UI_UpdateVisualRange();
   }
   else
   {
@@ -3067,7 +3075,7 @@ void TextureViewer::AutoFitRange()
   if(!m_Ctx.IsCaptureLoaded() || GetCurrentTexture() == NULL || m_Output == NULL)
     return;
 
-  m_Ctx.Replay().AsyncInvoke([this](IReplayController *r) {
+  m_Ctx.Replay().AsyncInvoke(lit("AutoFitRange"), [this](IReplayController *r) {
     PixelValue min, max;
     std::tie(min, max) = m_Output->GetMinMax();
 
@@ -3127,7 +3135,7 @@ void TextureViewer::AutoFitRange()
       {
         GUIInvoke::call([this, minval, maxval]() {
           ui->rangeHistogram->setRange(minval, maxval);
-          INVOKE_MEMFN(RT_UpdateVisualRange);
+          UI_UpdateVisualRange();
         });
       }
     }
@@ -3221,7 +3229,7 @@ void TextureViewer::on_mipLevel_currentIndexChanged(int index)
     return;
   }
 
-  INVOKE_MEMFN(RT_UpdateVisualRange);
+  UI_UpdateVisualRange();
 
   if(m_Output != NULL && m_PickedPoint.x() >= 0 && m_PickedPoint.y() >= 0)
   {
@@ -3243,7 +3251,7 @@ void TextureViewer::on_sliceFace_currentIndexChanged(int index)
   if(tex.depth > 1)
     m_TexDisplay.sliceFace = (uint32_t)(qMax(0, index) << (int)m_TexDisplay.mip);
 
-  INVOKE_MEMFN(RT_UpdateVisualRange);
+  UI_UpdateVisualRange();
 
   if(m_Output != NULL && m_PickedPoint.x() >= 0 && m_PickedPoint.y() >= 0)
   {
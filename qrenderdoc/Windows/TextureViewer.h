@@ -221,6 +221,7 @@ private:
   void UI_RecreatePanels();
 
   void UI_UpdateStatusText();
+  void UI_UpdateVisualRange();
   void UI_UpdateTextureDetails();
   void UI_OnTextureSelectionChanged(bool newdraw);
 
@@ -137,10 +137,13 @@ void TimelineBar::HighlightResourceUsage(ResourceId id)
   m_UsageEvents.clear();
   m_UsageTarget = m_Ctx.GetResourceName(id);
 
-  m_Ctx.Replay().AsyncInvoke([this, id](IReplayController *r) {
+  m_Ctx.Replay().QueryInvoke(lit("TimelineUsage"), [this, id](IReplayController *r) {
     rdcarray<EventUsage> usage = r->GetUsage(id);
 
-    GUIInvoke::call([this, usage]() {
+    GUIInvoke::call([this, id, usage]() {
+      if(m_ID != id)
+        return;
+
       for(const EventUsage &u : usage)
         m_UsageEvents << u;
       qSort(m_UsageEvents);
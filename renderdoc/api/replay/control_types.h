@@ -469,6 +469,91 @@ struct NewChildData
 
 DECLARE_REFLECTION_STRUCT(NewChildData);
 
+DOCUMENT(R"(Aggregated timings for one of RenderDoc's internal instrumentation probes.
+
+All times are in microseconds.
+)");
+struct ProbeStatistics
+{
+  DOCUMENT("The name of the probe.");
+  rdcstr name;
+  DOCUMENT("The number of times the probe has fired.");
+  uint64_t count = 0;
+
+  DOCUMENT("The total time spent inside the probe.");
+  double totalTime = 0.0;
+  DOCUMENT("The shortest time spent inside the probe.");
+  double minTime = 0.0;
+  DOCUMENT("The longest time spent inside the probe.");
+  double maxTime = 0.0;
+
+  DOCUMENT(R"(A histogram of durations in power-of-two buckets. The first entry counts every
+duration under 1us, entry ``N`` counts durations from ``2^(N-1)`` up to ``2^N`` microseconds, and
+the last entry counts everything longer.
+)");
+  rdcarray<uint64_t> histogram;
+};
+
+DECLARE_REFLECTION_STRUCT(ProbeStatistics);
+
+DOCUMENT(R"(Frame timing and capture overhead statistics gathered by the target over one telemetry
+interval. See :meth:`TargetControl.SetTelemetryInterval`.
+)");
+struct FrameTelemetryData
+{
+  DOCUMENT("The number of frames presented during this interval.");
+  uint32_t frameCount = 0;
+  DOCUMENT("The duration of this interval in milliseconds.");
+  double intervalTime = 0.0;
+
+  DOCUMENT("The average frame time in milliseconds over the interval.");
+  double avgFrameTime = 0.0;
+  DOCUMENT("The shortest frame time in milliseconds over the interval.");
+  double minFrameTime = 0.0;
+  DOCUMENT("The longest frame time in milliseconds over the interval.");
+  double maxFrameTime = 0.0;
+
+  DOCUMENT(R"(The upper bound in milliseconds of each bucket in :data:`frameTimeHistogram`.
+
+:data:`frameTimeHistogram` has one more entry than this list. The final entry counts every frame
+longer than the last bound.
+)");
+  rdcarray<float> frameTimeBuckets;
+  DOCUMENT("The number of frames in the interval that fell into each frame time bucket.");
+  rdcarray<uint32_t> frameTimeHistogram;
+
+  DOCUMENT(R"(The average time in milliseconds per frame spent inside RenderDoc's own processing in
+hooked functions, excluding the time spent in the underlying API calls.
+)");
+  double avgOverheadTime = 0.0;
+  DOCUMENT("The largest per-frame time in milliseconds spent inside RenderDoc's hooks.");
+  double maxOverheadTime = 0.0;
+
+  DOCUMENT(R"(The number of bytes found to have changed in persistent or coherent memory maps and
+flushed by RenderDoc during this interval.
+)");
+  uint64_t coherentMapBytes = 0;
+
+  DOCUMENT(R"(The number of serialised chunks currently held in memory by the target.
+
+.. note:: This is only tracked in development builds, otherwise it is always 0.
+)");
+  uint64_t liveChunks = 0;
+  DOCUMENT(R"(The number of bytes used by serialised chunks currently held in memory by the target.
+
+.. note:: This is only tracked in development builds, otherwise it is always 0.
+)");
+  uint64_t chunkMemory = 0;
+
+  DOCUMENT(R"(The :class:`statistics <ProbeStatistics>` for each internal instrumentation probe that
+has fired. Unlike the rest of the telemetry these are accumulated since telemetry was enabled,
+rather than covering only this interval.
+)");
+  rdcarray<ProbeStatistics> probes;
+};
+
+DECLARE_REFLECTION_STRUCT(FrameTelemetryData);
+
 DOCUMENT("A message from a target control connection.");
 struct TargetControlMessage
 {
@@ -489,6 +574,8 @@ When valid, will be in the range of 0.0 to 1.0 (0 - 100%). If not valid when a c
 or has finished, it will be -1.0
 )");
   float capProgress = -1.0f;
+  DOCUMENT("The :class:`frame telemetry data <FrameTelemetryData>`.");
+  FrameTelemetryData telemetry;
 };
 
 DECLARE_REFLECTION_STRUCT(TargetControlMessage);
@@ -704,6 +704,10 @@ protected:
 DOCUMENT(R"(The primary interface to access the information in a capture and the current state, as
 well as control the replay and analysis functionality available.
 
+The controller is not thread-safe in general and should only be used from one thread at a time. The
+exceptions are functions that only read information fixed when the capture is loaded - these are
+noted in their documentation and may be called from another thread while the replay is in use.
+
 .. data:: NoPreference
 
   No preference for a particular value, see :meth:`ReplayController.DebugPixel`.
@@ -896,6 +900,8 @@ See :meth:`BuildTargetShader`.
 
   DOCUMENT(R"(Retrieve the information about the frame contained in the capture.
 
+This function is safe to call from any thread, see :class:`ReplayController`.
+
 :return: The frame information.
 :rtype: FrameDescription
 )");
@@ -903,6 +909,8 @@ See :meth:`BuildTargetShader`.
 
   DOCUMENT(R"(Fetch the structured data representation of the capture loaded.
 
+This function is safe to call from any thread, see :class:`ReplayController`.
+
 :return: The structured file.
 :rtype: SDFile
 )");
@@ -910,11 +918,37 @@ See :meth:`BuildTargetShader`.
 
   DOCUMENT(R"(Retrieve the list of root-level drawcalls in the capture.
 
+This function is safe to call from any thread, see :class:`ReplayController`.
+
 :return: The list of root-level drawcalls in the capture.
 :rtype: ``list`` of :class:`DrawcallDescription`
 )");
   virtual rdcarray<DrawcallDescription> GetDrawcalls() = 0;
 
+  DOCUMENT(R"(Search the events in the capture for those matching a query.
+
+The query is a list of terms separated by spaces, and an event only matches if it matches every
+term. A term can be:
+
+* Plain text, which matches any event where the function name, drawcall name or a string or enum
+  parameter contains that text, ignoring case.
+* A :class:`ResourceId` such as ``ResourceId::123``, which matches events that reference exactly
+  that resource.
+* A parameter comparison such as ``groupCountX>64``, which matches events with a parameter of that
+  name which compares successfully. The comparisons available are ``=``, ``<``, ``<=``, ``>`` and
+  ``>=``. Parameters that aren't numbers can be compared with ``=``, which ignores case.
+
+The search index is built in the background when the capture is opened, so the first search may
+wait for it to finish.
+
+This function is safe to call from any thread, see :class:`ReplayController`.
+
+:param str query: The query to search for.
+:return: The matching eventIds, in ascending order.
+:rtype: ``list`` of ``int``
+)");
+  virtual rdcarray<uint32_t> SearchEvents(const char *query) = 0;
+
   DOCUMENT(R"(Retrieve the values of a specified set of counters.
 
 :param list counters: The list of :class:`GPUCounter` to fetch results for.
@@ -945,6 +979,8 @@ understanding as well as the type and unit of the resulting information.
 This includes any object allocated a :class:`ResourceId`, that don't have any other state or
 are only used as intermediary elements.
 
+This function is safe to call from any thread, see :class:`ReplayController`.
+
 :return: The list of resources in the capture.
 :rtype: ``list`` of :class:`ResourceDescription`
 )");
@@ -1058,12 +1094,26 @@ only ever have one result (only one entry point per shader).
 
   DOCUMENT(R"(Retrieve a list of ways a given resource is used.
 
+This function is safe to call from any thread, see :class:`ReplayController`.
+
 :param ResourceId id: The id of the texture or buffer resource to be queried.
 :return: The list of usages of the resource.
 :rtype: ``list`` of :class:`EventUsage`
 )");
   virtual rdcarray<EventUsage> GetUsage(ResourceId id) = 0;
 
+  DOCUMENT(R"(Retrieve the list of resources that are used at a given event.
+
+The usage of each resource can then be looked up with :meth:`GetUsage`.
+
+This function is safe to call from any thread, see :class:`ReplayController`.
+
+:param int eventId: The event to query.
+:return: The list of resources used at the event, in no particular order.
+:rtype: ``list`` of :class:`ResourceId`
+)");
+  virtual rdcarray<ResourceId> GetEventResources(uint32_t eventId) = 0;
+
   DOCUMENT(R"(Retrieve the contents of a constant block by reading from memory or their source
 otherwise.
 
@@ -1102,6 +1152,8 @@ texture to something compatible with the target file format.
 
   DOCUMENT(R"(Retrieve the contents of a range of a buffer as a ``bytes``.
 
+In python, :meth:`GetBufferDataView` returns the same data as a ``memoryview`` without copying it.
+
 :param ResourceId buff: The id of the buffer to retrieve data from.
 :param int offset: The byte offset to the start of the range.
 :param int len: The length of the range, or 0 to retrieve the rest of the bytes in the buffer.
@@ -1112,6 +1164,8 @@ texture to something compatible with the target file format.
 
   DOCUMENT(R"(Retrieve the contents of one subresource of a texture as a ``bytes``.
 
+In python, :meth:`GetTextureDataView` returns the same data as a ``memoryview`` without copying it.
+
 For multi-sampled images, they are treated as if they are an array that is Nx longer, with each
 array slice being expanded in-place so it would be slice 0: sample 0, slice 0: sample 1, slice 1:
 sample 0, etc.
@@ -1211,6 +1265,16 @@ target control connection.
 )");
   virtual void DeleteCapture(uint32_t captureId) = 0;
 
+  DOCUMENT(R"(Request periodic frame timing and capture overhead statistics from the target.
+
+After this call the target will send a message of type
+:attr:`TargetControlMessageType.FrameTelemetry` roughly every ``intervalMS`` milliseconds, with the
+statistics gathered since the previous message.
+
+:param int intervalMS: How often to send statistics, in milliseconds. If 0, telemetry is disabled.
+)");
+  virtual void SetTelemetryInterval(uint32_t intervalMS) = 0;
+
   DOCUMENT(R"(Query to see if a message has been received from the remote system.
 
 The details of the types of messages that can be received are listed under
@@ -76,6 +76,13 @@ version of RenderDoc that addes a new section type. They should be considered eq
   This section contains a .rgp profile from AMD's RGP tool, which can be extracted and loaded.
 
   The name for this section will be "amd/rgp/profile".
+
+.. data:: ContentBlobs
+
+  This section contains deduplicated byte buffers, referenced from the frame capture section by
+  content instead of being stored inline. Each unique buffer is stored once.
+
+  The name for this section will be "renderdoc/internal/blobs".
 )");
 enum class SectionType : uint32_t
 {
@@ -87,6 +94,7 @@ enum class SectionType : uint32_t
   Notes,
   ResourceRenames,
   AMDRGPProfile,
+  ContentBlobs,
   Count,
 };
 
@@ -3014,6 +3022,10 @@ DOCUMENT(R"(The type of message received from or sent to an application target c
 .. data:: CaptureProgress
 
   Progress update on an on-going frame capture.
+
+.. data:: FrameTelemetry
+
+  Periodic frame timing and capture overhead statistics, sent when requested.
 )");
 enum class TargetControlMessageType : uint32_t
 {
@@ -3026,6 +3038,7 @@ enum class TargetControlMessageType : uint32_t
   RegisterAPI,
   NewChild,
   CaptureProgress,
+  FrameTelemetry,
 };
 
 DECLARE_REFLECTION_ENUM(TargetControlMessageType);
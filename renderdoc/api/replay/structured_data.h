@@ -374,6 +374,42 @@ struct SDObject
     return NULL;
   }
 
+#if !defined(SWIG)
+  // follow a list of child names down from this object. A name made only of digits selects an
+  // array element.
+  inline const SDObject *FindChildByPath(const rdcarray<rdcstr> &path) const
+  {
+    const SDObject *obj = this;
+
+    for(size_t p = 0; obj && p < path.size(); p++)
+    {
+      const rdcstr &childName = path[p];
+
+      bool numeric = obj->type.basetype == SDBasic::Array && !childName.empty();
+      for(char c : childName)
+        numeric = numeric && c >= '0' && c <= '9';
+
+      if(numeric)
+      {
+        size_t count = obj->data.children.size();
+        size_t idx = 0;
+
+        // stop accumulating once past the end, so a long index can't overflow back into range
+        for(char c : childName)
+          idx = idx < count ? idx * 10 + size_t(c - '0') : count;
+
+        obj = idx < count ? obj->data.children[idx] : NULL;
+      }
+      else
+      {
+        obj = obj->FindChild(childName.c_str());
+      }
+    }
+
+    return obj;
+  }
+#endif
+
   DOCUMENT("Add a new child object by duplicating it.");
   inline void AddChild(SDObject *child) { data.children.push_back(child->Duplicate()); }
 #if defined(RENDERDOC_QT_COMPAT)
@@ -712,7 +748,171 @@ struct SDFile
     std::swap(version, other.version);
   }
 
+  DOCUMENT(R"(Extract numeric values from many chunks at once as a packed table, without creating a
+python object for every chunk and parameter.
+
+Each column is a ``.``-separated path of child names from the chunk to a value, e.g.
+``CreateInfo.size``. A path component that is a number selects that element of an array. The
+following special columns give the chunk's properties instead of a parameter:
+
+* ``$index`` - the index of the chunk in :data:`chunks`.
+* ``$chunkID`` - :data:`SDChunkMetaData.chunkID`.
+* ``$threadID`` - :data:`SDChunkMetaData.threadID`.
+* ``$duration`` - :data:`SDChunkMetaData.durationMicro`.
+* ``$timestamp`` - :data:`SDChunkMetaData.timestampMicro`.
+
+Every value is converted to the requested type and stored as 8 bytes: a ``double`` for
+:data:`SDBasic.Float`, a signed 64-bit integer for :data:`SDBasic.SignedInteger` and an unsigned
+64-bit integer for anything else. Values that are missing or not numeric are stored as 0.
+
+:param str chunkName: Only chunks with this name are included, or all chunks if it is empty.
+:param List[str] columns: The paths to the values to extract.
+:param SDBasic type: The type to store values as.
+:return: The table in row-major order, with one row per included chunk. In python this can be
+  passed to ``numpy.frombuffer`` and reshaped, or viewed with ``memoryview.cast``.
+:rtype: ``bytes``
+)");
+  inline bytebuf ExtractTable(const char *chunkName, const rdcarray<rdcstr> &columns,
+                              SDBasic type) const
+  {
+    rdcarray<rdcarray<rdcstr>> paths;
+    paths.resize(columns.size());
+    for(size_t c = 0; c < columns.size(); c++)
+    {
+      const char *start = columns[c].c_str();
+      for(const char *cur = start;; cur++)
+      {
+        if(*cur == '.' || *cur == 0)
+        {
+          paths[c].push_back(std::string(start, cur));
+          start = cur + 1;
+        }
+
+        if(*cur == 0)
+          break;
+      }
+    }
+
+    rdcstr name = chunkName ? chunkName : "";
+
+    size_t rows = 0;
+    for(const SDChunk *chunk : chunks)
+      if(name.empty() || chunk->name == name)
+        rows++;
+
+    bytebuf ret;
+    ret.resize(rows * columns.size() * sizeof(uint64_t));
+
+    byte *out = ret.data();
+    for(size_t i = 0; i < chunks.size(); i++)
+    {
+      const SDChunk *chunk = chunks[i];
+
+      if(!name.empty() && chunk->name != name)
+        continue;
+
+      for(const rdcarray<rdcstr> &path : paths)
+      {
+        SDObjectPODData val;
+        SDBasic valType = SDBasic::UnsignedInteger;
+
+        if(path.size() == 1 && path[0].size() > 1 && path[0][0] == '$')
+        {
+          if(path[0] == "$index")
+            val.u = i;
+          else if(path[0] == "$chunkID")
+            val.u = chunk->metadata.chunkID;
+          else if(path[0] == "$threadID")
+            val.u = chunk->metadata.threadID;
+          else if(path[0] == "$timestamp")
+            val.u = chunk->metadata.timestampMicro;
+          else if(path[0] == "$duration")
+          {
+            val.i = chunk->metadata.durationMicro;
+            valType = SDBasic::SignedInteger;
+          }
+        }
+        else
+        {
+          const SDObject *obj = chunk->FindChildByPath(path);
+
+          if(obj)
+          {
+            val = obj->data.basic;
+            valType = obj->type.basetype;
+          }
+        }
+
+        WritePODValue(out, val, valType, type);
+        out += sizeof(uint64_t);
+      }
+    }
+
+    return ret;
+  }
+
+  DOCUMENT(R"(Extract a single numeric value from many chunks at once as a packed array. See
+:meth:`ExtractTable` for how the column and type are interpreted.
+
+:param str chunkName: Only chunks with this name are included, or all chunks if it is empty.
+:param str column: The path to the value to extract.
+:param SDBasic type: The type to store values as.
+:return: The values packed into an array of 8-byte elements, one per included chunk.
+:rtype: ``bytes``
+)");
+  inline bytebuf ExtractColumn(const char *chunkName, const char *column, SDBasic type) const
+  {
+    return ExtractTable(chunkName, {rdcstr(column)}, type);
+  }
+
 protected:
+  static void WritePODValue(byte *out, const SDObjectPODData &val, SDBasic valType, SDBasic type)
+  {
+    // a value that isn't numeric at all, like a string or struct, is written as 0
+    double d = 0.0;
+    int64_t i = 0;
+
+    switch(valType)
+    {
+      case SDBasic::Enum:
+      case SDBasic::Resource:
+      case SDBasic::UnsignedInteger:
+        d = double(val.u);
+        i = int64_t(val.u);
+        break;
+      case SDBasic::SignedInteger:
+        d = double(val.i);
+        i = val.i;
+        break;
+      case SDBasic::Float:
+        d = val.d;
+        // converting a NaN or out of range double is undefined, so clamp first
+        if(val.d != val.d)
+          i = 0;
+        else if(val.d >= 9223372036854775807.0)
+          i = INT64_MAX;
+        else if(val.d <= -9223372036854775808.0)
+          i = INT64_MIN;
+        else
+          i = int64_t(val.d);
+        break;
+      case SDBasic::Boolean:
+        d = val.b ? 1.0 : 0.0;
+        i = val.b ? 1 : 0;
+        break;
+      case SDBasic::Character:
+        d = double(val.c);
+        i = val.c;
+        break;
+      default: break;
+    }
+
+    if(type == SDBasic::Float)
+      memcpy(out, &d, sizeof(d));
+    else
+      memcpy(out, &i, sizeof(i));
+  }
+
   SDFile(const SDFile &) = delete;
   SDFile &operator=(const SDFile &) = delete;
 };
@@ -27,6 +27,7 @@
 #include <stdarg.h>
 #include <string.h>
 #include <string>
+#include "common/probes.h"
 #include "common/threading.h"
 #include "os/os_specific.h"
 #include "strings/string_utils.h"
@@ -126,6 +127,8 @@ bool Vec16NotEqual(void *a, void *b)
 
 bool FindDiffRange(void *a, void *b, size_t bufSize, size_t &diffStart, size_t &diffEnd)
 {
+  SCOPED_PROBE(FindDiffRange);
+
   RDCASSERT(uintptr_t(a) % 16 == 0);
   RDCASSERT(uintptr_t(b) % 16 == 0);
 
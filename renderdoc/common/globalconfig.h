@@ -186,4 +186,11 @@ enum
 // this strips them completely
 #define STRIP_DEBUG_LOGS OPTION_OFF
 
-#define ENABLE_UNIT_TESTS RDOC_DEVEL
\ No newline at end of file
+#define ENABLE_UNIT_TESTS RDOC_DEVEL
+
+/////////////////////////////////////////////////
+// Profiling configuration
+
+// compile in SCOPED_PROBE instrumentation. Probes are still off at runtime until enabled, which
+// costs a single branch per probe
+#define ENABLE_PROBES OPTION_ON
\ No newline at end of file
@@ -0,0 +1,387 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "probes.h"
+#include <vector>
+#include "common/threading.h"
+
+namespace
+{
+const char *ProbeNames[] = {
+    "EndFrameCapture", "InsertInitialContents", "Serialise_InitialState", "FindDiffRange",
+    "QueueSubmit",     "BeginChunk",            "ReplayLog",              "SetFrameEvent",
+    "SaveTexture",     "ProxyPacket",
+};
+
+RDCCOMPILE_ASSERT(ARRAY_COUNT(ProbeNames) == (size_t)ProbeId::Count,
+                  "Probe names are out of sync with ProbeId");
+
+struct ProbeEvent
+{
+  ProbeId probe;
+  uint64_t threadId;
+  uint64_t begin;
+  uint64_t end;
+};
+
+struct ProbeAggregate
+{
+  uint64_t count;
+  uint64_t total;
+  uint64_t min;
+  uint64_t max;
+  uint64_t histogram[Probes::HistogramBuckets];
+};
+
+// Everything in here is only ever written by the owning thread. The ring is published through the
+// monotonic 'written' counter, and a reader can tell which entries might have been overwritten
+// while it was copying by re-reading the counter afterwards. The aggregates are read without any
+// synchronisation, since at worst a reader sees a value that's one event stale.
+//
+// When a thread exits its block is handed on to the next new thread, which carries on from the
+// existing ring and aggregates. Events record their own thread so recycling doesn't misattribute
+// them.
+struct ThreadProbes
+{
+  volatile int64_t written;
+  ProbeEvent ring[Probes::RingSize];
+  ProbeAggregate aggregates[(size_t)ProbeId::Count];
+};
+
+bool initialised = false;
+double microsPerTick = 1.0;
+
+// thread data is never freed so that statistics from threads that have exited are still reported,
+// instead blocks from exited threads are kept in freeList to be reused.
+Threading::CriticalSection threadListLock;
+std::vector<ThreadProbes *> threadList;
+std::vector<ThreadProbes *> freeList;
+
+// owns the current thread's block, and returns it to the free list when the thread exits.
+struct ThreadProbesOwner
+{
+  ThreadProbes *probes = NULL;
+
+  ~ThreadProbesOwner()
+  {
+    if(probes)
+    {
+      SCOPED_LOCK(threadListLock);
+      freeList.push_back(probes);
+    }
+  }
+};
+
+thread_local ThreadProbesOwner threadProbes;
+
+ThreadProbes *GetThreadProbes()
+{
+  if(threadProbes.probes)
+    return threadProbes.probes;
+
+  ThreadProbes *ret = NULL;
+
+  {
+    SCOPED_LOCK(threadListLock);
+
+    if(!freeList.empty())
+    {
+      ret = freeList.back();
+      freeList.pop_back();
+    }
+    else
+    {
+      ret = new ThreadProbes;
+      memset(ret, 0, sizeof(ThreadProbes));
+      threadList.push_back(ret);
+    }
+  }
+
+  threadProbes.probes = ret;
+
+  return ret;
+}
+
+std::vector<ThreadProbes *> GetThreadList()
+{
+  SCOPED_LOCK(threadListLock);
+  return threadList;
+}
+};
+
+namespace Probes
+{
+bool Enabled = false;
+
+void Init()
+{
+  initialised = true;
+
+  // the tick frequency is in ticks per millisecond
+  microsPerTick = 1000.0 / Timing::GetTickFrequency();
+}
+
+void SetEnabled(bool enabled)
+{
+  if(enabled && !initialised)
+  {
+    RDCERR("Probes can't be enabled before they are initialised");
+    return;
+  }
+
+  Enabled = enabled;
+}
+
+const char *GetName(ProbeId probe)
+{
+  if(probe < ProbeId::Count)
+    return ProbeNames[(size_t)probe];
+
+  return "Unknown";
+}
+
+void Record(ProbeId probe, uint64_t begin, uint64_t end)
+{
+  ThreadProbes *t = GetThreadProbes();
+
+  uint64_t idx = (uint64_t)t->written;
+
+  ProbeEvent &ev = t->ring[idx % RingSize];
+  ev.probe = probe;
+  ev.threadId = Threading::GetCurrentID();
+  ev.begin = begin;
+  ev.end = end;
+
+  Atomic::Inc64(&t->written);
+
+  ProbeAggregate &agg = t->aggregates[(size_t)probe];
+
+  uint64_t duration = end - begin;
+
+  if(agg.count == 0 || duration < agg.min)
+    agg.min = duration;
+  if(duration > agg.max)
+    agg.max = duration;
+
+  agg.count++;
+  agg.total += duration;
+
+  uint32_t micros = (uint32_t)RDCMIN(double(duration) * microsPerTick, 2147483647.0);
+
+  uint32_t bucket = 0;
+  if(micros > 0)
+    bucket = RDCMIN(Log2Floor(micros) + 1, HistogramBuckets - 1);
+
+  agg.histogram[bucket]++;
+}
+
+rdcarray<ProbeStatistics> GetStatistics()
+{
+  ProbeAggregate totals[(size_t)ProbeId::Count] = {};
+
+  for(ThreadProbes *t : GetThreadList())
+  {
+    for(size_t p = 0; p < (size_t)ProbeId::Count; p++)
+    {
+      const ProbeAggregate &agg = t->aggregates[p];
+      ProbeAggregate &total = totals[p];
+
+      if(agg.count == 0)
+        continue;
+
+      if(total.count == 0 || agg.min < total.min)
+        total.min = agg.min;
+      total.max = RDCMAX(total.max, agg.max);
+      total.count += agg.count;
+      total.total += agg.total;
+
+      for(uint32_t b = 0; b < HistogramBuckets; b++)
+        total.histogram[b] += agg.histogram[b];
+    }
+  }
+
+  rdcarray<ProbeStatistics> ret;
+
+  for(size_t p = 0; p < (size_t)ProbeId::Count; p++)
+  {
+    const ProbeAggregate &total = totals[p];
+
+    if(total.count == 0)
+      continue;
+
+    ProbeStatistics stats;
+    stats.name = ProbeNames[p];
+    stats.count = total.count;
+    stats.totalTime = double(total.total) * microsPerTick;
+    stats.minTime = double(total.min) * microsPerTick;
+    stats.maxTime = double(total.max) * microsPerTick;
+    stats.histogram.assign(total.histogram, HistogramBuckets);
+
+    ret.push_back(stats);
+  }
+
+  return ret;
+}
+
+bool WriteChromeTrace(const char *filename)
+{
+  FILE *f = FileIO::fopen(filename, "wb");
+
+  if(!f)
+  {
+    RDCERR("Couldn't open probe trace file '%s'", filename);
+    return false;
+  }
+
+  uint32_t pid = Process::GetCurrentPID();
+  std::string json = "{\"traceEvents\":[\n";
+  bool first = true;
+  uint32_t numEvents = 0;
+
+  std::vector<ProbeEvent> events;
+
+  for(ThreadProbes *t : GetThreadList())
+  {
+    uint64_t end = (uint64_t)Atomic::ExchAdd64(&t->written, 0);
+    uint64_t begin = end > RingSize ? end - RingSize : 0;
+
+    events.resize(size_t(end - begin));
+    for(uint64_t i = begin; i < end; i++)
+      events[size_t(i - begin)] = t->ring[i % RingSize];
+
+    // anything the thread wrote while we were copying may have clobbered the oldest entries, and
+    // the slot for the next event may be partially written, so drop those.
+    uint64_t now = (uint64_t)Atomic::ExchAdd64(&t->written, 0);
+    uint64_t firstValid = now >= RingSize ? now - RingSize + 1 : 0;
+
+    for(uint64_t i = RDCMAX(begin, firstValid); i < end; i++)
+    {
+      const ProbeEvent &ev = events[size_t(i - begin)];
+
+      if(ev.probe >= ProbeId::Count)
+        continue;
+
+      json += StringFormat::Fmt(
+          "%s{\"name\":\"%s\",\"cat\":\"renderdoc\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+          "\"pid\":%u,\"tid\":%llu}",
+          first ? "" : ",\n", ProbeNames[(size_t)ev.probe], double(ev.begin) * microsPerTick,
+          double(ev.end - ev.begin) * microsPerTick, pid, ev.threadId);
+
+      first = false;
+      numEvents++;
+    }
+  }
+
+  json += "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+  FileIO::fwrite(json.data(), 1, json.size(), f);
+  FileIO::fclose(f);
+
+  RDCLOG("Wrote %u probe events to '%s'", numEvents, filename);
+
+  return true;
+}
+};
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#include "3rdparty/catch/catch.hpp"
+
+TEST_CASE("Test probe aggregation", "[probes]")
+{
+  bool wasEnabled = Probes::IsEnabled();
+
+  Probes::SetEnabled(true);
+
+  auto findProbe = [](ProbeId probe) {
+    ProbeStatistics ret;
+    for(const ProbeStatistics &stats : Probes::GetStatistics())
+      if(stats.name == Probes::GetName(probe))
+        ret = stats;
+    return ret;
+  };
+
+  ProbeStatistics before = findProbe(ProbeId::FindDiffRange);
+
+  uint64_t tick = Timing::GetTick();
+  uint64_t tickPerMicro = uint64_t(Timing::GetTickFrequency() / 1000.0);
+
+  Probes::Record(ProbeId::FindDiffRange, tick, tick);
+  Probes::Record(ProbeId::FindDiffRange, tick, tick + tickPerMicro * 5);
+
+  ProbeStatistics after = findProbe(ProbeId::FindDiffRange);
+
+  CHECK(after.count == before.count + 2);
+  REQUIRE(after.histogram.size() == Probes::HistogramBuckets);
+
+  // 0us lands in the first bucket, 5us lands in [4, 8)
+  CHECK(after.histogram[0] >= 1);
+  CHECK(after.histogram[3] >= 1);
+  CHECK(after.minTime == 0.0);
+  CHECK(after.maxTime >= 4.9);
+
+  Probes::SetEnabled(wasEnabled);
+}
+
+TEST_CASE("Test probe data is recycled from exited threads", "[probes]")
+{
+  bool wasEnabled = Probes::IsEnabled();
+
+  Probes::SetEnabled(true);
+
+  auto countProbe = [](ProbeId probe) {
+    uint64_t ret = 0;
+    for(const ProbeStatistics &stats : Probes::GetStatistics())
+      if(stats.name == Probes::GetName(probe))
+        ret = stats.count;
+    return ret;
+  };
+
+  auto recordOnThread = []() {
+    Threading::ThreadHandle thread = Threading::CreateThread([]() {
+      uint64_t tick = Timing::GetTick();
+      Probes::Record(ProbeId::ProxyPacket, tick, tick);
+    });
+    Threading::JoinThread(thread);
+    Threading::CloseThread(thread);
+  };
+
+  uint64_t before = countProbe(ProbeId::ProxyPacket);
+
+  // make sure at least one exited thread's block is available to reuse
+  recordOnThread();
+
+  size_t numThreads = GetThreadList().size();
+
+  for(int i = 0; i < 32; i++)
+    recordOnThread();
+
+  // the later threads all reused the same block, but its statistics are still reported
+  CHECK(GetThreadList().size() == numThreads);
+  CHECK(countProbe(ProbeId::ProxyPacket) == before + 33);
+
+  Probes::SetEnabled(wasEnabled);
+}
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
@@ -0,0 +1,109 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include "os/os_specific.h"
+#include "common.h"
+
+// Lightweight timing probes for hot paths, where SCOPED_TIMER's per-scope formatting and logging
+// would be far too expensive. Each probe is a fixed ID declared below. When probes are disabled a
+// SCOPED_PROBE costs a single branch, when enabled it costs two timestamps and a write into a
+// per-thread ring buffer plus per-thread aggregates, without taking any locks.
+//
+// The aggregates are returned through target control telemetry, and the recent events in each
+// thread's ring can be written out as a Chrome trace (chrome://tracing or Perfetto).
+enum class ProbeId : uint32_t
+{
+  // capture
+  EndFrameCapture,
+  InsertInitialContents,
+  SerialiseInitialState,
+  FindDiffRange,
+  QueueSubmit,
+  BeginChunk,
+
+  // replay
+  ReplayLog,
+  SetFrameEvent,
+  SaveTexture,
+  ProxyPacket,
+
+  Count,
+};
+
+namespace Probes
+{
+// the number of log2 buckets in the duration histogram of each probe. Bucket 0 counts everything
+// under 1us, bucket N counts [2^(N-1), 2^N) us, and the last bucket counts everything longer.
+static const uint32_t HistogramBuckets = 24;
+
+// the number of events kept in each thread's ring buffer for trace export.
+static const uint32_t RingSize = 8192;
+
+extern bool Enabled;
+
+void Init();
+
+inline bool IsEnabled()
+{
+  return Enabled;
+}
+void SetEnabled(bool enabled);
+
+const char *GetName(ProbeId probe);
+
+void Record(ProbeId probe, uint64_t begin, uint64_t end);
+
+// returns the aggregated statistics for every probe that has fired at least once, summed over all
+// threads since probes were first enabled.
+rdcarray<ProbeStatistics> GetStatistics();
+
+// writes the events currently held in every thread's ring buffer as a Chrome trace event JSON file.
+bool WriteChromeTrace(const char *filename);
+};
+
+class ScopedProbe
+{
+public:
+  ScopedProbe(ProbeId probe) : m_Probe(probe), m_Begin(Probes::IsEnabled() ? Timing::GetTick() : 0)
+  {
+  }
+  ~ScopedProbe()
+  {
+    if(m_Begin)
+      Probes::Record(m_Probe, m_Begin, Timing::GetTick());
+  }
+
+private:
+  ProbeId m_Probe;
+  uint64_t m_Begin;
+};
+
+#if ENABLED(ENABLE_PROBES)
+#define SCOPED_PROBE(probe) ScopedProbe CONCAT(probe_, __LINE__)(ProbeId::probe);
+#else
+#define SCOPED_PROBE(probe)
+#endif
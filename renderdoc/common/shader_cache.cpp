@@ -0,0 +1,381 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "shader_cache.h"
+#include <algorithm>
+#include "strings/string_utils.h"
+
+// once this many entries have been appended to the file outside of the index, it's rewritten when
+// the cache is closed by a session that added any.
+static const size_t MaxAppendedEntries = 256;
+
+// everything in the file is kept 8-byte aligned so the index can be read in place.
+static const uint64_t EntryAlignment = 8;
+
+ShaderCacheFile::ShaderCacheFile(const std::string &filename, uint32_t magicNumber,
+                                 uint32_t versionNumber)
+    : m_Filename(filename), m_Magic(magicNumber), m_Version(versionNumber)
+{
+  Open();
+}
+
+ShaderCacheFile::~ShaderCacheFile()
+{
+  if(m_AppendFile)
+    FileIO::fclose(m_AppendFile);
+
+  // a session that only read from the cache leaves it alone, even if it's due to be compacted, so
+  // that processes sharing the cache don't all rewrite it.
+  if(!m_Added.empty() && (m_Rewrite || m_Appended.size() + m_Added.size() >= MaxAppendedEntries))
+    Compact();
+
+  FileIO::UnmapFile(m_Mapped, m_MappedSize);
+}
+
+void ShaderCacheFile::Open()
+{
+  RDCCOMPILE_ASSERT(sizeof(Header) == 32, "Shader cache header is the wrong size");
+  RDCCOMPILE_ASSERT(sizeof(IndexEntry) == 24, "Shader cache index entry is the wrong size");
+
+  m_Mapped = FileIO::MapFile(m_Filename.c_str(), m_MappedSize);
+
+  if(!m_Mapped)
+  {
+    m_Rewrite = true;
+    return;
+  }
+
+  Header header = {};
+  if(m_MappedSize >= sizeof(Header))
+    memcpy(&header, m_Mapped, sizeof(Header));
+
+  if(header.fileMagic != FileMagic || header.fileVersion != FileVersion ||
+     header.magicNumber != m_Magic || header.versionNumber != m_Version)
+  {
+    RDCDEBUG("Out of date or invalid shader cache magic: %x version: %u", header.magicNumber,
+             header.versionNumber);
+    m_Rewrite = true;
+    return;
+  }
+
+  if(header.indexOffset < sizeof(Header) || header.indexOffset % EntryAlignment != 0 ||
+     header.indexOffset > m_MappedSize ||
+     header.indexCount > (m_MappedSize - header.indexOffset) / sizeof(IndexEntry))
+  {
+    RDCERR("Invalid shader cache - index is out of bounds");
+    m_Rewrite = true;
+    return;
+  }
+
+  m_Index = (const IndexEntry *)(m_Mapped + header.indexOffset);
+  m_IndexCount = header.indexCount;
+  m_Size = m_MappedSize;
+
+  // gather up any entries that were appended since the index was written. Each one is preceeded by
+  // an index entry for itself.
+  uint64_t offs = header.indexOffset + header.indexCount * sizeof(IndexEntry);
+
+  while(offs + sizeof(IndexEntry) <= m_MappedSize)
+  {
+    IndexEntry entry;
+    memcpy(&entry, m_Mapped + offs, sizeof(IndexEntry));
+
+    if(entry.offset != offs + sizeof(IndexEntry) || entry.size > m_MappedSize - entry.offset)
+      break;
+
+    m_Appended[entry.hash] = entry;
+
+    offs = AlignUp(entry.offset + entry.size, EntryAlignment);
+  }
+
+  if(offs != m_MappedSize)
+  {
+    RDCWARN("Shader cache has %llu bytes of truncated or corrupt data at the end",
+            m_MappedSize - RDCMIN(offs, m_MappedSize));
+    m_Rewrite = true;
+  }
+}
+
+bool ShaderCacheFile::Find(uint64_t hash, const byte *&data, uint32_t &size)
+{
+  auto added = m_Added.find(hash);
+  if(added != m_Added.end())
+  {
+    data = added->second.data();
+    size = (uint32_t)added->second.size();
+    return true;
+  }
+
+  const IndexEntry *entry = NULL;
+
+  auto appended = m_Appended.find(hash);
+  if(appended != m_Appended.end())
+  {
+    entry = &appended->second;
+  }
+  else if(m_IndexCount > 0)
+  {
+    const IndexEntry *end = m_Index + m_IndexCount;
+    const IndexEntry *it = std::lower_bound(
+        m_Index, end, hash, [](const IndexEntry &e, uint64_t h) { return e.hash < h; });
+
+    if(it != end && it->hash == hash)
+      entry = it;
+  }
+
+  if(!entry)
+    return false;
+
+  if(entry->offset > m_MappedSize || entry->size > m_MappedSize - entry->offset)
+  {
+    RDCERR("Invalid shader cache - entry %llx is out of bounds", hash);
+    return false;
+  }
+
+  data = m_Mapped + entry->offset;
+  size = entry->size;
+  return true;
+}
+
+void ShaderCacheFile::Add(uint64_t hash, const byte *data, uint32_t size)
+{
+  const byte *existingData = NULL;
+  uint32_t existingSize = 0;
+  if(Find(hash, existingData, existingSize))
+    return;
+
+  m_Added[hash].assign(data, size);
+  m_Size += sizeof(IndexEntry) + AlignUp((uint64_t)size, EntryAlignment);
+
+  // if the file is going to be rewritten anyway, don't append to it
+  if(m_Rewrite)
+    return;
+
+  if(!m_AppendFile)
+  {
+    m_AppendFile = FileIO::fopen(m_Filename.c_str(), "ab");
+
+    if(!m_AppendFile)
+    {
+      RDCWARN("Couldn't open shader cache '%s' for append", m_Filename.c_str());
+      m_Rewrite = true;
+      return;
+    }
+
+    // each entry is written with a single unbuffered write, which the append mode places at the
+    // end of the file atomically with respect to other processes appending.
+    setvbuf(m_AppendFile, NULL, _IONBF, 0);
+  }
+
+  // another process could have appended or rewritten the file, so always find the current end.
+  FileIO::fseek64(m_AppendFile, 0, SEEK_END);
+  uint64_t offs = FileIO::ftell64(m_AppendFile);
+
+  if(offs % EntryAlignment != 0)
+  {
+    m_Rewrite = true;
+    return;
+  }
+
+  IndexEntry entry = {hash, offs + sizeof(IndexEntry), size, 0};
+
+  bytebuf buf;
+  buf.resize(size_t(sizeof(IndexEntry) + AlignUp((uint64_t)size, EntryAlignment)));
+  memcpy(buf.data(), &entry, sizeof(entry));
+  memcpy(buf.data() + sizeof(entry), data, size);
+
+  FileIO::fwrite(buf.data(), 1, buf.size(), m_AppendFile);
+
+  // if another process appended between finding the end and writing, our entry landed somewhere
+  // other than where it says it is. It will fail validation on the next load, so rewrite the file
+  // now with everything we know about.
+  if(FileIO::ftell64(m_AppendFile) != offs + buf.size())
+    m_Rewrite = true;
+}
+
+void ShaderCacheFile::Clear()
+{
+  m_Index = NULL;
+  m_IndexCount = 0;
+  m_Appended.clear();
+  m_Added.clear();
+  m_Size = 0;
+  m_Rewrite = true;
+}
+
+void ShaderCacheFile::Compact()
+{
+  // sorted by hash, and entries added later override earlier ones
+  std::map<uint64_t, std::pair<const byte *, uint32_t>> entries;
+
+  for(uint64_t i = 0; i < m_IndexCount; i++)
+  {
+    const IndexEntry &entry = m_Index[i];
+    if(entry.offset <= m_MappedSize && entry.size <= m_MappedSize - entry.offset)
+      entries[entry.hash] = {m_Mapped + entry.offset, entry.size};
+  }
+
+  for(auto it = m_Appended.begin(); it != m_Appended.end(); ++it)
+    entries[it->first] = {m_Mapped + it->second.offset, it->second.size};
+
+  for(auto it = m_Added.begin(); it != m_Added.end(); ++it)
+    entries[it->first] = {it->second.data(), (uint32_t)it->second.size()};
+
+  // write to a temporary file and then move it over the cache, so that another process reading the
+  // cache never sees a partially written file.
+  std::string tmpFilename =
+      StringFormat::Fmt("%s.%u.tmp", m_Filename.c_str(), Process::GetCurrentPID());
+
+  FILE *f = FileIO::fopen(tmpFilename.c_str(), "wb");
+
+  if(!f)
+  {
+    RDCERR("Error opening shader cache for write");
+    return;
+  }
+
+  Header header = {FileMagic, FileVersion, m_Magic, m_Version, 0, entries.size()};
+  FileIO::fwrite(&header, 1, sizeof(header), f);
+
+  std::vector<IndexEntry> index;
+  index.reserve(entries.size());
+
+  const byte padding[EntryAlignment] = {};
+  uint64_t offs = sizeof(header);
+
+  for(auto it = entries.begin(); it != entries.end(); ++it)
+  {
+    uint32_t size = it->second.second;
+    uint64_t alignedSize = AlignUp((uint64_t)size, EntryAlignment);
+
+    FileIO::fwrite(it->second.first, 1, size, f);
+    FileIO::fwrite(padding, 1, size_t(alignedSize - size), f);
+
+    index.push_back({it->first, offs, size, 0});
+
+    offs += alignedSize;
+  }
+
+  header.indexOffset = offs;
+  if(!index.empty())
+    FileIO::fwrite(index.data(), sizeof(IndexEntry), index.size(), f);
+
+  FileIO::fseek64(f, 0, SEEK_SET);
+  FileIO::fwrite(&header, 1, sizeof(header), f);
+
+  FileIO::fclose(f);
+
+  // the old file must be unmapped before it can be replaced on some platforms
+  FileIO::UnmapFile(m_Mapped, m_MappedSize);
+  m_Mapped = NULL;
+  m_MappedSize = 0;
+  m_Index = NULL;
+  m_IndexCount = 0;
+  m_Appended.clear();
+
+  if(FileIO::Move(tmpFilename.c_str(), m_Filename.c_str(), true))
+  {
+    RDCDEBUG("Successfully wrote %zu shaders to shader cache", entries.size());
+  }
+  else
+  {
+    RDCWARN("Couldn't replace shader cache '%s'", m_Filename.c_str());
+    FileIO::Delete(tmpFilename.c_str());
+  }
+}
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#include "3rdparty/catch/catch.hpp"
+
+TEST_CASE("Test shader cache file", "[shadercache]")
+{
+  std::string filename = FileIO::GetTempFolderFilename() + "renderdoc_shadercache_test.cache";
+  FileIO::Delete(filename.c_str());
+
+  const uint32_t magic = MAKE_FOURCC('T', 'E', 'S', 'T');
+  const byte first[] = "first entry";
+  const byte second[] = "second";
+  const byte third[] = "the third entry";
+
+  const byte *data = NULL;
+  uint32_t size = 0;
+
+  // a new cache is written out with an index when it's closed
+  {
+    ShaderCacheFile cache(filename, magic, 1);
+
+    CHECK(cache.GetEntryCount() == 0);
+    CHECK_FALSE(cache.Find(1, data, size));
+
+    cache.Add(0x1000000000000001ULL, first, sizeof(first));
+    cache.Add(2, second, sizeof(second));
+
+    REQUIRE(cache.Find(2, data, size));
+    CHECK(size == sizeof(second));
+    CHECK(memcmp(data, second, size) == 0);
+  }
+
+  // entries are read from the index, and new ones are appended
+  {
+    ShaderCacheFile cache(filename, magic, 1);
+
+    CHECK(cache.GetEntryCount() == 2);
+
+    REQUIRE(cache.Find(0x1000000000000001ULL, data, size));
+    CHECK(size == sizeof(first));
+    CHECK(memcmp(data, first, size) == 0);
+
+    // only the full 64-bit hash matches
+    CHECK_FALSE(cache.Find(1, data, size));
+
+    cache.Add(3, third, sizeof(third));
+  }
+
+  {
+    ShaderCacheFile cache(filename, magic, 1);
+
+    CHECK(cache.GetEntryCount() == 3);
+
+    REQUIRE(cache.Find(3, data, size));
+    CHECK(size == sizeof(third));
+    CHECK(memcmp(data, third, size) == 0);
+
+    REQUIRE(cache.Find(2, data, size));
+    CHECK(memcmp(data, second, size) == 0);
+  }
+
+  // a different version is thrown away
+  {
+    ShaderCacheFile cache(filename, magic, 2);
+
+    CHECK(cache.GetEntryCount() == 0);
+    CHECK_FALSE(cache.Find(2, data, size));
+  }
+
+  FileIO::Delete(filename.c_str());
+}
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
@@ -22,164 +22,159 @@
  * THE SOFTWARE.
  ******************************************************************************/
 
+
 #pragma once
 
+#include <map>
+#include "common/common.h"
 #include "os/os_specific.h"
 
-template <typename ResultType, typename ShaderCallbacks>
-bool LoadShaderCache(const char *filename, const uint32_t magicNumber, const uint32_t versionNumber,
-                     std::map<uint32_t, ResultType> &resultCache, const ShaderCallbacks &callbacks)
+// An on-disk cache of shader blobs keyed by 64-bit hash.
+//
+// The file is memory mapped when the cache is opened, and nothing else is read until an entry is
+// looked up by binary searching the sorted index, so opening a cache is cheap however large it has
+// grown. New entries are appended to the end of the file as they are added, and when too many have
+// accumulated outside the index the whole file is rewritten with a new index when the cache is
+// closed.
+//
+// The file consists of a header, then the data for each indexed entry, then the sorted index, then
+// any appended entries each with their own small header.
+class ShaderCacheFile
 {
-  string shadercache = FileIO::GetAppFolderFilename(filename);
+public:
+  ShaderCacheFile(const std::string &filename, uint32_t magicNumber, uint32_t versionNumber);
+  ~ShaderCacheFile();
 
-  FILE *f = FileIO::fopen(shadercache.c_str(), "rb");
+  // looks up an entry by hash. The returned data stays valid until the cache is destroyed.
+  bool Find(uint64_t hash, const byte *&data, uint32_t &size);
 
-  if(!f)
-    return false;
+  // adds a new entry, which is written to disk immediately. Entries that already exist aren't
+  // replaced.
+  void Add(uint64_t hash, const byte *data, uint32_t size);
 
-  FileIO::fseek64(f, 0, SEEK_END);
-  uint64_t cachelen = FileIO::ftell64(f);
-  FileIO::fseek64(f, 0, SEEK_SET);
+  // drop every entry, the file will be rewritten with only the entries added afterwards.
+  void Clear();
 
-  bool ret = true;
-
-  // header: magic number, file version, number of entries
-  if(cachelen < sizeof(uint32_t) * 3)
+  uint64_t GetEntryCount() const { return m_IndexCount + m_Appended.size() + m_Added.size(); }
+  // the approximate size of the cache on disk
+  uint64_t GetSize() const { return m_Size; }
+private:
+  struct Header
   {
-    RDCERR("Invalid shader cache");
-    ret = false;
-  }
-  else
+    uint32_t fileMagic;
+    uint32_t fileVersion;
+    uint32_t magicNumber;
+    uint32_t versionNumber;
+    uint64_t indexOffset;
+    uint64_t indexCount;
+  };
+
+  struct IndexEntry
   {
-    byte *cache = new byte[(size_t)cachelen];
-    FileIO::fread(cache, 1, (size_t)cachelen, f);
+    uint64_t hash;
+    uint64_t offset;
+    uint32_t size;
+    uint32_t padding;
+  };
 
-    uint32_t *header = (uint32_t *)cache;
+  static const uint32_t FileMagic = MAKE_FOURCC('R', 'D', 'S', 'C');
+  static const uint32_t FileVersion = 2;
 
-    uint32_t fileMagic = header[0];
-    uint32_t fileVer = header[1];
+  void Open();
+  void Compact();
 
-    if(fileMagic != magicNumber || fileVer != versionNumber)
-    {
-      RDCDEBUG("Out of date or invalid shader cache magic: %d version: %d", fileMagic, fileVer);
-      ret = false;
-    }
-    else
-    {
-      uint32_t numentries = header[2];
-
-      // assume at least 16 bytes for any cache entry. 8 bytes for hash and length, and 8 bytes
-      // data.
-      if(numentries > cachelen / 16LLU)
-      {
-        RDCERR("Invalid shader cache - more entries %u than are feasible in a %llu byte cache",
-               numentries, cachelen);
-        ret = false;
-      }
-      else
-      {
-        byte *ptr = cache + sizeof(uint32_t) * 3;
-
-        int64_t bufsize = (int64_t)cachelen - sizeof(uint32_t) * 3;
-
-        for(uint32_t i = 0; i < numentries; i++)
-        {
-          if((size_t)bufsize < sizeof(uint32_t))
-          {
-            RDCERR("Invalid shader cache - truncated, not enough data for shader hash");
-            ret = false;
-            break;
-          }
-
-          uint32_t hash = *(uint32_t *)ptr;
-          ptr += sizeof(uint32_t);
-          bufsize -= sizeof(uint32_t);
-
-          if((size_t)bufsize < sizeof(uint32_t))
-          {
-            RDCERR("Invalid shader cache - truncated, not enough data for shader length");
-            ret = false;
-            break;
-          }
-
-          uint32_t len = *(uint32_t *)ptr;
-          ptr += sizeof(uint32_t);
-          bufsize -= sizeof(uint32_t);
-
-          if(bufsize < len)
-          {
-            RDCERR("Invalid shader cache - truncated, not enough data for shader buffer");
-            ret = false;
-            break;
-          }
-
-          byte *data = ptr;
-          ptr += len;
-          bufsize -= len;
-
-          ResultType result;
-          bool created = callbacks.Create(len, data, &result);
-
-          if(!created)
-          {
-            RDCERR("Couldn't create blob of size %u from shadercache", len);
-            ret = false;
-            break;
-          }
-
-          resultCache[hash] = result;
-        }
-
-        if(ret == true && bufsize != 0)
-        {
-          RDCERR("Invalid shader cache - trailing data");
-          ret = false;
-        }
-
-        RDCDEBUG("Successfully loaded %d shaders from shader cache", resultCache.size());
-      }
-    }
+  std::string m_Filename;
+  uint32_t m_Magic, m_Version;
 
-    delete[] cache;
-  }
+  const byte *m_Mapped = NULL;
+  uint64_t m_MappedSize = 0;
 
-  FileIO::fclose(f);
+  const IndexEntry *m_Index = NULL;
+  uint64_t m_IndexCount = 0;
 
-  return ret;
-}
+  // entries appended to the mapped file after its index, which are looked up in here
+  std::map<uint64_t, IndexEntry> m_Appended;
 
-template <typename ResultType, typename ShaderCallbacks>
-void SaveShaderCache(const char *filename, uint32_t magicNumber, uint32_t versionNumber,
-                     const std::map<uint32_t, ResultType> &cache, const ShaderCallbacks &callbacks)
-{
-  string shadercache = FileIO::GetAppFolderFilename(filename);
+  // entries added since the file was opened, which aren't visible in the mapping
+  std::map<uint64_t, bytebuf> m_Added;
+
+  FILE *m_AppendFile = NULL;
 
-  FILE *f = FileIO::fopen(shadercache.c_str(), "wb");
+  uint64_t m_Size = 0;
 
-  if(!f)
+  // set if the file can't be appended to, and must be rewritten if anything is added
+  bool m_Rewrite = false;
+};
+
+// A cache of shader objects created from a ShaderCacheFile. Objects are only created from the file
+// data the first time they are looked up, and are owned by the cache.
+//
+// ShaderCallbacks needs to provide:
+//   bool Create(uint32_t size, const byte *data, ResultType *ret) const;
+//   void Destroy(ResultType blob) const;
+//   uint32_t GetSize(ResultType blob) const;
+//   const byte *GetData(ResultType blob) const;
+template <typename ResultType, typename ShaderCallbacks>
+class ShaderCache
+{
+public:
+  ShaderCache(const char *filename, uint32_t magicNumber, uint32_t versionNumber,
+              const ShaderCallbacks &callbacks)
+      : m_File(FileIO::GetAppFolderFilename(filename), magicNumber, versionNumber),
+        m_Callbacks(callbacks)
   {
-    RDCERR("Error opening shader cache for write");
-    return;
   }
 
-  FileIO::fwrite(&magicNumber, 1, sizeof(magicNumber), f);
-  FileIO::fwrite(&versionNumber, 1, sizeof(versionNumber), f);
-  uint32_t numentries = (uint32_t)cache.size();
-  FileIO::fwrite(&numentries, 1, sizeof(numentries), f);
+  ~ShaderCache()
+  {
+    for(auto it = m_Results.begin(); it != m_Results.end(); ++it)
+      m_Callbacks.Destroy(it->second);
+  }
 
-  for(auto it = cache.begin(); it != cache.end(); ++it)
+  bool Find(uint64_t hash, ResultType &result)
   {
-    uint32_t hash = it->first;
-    uint32_t len = callbacks.GetSize(it->second);
-    const byte *data = callbacks.GetData(it->second);
-    FileIO::fwrite(&hash, 1, sizeof(hash), f);
-    FileIO::fwrite(&len, 1, sizeof(len), f);
-    FileIO::fwrite(data, 1, len, f);
-
-    callbacks.Destroy(it->second);
+    auto it = m_Results.find(hash);
+    if(it != m_Results.end())
+    {
+      result = it->second;
+      return true;
+    }
+
+    const byte *data = NULL;
+    uint32_t size = 0;
+
+    if(!m_File.Find(hash, data, size))
+      return false;
+
+    if(!m_Callbacks.Create(size, data, &result))
+    {
+      RDCERR("Couldn't create blob of size %u from shader cache", size);
+      return false;
+    }
+
+    m_Results[hash] = result;
+    return true;
   }
 
-  FileIO::fclose(f);
+  // the cache takes ownership of the result
+  void Add(uint64_t hash, ResultType result)
+  {
+    auto it = m_Results.find(hash);
+    if(it != m_Results.end())
+    {
+      if(it->second == result)
+        return;
+
+      m_Callbacks.Destroy(it->second);
+    }
+
+    m_Results[hash] = result;
+
+    m_File.Add(hash, m_Callbacks.GetData(result), m_Callbacks.GetSize(result));
+  }
 
-  RDCDEBUG("Successfully wrote %u shaders to shader cache", numentries);
-}
+private:
+  ShaderCacheFile m_File;
+  const ShaderCallbacks &m_Callbacks;
+  std::map<uint64_t, ResultType> m_Results;
+};
@@ -25,10 +25,52 @@
 
 #pragma once
 
+#include <vector>
 #include "os/os_specific.h"
 
 namespace Threading
 {
+// calls func(i) for every i in [0, count), spread over up to one thread per logical core including
+// the calling thread, and returns once every call has finished. func must be safe to call
+// concurrently for different indices.
+inline void ParallelFor(uint32_t count, std::function<void(uint32_t)> func)
+{
+  uint32_t numThreads = GetLogicalCoreCount();
+  if(numThreads > count)
+    numThreads = count;
+
+  if(numThreads <= 1)
+  {
+    for(uint32_t i = 0; i < count; i++)
+      func(i);
+    return;
+  }
+
+  volatile int32_t next = 0;
+
+  auto worker = [&next, &func, count]() {
+    for(;;)
+    {
+      uint32_t i = uint32_t(Atomic::Inc32(&next) - 1);
+      if(i >= count)
+        break;
+      func(i);
+    }
+  };
+
+  std::vector<ThreadHandle> threads;
+  for(uint32_t t = 1; t < numThreads; t++)
+    threads.push_back(CreateThread(worker));
+
+  worker();
+
+  for(ThreadHandle t : threads)
+  {
+    JoinThread(t);
+    CloseThread(t);
+  }
+}
+
 class ScopedLock
 {
 public:
@@ -237,6 +237,8 @@ void RenderDoc::Initialise()
 
   Threading::Init();
 
+  Probes::Init();
+
   m_RemoteIdent = 0;
   m_RemoteThread = 0;
 
@@ -301,6 +303,19 @@ void RenderDoc::Initialise()
   RDCLOG("Packaged for %s (%s) - %s", DISTRIBUTION_NAME, DISTRIBUTION_VERSION, DISTRIBUTION_CONTACT);
 #endif
 
+  // record probes for the whole lifetime of the process, and write them out as a trace on shutdown
+  {
+    const char *probeTrace = Process::GetEnvVariable("RENDERDOC_PROBE_TRACE");
+
+    if(probeTrace && probeTrace[0])
+    {
+      m_ProbeTraceFilename = probeTrace;
+      Probes::SetEnabled(true);
+
+      RDCLOG("Recording probe trace to %s", probeTrace);
+    }
+  }
+
   Keyboard::Init();
 
   m_FrameTimer.InitTimers();
@@ -331,6 +346,14 @@ void RenderDoc::Initialise()
 
 RenderDoc::~RenderDoc()
 {
+  FlushCaptureWriting();
+
+  if(m_CaptureWriteThread)
+  {
+    Threading::CloseThread(m_CaptureWriteThread);
+    m_CaptureWriteThread = 0;
+  }
+
   if(m_ExHandler)
   {
     UnloadCrashHandler();
@@ -352,6 +375,9 @@ RenderDoc::~RenderDoc()
     }
   }
 
+  if(!m_ProbeTraceFilename.empty())
+    Probes::WriteChromeTrace(m_ProbeTraceFilename.c_str());
+
   RDCSTOPLOGGING(m_LoggingFilename.c_str());
 
   if(m_RemoteThread)
@@ -375,6 +401,8 @@ RenderDoc::~RenderDoc()
 
 void RenderDoc::Shutdown()
 {
+  FlushCaptureWriting();
+
   if(m_ExHandler)
   {
     UnloadCrashHandler();
@@ -538,6 +566,8 @@ void RenderDoc::Tick()
 
   m_FrameTimer.UpdateTimers();
 
+  UpdateFrameTelemetry();
+
   if(!prev_focus && cur_focus)
   {
     m_Cap = 0;
@@ -571,6 +601,107 @@ void RenderDoc::Tick()
   prev_cap = cur_cap;
 }
 
+// upper bounds in milliseconds of the frame time histogram buckets, the histogram has one extra
+// bucket for anything longer than the last bound.
+static const float FrameTimeBuckets[] = {
+    4.0f, 8.0f, 12.0f, 16.7f, 20.0f, 25.0f, 33.4f, 50.0f, 66.7f, 100.0f, 250.0f, 1000.0f,
+};
+
+void RenderDoc::SetFrameTelemetryEnabled(bool enabled)
+{
+  // start from a clean slate whether enabling or disabling
+  Atomic::Exch64(&m_CoherentMapBytes, 0);
+  Atomic::Exch64(&m_FrameOverheadTicks, 0);
+
+  SCOPED_LOCK(m_TelemetryLock);
+
+  m_TelemetryEnabled = enabled ? 1 : 0;
+
+  m_Telemetry = FrameTelemetryData();
+  m_Telemetry.frameTimeBuckets.assign(FrameTimeBuckets, ARRAY_COUNT(FrameTimeBuckets));
+  m_Telemetry.frameTimeHistogram.resize(ARRAY_COUNT(FrameTimeBuckets) + 1);
+  m_TelemetryTimer.Restart();
+}
+
+void RenderDoc::UpdateFrameTelemetry()
+{
+  // no-one has asked for telemetry, don't take the lock every frame
+  if(m_TelemetryEnabled == 0)
+    return;
+
+  double frameTime = m_FrameTimer.GetLastFrameTime();
+
+  // take the overhead accumulated over this frame, anything added concurrently on another thread
+  // counts towards the next frame.
+  int64_t overheadTicks = Atomic::Exch64(&m_FrameOverheadTicks, 0);
+
+  double overhead = double(overheadTicks) / Timing::GetTickFrequency();
+
+  SCOPED_LOCK(m_TelemetryLock);
+
+  // disabled while we were waiting for the lock
+  if(m_TelemetryEnabled == 0)
+    return;
+
+  if(m_Telemetry.frameCount == 0)
+  {
+    m_Telemetry.minFrameTime = m_Telemetry.maxFrameTime = frameTime;
+  }
+  else
+  {
+    m_Telemetry.minFrameTime = RDCMIN(m_Telemetry.minFrameTime, frameTime);
+    m_Telemetry.maxFrameTime = RDCMAX(m_Telemetry.maxFrameTime, frameTime);
+  }
+
+  m_Telemetry.frameCount++;
+  m_Telemetry.avgFrameTime += frameTime;
+  m_Telemetry.avgOverheadTime += overhead;
+  m_Telemetry.maxOverheadTime = RDCMAX(m_Telemetry.maxOverheadTime, overhead);
+
+  size_t bucket = 0;
+  while(bucket < ARRAY_COUNT(FrameTimeBuckets) && frameTime > FrameTimeBuckets[bucket])
+    bucket++;
+
+  m_Telemetry.frameTimeHistogram[bucket]++;
+}
+
+FrameTelemetryData RenderDoc::FetchFrameTelemetry()
+{
+  FrameTelemetryData ret;
+
+  {
+    SCOPED_LOCK(m_TelemetryLock);
+
+    ret = m_Telemetry;
+    ret.intervalTime = m_TelemetryTimer.GetMilliseconds();
+
+    // start the next interval, keeping the bucket layout
+    m_Telemetry.frameCount = 0;
+    m_Telemetry.avgFrameTime = m_Telemetry.minFrameTime = m_Telemetry.maxFrameTime = 0.0;
+    m_Telemetry.avgOverheadTime = m_Telemetry.maxOverheadTime = 0.0;
+    for(uint32_t &count : m_Telemetry.frameTimeHistogram)
+      count = 0;
+    m_TelemetryTimer.Restart();
+  }
+
+  // the averages are accumulated as totals until now
+  if(ret.frameCount > 0)
+  {
+    ret.avgFrameTime /= double(ret.frameCount);
+    ret.avgOverheadTime /= double(ret.frameCount);
+  }
+
+  ret.coherentMapBytes = (uint64_t)Atomic::Exch64(&m_CoherentMapBytes, 0);
+
+  ret.liveChunks = Chunk::NumLiveChunks();
+  ret.chunkMemory = Chunk::TotalMem();
+
+  if(Probes::IsEnabled())
+    ret.probes = Probes::GetStatistics();
+
+  return ret;
+}
+
 string RenderDoc::GetOverlayText(RDCDriver driver, uint32_t frameNumber, int flags)
 {
   const bool activeWindow = (flags & eOverlay_ActiveWindow);
@@ -707,10 +838,21 @@ RDCFile *RenderDoc::CreateRDC(RDCDriver driver, uint32_t frameNum, void *thpixel
   // make sure we don't stomp another capture if we make multiple captures in the same frame.
   {
     SCOPED_LOCK(m_CaptureLock);
+    SCOPED_LOCK(m_CaptureWriteLock);
+
+    // captures still being written in the background aren't in m_Captures yet
+    auto pathUsed = [this]() {
+      for(const CaptureData &o : m_Captures)
+        if(o.path == m_CurrentLogFile)
+          return true;
+      for(const PendingCaptureWrite &o : m_PendingCaptureWrites)
+        if(o.path == m_CurrentLogFile)
+          return true;
+      return false;
+    };
+
     int altnum = 2;
-    while(std::find_if(m_Captures.begin(), m_Captures.end(), [this](const CaptureData &o) {
-            return o.path == m_CurrentLogFile;
-          }) != m_Captures.end())
+    while(pathUsed())
     {
       m_CurrentLogFile =
           StringFormat::Fmt("%s_frame%u_%d.rdc", m_CaptureFileTemplate.c_str(), frameNum, altnum);
@@ -1059,6 +1201,11 @@ void RenderDoc::SetCaptureFileTemplate(const char *pathtemplate)
 }
 
 void RenderDoc::FinishCaptureWriting(RDCFile *rdc, uint32_t frameNumber)
+{
+  CompleteCaptureFile(rdc, frameNumber, m_CurrentLogFile);
+}
+
+void RenderDoc::CompleteCaptureFile(RDCFile *rdc, uint32_t frameNumber, const string &path)
 {
   RenderDoc::Inst().SetProgress(CaptureProgress::FileWriting, 0.0f);
 
@@ -1087,9 +1234,9 @@ void RenderDoc::FinishCaptureWriting(RDCFile *rdc, uint32_t frameNumber)
 
     delete rdc;
 
-    RDCLOG("Written to disk: %s", m_CurrentLogFile.c_str());
+    RDCLOG("Written to disk: %s", path.c_str());
 
-    CaptureData cap(m_CurrentLogFile, Timing::GetUnixTimestamp(), frameNumber);
+    CaptureData cap(path, Timing::GetUnixTimestamp(), frameNumber);
     {
       SCOPED_LOCK(m_CaptureLock);
       m_Captures.push_back(cap);
@@ -1099,6 +1246,126 @@ void RenderDoc::FinishCaptureWriting(RDCFile *rdc, uint32_t frameNumber)
   RenderDoc::Inst().SetProgress(CaptureProgress::FileWriting, 1.0f);
 }
 
+// how much serialised capture data can be waiting to be written in the background before a new
+// capture has to wait for earlier ones to finish.
+static const uint64_t CaptureWriteMemoryBudget = 512 * 1024 * 1024;
+
+void RenderDoc::QueueCaptureWriting(RDCFile *rdc, uint32_t frameNumber,
+                                    const SectionProperties &props,
+                                    MemoryBlockCompressor *frameData, BlobStore *blobs)
+{
+  if(!rdc)
+  {
+    SAFE_DELETE(frameData);
+    SAFE_DELETE(blobs);
+    return;
+  }
+
+  const uint64_t size = frameData->GetSize() + (blobs ? blobs->GetStoredSize() : 0);
+
+  PendingCaptureWrite write = {rdc, frameNumber, m_CurrentLogFile, props, frameData, blobs, size};
+
+  PerformanceTimer timer;
+
+  {
+    SCOPED_LOCK(m_CaptureWriteLock);
+
+    // a capture larger than the budget is still allowed through on its own, since it's already
+    // in memory - we just don't let anything else pile up behind it.
+    while(m_PendingCaptureWriteBytes > 0 &&
+          m_PendingCaptureWriteBytes + size > CaptureWriteMemoryBudget)
+      m_CaptureWriteDone.Wait(m_CaptureWriteLock);
+
+    m_PendingCaptureWrites.push_back(write);
+    m_PendingCaptureWriteBytes += size;
+
+    if(!m_CaptureWriteThreadRunning)
+    {
+      // the previous thread, if any, has already finished with the queue
+      if(m_CaptureWriteThread)
+      {
+        Threading::JoinThread(m_CaptureWriteThread);
+        Threading::CloseThread(m_CaptureWriteThread);
+      }
+
+      m_CaptureWriteThreadRunning = true;
+      m_CaptureWriteThread = Threading::CreateThread([this]() { CaptureWriteThread(); });
+    }
+  }
+
+  RDCLOG("Queued %.2f MB of capture data for writing, waited %.2f ms for earlier captures",
+         double(size) / (1024.0 * 1024.0), timer.GetMilliseconds());
+}
+
+void RenderDoc::FlushCaptureWriting()
+{
+  SCOPED_LOCK(m_CaptureWriteLock);
+
+  // the thread only stops once the queue is empty, including anything queued while we wait. It's
+  // never joined here: the thread may still be exiting, and on windows this can even be called from
+  // it while it releases the module. The handle is only ever joined by QueueCaptureWriting before
+  // it starts a new thread.
+  while(m_CaptureWriteThreadRunning)
+    m_CaptureWriteDone.Wait(m_CaptureWriteLock);
+}
+
+void RenderDoc::CaptureWriteThread()
+{
+  Threading::KeepModuleAlive();
+
+  for(;;)
+  {
+    PendingCaptureWrite write;
+
+    {
+      SCOPED_LOCK(m_CaptureWriteLock);
+
+      if(m_PendingCaptureWrites.empty())
+      {
+        m_CaptureWriteThreadRunning = false;
+        m_CaptureWriteDone.NotifyAll();
+        break;
+      }
+
+      // leave it in the queue until it's finished, so its path stays reserved
+      write = m_PendingCaptureWrites.front();
+    }
+
+    PerformanceTimer timer;
+
+    StreamWriter *writer = write.rdc->WriteSection(write.props);
+
+    write.frameData->WriteTo(writer);
+    writer->Finish();
+
+    if(writer->IsErrored())
+      RDCERR("Error writing frame capture to %s", write.path.c_str());
+
+    delete writer;
+
+    // deduplicated buffers referenced from the frame capture go in their own section
+    if(write.blobs && !write.blobs->WriteSection(write.rdc))
+      RDCERR("Error writing content blobs to %s", write.path.c_str());
+
+    CompleteCaptureFile(write.rdc, write.frameNumber, write.path);
+
+    RDCLOG("Wrote %.2f MB frame capture in background in %.2f ms",
+           double(write.size) / (1024.0 * 1024.0), timer.GetMilliseconds());
+
+    {
+      SCOPED_LOCK(m_CaptureWriteLock);
+      m_PendingCaptureWrites.erase(m_PendingCaptureWrites.begin());
+      m_PendingCaptureWriteBytes -= write.size;
+      m_CaptureWriteDone.NotifyAll();
+    }
+
+    delete write.frameData;
+    delete write.blobs;
+  }
+
+  Threading::ReleaseModuleExitThread();
+}
+
 void RenderDoc::AddDeviceFrameCapturer(void *dev, IFrameCapturer *cap)
 {
   if(dev == NULL || cap == NULL)
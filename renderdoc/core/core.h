@@ -33,6 +33,7 @@
 #include <vector>
 #include "api/app/renderdoc_app.h"
 #include "api/replay/renderdoc_replay.h"
+#include "common/probes.h"
 #include "common/threading.h"
 #include "common/timing.h"
 #include "maths/vec.h"
@@ -310,6 +311,8 @@ class IRemoteDriver;
 class IReplayDriver;
 
 class StreamReader;
+class MemoryBlockCompressor;
+class BlobStore;
 class RDCFile;
 
 typedef ReplayStatus (*RemoteDriverProvider)(RDCFile *rdc, IRemoteDriver **driver);
@@ -341,13 +344,19 @@ public:
   template <typename ProgressType>
   void SetProgressCallback(RENDERDOC_ProgressCallback progress)
   {
+    SCOPED_LOCK(m_ProgressLock);
     m_ProgressCallbacks[TypeName<ProgressType>()] = progress;
   }
 
+  // can be called from the background capture writing thread as well as the capturing thread
   template <typename ProgressType>
   void SetProgress(ProgressType section, float delta)
   {
-    RENDERDOC_ProgressCallback cb = m_ProgressCallbacks[TypeName<ProgressType>()];
+    RENDERDOC_ProgressCallback cb;
+    {
+      SCOPED_LOCK(m_ProgressLock);
+      cb = m_ProgressCallbacks[TypeName<ProgressType>()];
+    }
     if(!cb || section < ProgressType::First || section >= ProgressType::Count)
       return;
 
@@ -397,6 +406,14 @@ public:
                      uint16_t thwidth, uint16_t thheight);
   void FinishCaptureWriting(RDCFile *rdc, uint32_t frameNumber);
 
+  // hands off a frame capture that has been serialised into memory, to be compressed and written
+  // into its section of the RDC on a background thread. Takes ownership of rdc, frameData and
+  // blobs. If blobs is non-NULL, it's written into its own section after the frame capture.
+  void QueueCaptureWriting(RDCFile *rdc, uint32_t frameNumber, const SectionProperties &props,
+                           MemoryBlockCompressor *frameData, BlobStore *blobs);
+  // wait for any captures queued above to finish writing
+  void FlushCaptureWriting();
+
   void AddChildProcess(uint32_t pid, uint32_t ident)
   {
     SCOPED_LOCK(m_ChildLock);
@@ -483,6 +500,19 @@ public:
 
   void Tick();
 
+  // per-frame statistics that are periodically sent to target control clients that have asked for
+  // telemetry. These are safe to call from any thread.
+  void AddFrameOverhead(uint64_t ticks)
+  {
+    Atomic::ExchAdd64(&m_FrameOverheadTicks, (int64_t)ticks);
+  }
+  void AddCoherentMapBytes(uint64_t bytes)
+  {
+    Atomic::ExchAdd64(&m_CoherentMapBytes, (int64_t)bytes);
+  }
+  void SetFrameTelemetryEnabled(bool enabled);
+  FrameTelemetryData FetchFrameTelemetry();
+
   void AddFrameCapturer(void *dev, void *wnd, IFrameCapturer *cap);
   void RemoveFrameCapturer(void *dev, void *wnd);
 
@@ -555,7 +585,17 @@ private:
 
   FrameTimer m_FrameTimer;
 
+  void UpdateFrameTelemetry();
+
+  Threading::CriticalSection m_TelemetryLock;
+  FrameTelemetryData m_Telemetry;
+  PerformanceTimer m_TelemetryTimer;
+  volatile int64_t m_FrameOverheadTicks = 0;
+  volatile int64_t m_CoherentMapBytes = 0;
+  volatile int32_t m_TelemetryEnabled = 0;
+
   string m_LoggingFilename;
+  string m_ProbeTraceFilename;
 
   string m_Target;
   string m_CaptureFileTemplate;
@@ -572,11 +612,34 @@ private:
   Threading::CriticalSection m_DriverLock;
   std::map<RDCDriver, uint64_t> m_ActiveDrivers;
 
+  Threading::CriticalSection m_ProgressLock;
   std::map<std::string, RENDERDOC_ProgressCallback> m_ProgressCallbacks;
 
   Threading::CriticalSection m_CaptureLock;
   vector<CaptureData> m_Captures;
 
+  struct PendingCaptureWrite
+  {
+    RDCFile *rdc;
+    uint32_t frameNumber;
+    string path;
+    SectionProperties props;
+    MemoryBlockCompressor *frameData;
+    BlobStore *blobs;
+    uint64_t size;
+  };
+
+  Threading::CriticalSection m_CaptureWriteLock;
+  // signalled by the writer thread each time a queued capture finishes writing, and when it stops
+  Threading::Condition m_CaptureWriteDone;
+  vector<PendingCaptureWrite> m_PendingCaptureWrites;
+  uint64_t m_PendingCaptureWriteBytes = 0;
+  bool m_CaptureWriteThreadRunning = false;
+  Threading::ThreadHandle m_CaptureWriteThread = 0;
+
+  void CaptureWriteThread();
+  void CompleteCaptureFile(RDCFile *rdc, uint32_t frameNumber, const string &path);
+
   Threading::CriticalSection m_ChildLock;
   vector<pair<uint32_t, uint32_t> > m_Children;
 
@@ -655,6 +718,20 @@ private:
   ICrashHandler *m_ExHandler;
 };
 
+// accumulates the time spent in a scope into the current frame's overhead for telemetry. This
+// should wrap RenderDoc's own processing in a hooked function but not the call through to the real
+// API, so that only the cost added by the injected layer is counted.
+class ScopedFrameOverhead
+{
+public:
+  ScopedFrameOverhead() : m_Start(Timing::GetTick()) {}
+  ~ScopedFrameOverhead() { RenderDoc::Inst().AddFrameOverhead(Timing::GetTick() - m_Start); }
+private:
+  uint64_t m_Start;
+};
+
+#define SCOPED_FRAME_OVERHEAD() ScopedFrameOverhead CONCAT(frameOverhead, __LINE__);
+
 struct DriverRegistration
 {
   DriverRegistration(RDCDriver driver, ReplayDriverProvider provider)
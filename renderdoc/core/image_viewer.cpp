@@ -175,6 +175,7 @@ public:
   void ReplayLog(uint32_t endEventID, ReplayLogType replayType) {}
   vector<uint32_t> GetPassEvents(uint32_t eventId) { return vector<uint32_t>(); }
   vector<EventUsage> GetUsage(ResourceId id) { return vector<EventUsage>(); }
+  ResourceUsageIndex GetUsageIndex() { return ResourceUsageIndex(); }
   bool IsRenderOutput(ResourceId id) { return false; }
   ResourceId GetLiveID(ResourceId id) { return id; }
   vector<GPUCounter> EnumerateCounters() { return vector<GPUCounter>(); }
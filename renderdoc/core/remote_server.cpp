@@ -23,8 +23,11 @@
  * THE SOFTWARE.
  ******************************************************************************/
 
+#include <algorithm>
 #include <sstream>
 #include <utility>
+#include "3rdparty/lz4/lz4.h"
+#include "3rdparty/zstd/xxhash.h"
 #include "android/android.h"
 #include "api/replay/renderdoc_replay.h"
 #include "core/core.h"
@@ -35,7 +38,7 @@
 #include "strings/string_utils.h"
 #include "replay_proxy.h"
 
-static const uint32_t RemoteServerProtocolVersion = 3;
+static const uint32_t RemoteServerProtocolVersion = 5;
 
 enum RemoteServerPacket
 {
@@ -67,6 +70,10 @@ enum RemoteServerPacket
   eRemoteServer_GetSectionProperties,
   eRemoteServer_GetSectionContents,
   eRemoteServer_WriteSection,
+  eRemoteServer_FileBlocksBegin,
+  eRemoteServer_FileBlock,
+  eRemoteServer_FileBlocksEnd,
+  eRemoteServer_FileReceived,
   eRemoteServer_RemoteServerCount,
 };
 
@@ -76,6 +83,305 @@ RDCCOMPILE_ASSERT((int)eRemoteServer_RemoteServerCount < (int)eReplayProxy_First
 #define WRITE_DATA_SCOPE() WriteSerialiser &ser = writer;
 #define READ_DATA_SCOPE() ReadSerialiser &ser = reader;
 
+// Captures are copied in fixed size blocks, each one hashed so that the receiver can verify it. The
+// receiver starts by sending the hashes of the whole blocks it already has (from an earlier copy
+// that was interrupted), and the sender skips past every leading block that matches. Blocks that
+// compress well (e.g. uncompressed sections) are sent LZ4 compressed.
+static const uint64_t FileBlockSize = 1024 * 1024;
+
+// how many times a copy is restarted from the last good block if a block fails to verify
+static const int MaxCopyAttempts = 3;
+
+static uint64_t GetFileSize(FILE *f)
+{
+  FileIO::fseek64(f, 0, SEEK_END);
+  return FileIO::ftell64(f);
+}
+
+// hashes every whole block in the file. A trailing partial block is always re-sent.
+static std::vector<uint64_t> HashFileBlocks(FILE *f)
+{
+  std::vector<uint64_t> ret;
+
+  uint64_t size = GetFileSize(f);
+
+  bytebuf block;
+  block.resize((size_t)FileBlockSize);
+
+  FileIO::fseek64(f, 0, SEEK_SET);
+
+  for(uint64_t offset = 0; offset + FileBlockSize <= size; offset += FileBlockSize)
+  {
+    if(FileIO::fread(block.data(), 1, block.size(), f) != block.size())
+      break;
+
+    ret.push_back(XXH64(block.data(), block.size(), 0));
+  }
+
+  return ret;
+}
+
+// returns the offset of the first block that doesn't match what the receiver already has
+static uint64_t FindResumeOffset(FILE *f, uint64_t size, const std::vector<uint64_t> &hashes)
+{
+  bytebuf block;
+  block.resize((size_t)FileBlockSize);
+
+  FileIO::fseek64(f, 0, SEEK_SET);
+
+  uint64_t offset = 0;
+
+  for(uint64_t hash : hashes)
+  {
+    if(offset + FileBlockSize > size)
+      break;
+
+    if(FileIO::fread(block.data(), 1, block.size(), f) != block.size() ||
+       XXH64(block.data(), block.size(), 0) != hash)
+      break;
+
+    offset += FileBlockSize;
+  }
+
+  return offset;
+}
+
+static void SendFileBlocks(WriteSerialiser &ser, FILE *f, uint64_t offset, uint64_t size,
+                           RENDERDOC_ProgressCallback progress)
+{
+  {
+    SCOPED_SERIALISE_CHUNK(eRemoteServer_FileBlocksBegin);
+    SERIALISE_ELEMENT(offset);
+    SERIALISE_ELEMENT(size);
+  }
+
+  if(offset > 0)
+    RDCLOG("Resuming copy at %llu of %llu bytes", offset, size);
+
+  bytebuf raw, packed;
+
+  if(f)
+    FileIO::fseek64(f, offset, SEEK_SET);
+
+  while(f && offset < size && !ser.IsErrored())
+  {
+    uint64_t length = RDCMIN(FileBlockSize, size - offset);
+
+    raw.resize((size_t)length);
+    if(FileIO::fread(raw.data(), 1, raw.size(), f) != raw.size())
+    {
+      RDCERR("Error reading file at offset %llu", offset);
+      break;
+    }
+
+    uint64_t hash = XXH64(raw.data(), raw.size(), 0);
+
+    // most of a capture is already compressed, so only keep the compressed block if it's a real
+    // saving.
+    packed.resize((size_t)LZ4_compressBound((int)length));
+    int packedSize = LZ4_compress_default((const char *)raw.data(), (char *)packed.data(),
+                                          (int)length, (int)packed.size());
+
+    bool lz4 = packedSize > 0 && uint64_t(packedSize) < length - length / 8;
+
+    if(lz4)
+      packed.resize((size_t)packedSize);
+
+    bytebuf &data = lz4 ? packed : raw;
+
+    {
+      SCOPED_SERIALISE_CHUNK(eRemoteServer_FileBlock);
+      SERIALISE_ELEMENT(offset);
+      SERIALISE_ELEMENT(length);
+      SERIALISE_ELEMENT(hash);
+      SERIALISE_ELEMENT(lz4);
+      SERIALISE_ELEMENT(data);
+    }
+
+    offset += length;
+
+    if(progress)
+      progress(float(offset) / float(size));
+  }
+
+  SCOPED_SERIALISE_CHUNK(eRemoteServer_FileBlocksEnd);
+}
+
+// receives blocks from SendFileBlocks and writes them to f, which already holds 'verified' bytes of
+// whole blocks. Returns true if the whole file was received. Otherwise 'received' is how much of
+// the file is valid - anything after the first block that fails to verify is read and discarded to
+// keep the stream in sync, so the copy can be resumed. If f is NULL all blocks are discarded.
+static bool ReceiveFileBlocks(ReadSerialiser &ser, FILE *f, uint64_t verified, uint64_t &received,
+                              uint64_t &size, RENDERDOC_ProgressCallback progress)
+{
+  uint64_t goodOffset = 0;
+  bool failed = (f == NULL);
+
+  received = size = 0;
+
+  {
+    RemoteServerPacket type = ser.ReadChunk<RemoteServerPacket>();
+
+    if(type != eRemoteServer_FileBlocksBegin)
+    {
+      RDCERR("Unexpected packet %d at start of file copy", type);
+      ser.EndChunk();
+      return false;
+    }
+
+    uint64_t offset = 0;
+    SERIALISE_ELEMENT(offset);
+    SERIALISE_ELEMENT(size);
+
+    ser.EndChunk();
+
+    if(offset > verified || offset % FileBlockSize != 0 || offset > size)
+    {
+      RDCERR("Invalid resume offset %llu with %llu bytes verified", offset, verified);
+      failed = true;
+    }
+    else
+    {
+      goodOffset = offset;
+    }
+  }
+
+  if(f)
+    FileIO::fseek64(f, goodOffset, SEEK_SET);
+
+  bytebuf raw;
+
+  while(!ser.IsErrored())
+  {
+    RemoteServerPacket type = ser.ReadChunk<RemoteServerPacket>();
+
+    if(type == eRemoteServer_FileBlocksEnd)
+    {
+      ser.EndChunk();
+      break;
+    }
+
+    if(type != eRemoteServer_FileBlock)
+    {
+      RDCERR("Unexpected packet %d during file copy", type);
+      ser.EndChunk();
+      failed = true;
+      break;
+    }
+
+    uint64_t offset = 0, length = 0, hash = 0;
+    bool lz4 = false;
+    bytebuf data;
+
+    SERIALISE_ELEMENT(offset);
+    SERIALISE_ELEMENT(length);
+    SERIALISE_ELEMENT(hash);
+    SERIALISE_ELEMENT(lz4);
+    SERIALISE_ELEMENT(data);
+
+    ser.EndChunk();
+
+    if(failed)
+      continue;
+
+    const byte *block = NULL;
+
+    if(offset == goodOffset && length <= FileBlockSize && offset + length <= size)
+    {
+      if(lz4)
+      {
+        raw.resize((size_t)length);
+        int decompSize = LZ4_decompress_safe((const char *)data.data(), (char *)raw.data(),
+                                             (int)data.size(), (int)length);
+
+        if(decompSize == (int)length)
+          block = raw.data();
+      }
+      else if(data.size() == length)
+      {
+        block = data.data();
+      }
+    }
+
+    if(block == NULL || XXH64(block, (size_t)length, 0) != hash)
+    {
+      RDCWARN("Block at offset %llu failed to verify", offset);
+      failed = true;
+      continue;
+    }
+
+    if(FileIO::fwrite(block, 1, (size_t)length, f) != length)
+    {
+      RDCERR("Error writing file at offset %llu", offset);
+      failed = true;
+      continue;
+    }
+
+    goodOffset += length;
+
+    if(progress)
+      progress(float(goodOffset) / float(size));
+  }
+
+  // drop anything left over past the verified data, from a previous copy or a failed block
+  if(f)
+    FileIO::ftruncateat(f, goodOffset);
+
+  received = goodOffset;
+
+  return !failed && !ser.IsErrored() && goodOffset == size;
+}
+
+// partial copies older than this are assumed to be abandoned and are deleted when the server starts
+static const uint64_t MaxResumeFileAge = 24 * 60 * 60;
+
+// the local path for a copy to the server, named after its key so that an interrupted copy of the
+// same capture finds what was already received and can resume.
+static std::string GetResumableFilePath(uint64_t key)
+{
+  std::string path;
+  std::string dummy, dummy2;
+  FileIO::GetDefaultFiles("remotecopy", path, dummy, dummy2);
+  return dirname(path) + StringFormat::Fmt("/remotecopy_%016llx.rdc", key);
+}
+
+// opens a file for resuming a copy into, creating it if it doesn't exist
+static FILE *OpenResumableFile(const char *path)
+{
+  FILE *f = FileIO::fopen(path, "r+b");
+
+  if(f == NULL)
+    f = FileIO::fopen(path, "w+b");
+
+  return f;
+}
+
+// deletes left-over partial copies, either all of them or only those older than MaxResumeFileAge.
+// Must only be called while no client is receiving a copy.
+static void DeleteResumableFiles(bool all)
+{
+  std::string dir = dirname(GetResumableFilePath(0));
+  uint64_t now = Timing::GetUnixTimestamp();
+
+  for(const PathEntry &entry : FileIO::GetFilesInDirectory(dir.c_str()))
+  {
+    std::string filename = entry.filename;
+
+    if(entry.flags & PathProperty::Directory)
+      continue;
+
+    if(filename.find("remotecopy_") != 0 || filename.size() != strlen("remotecopy_") + 16 + 4 ||
+       filename.substr(filename.size() - 4) != ".rdc")
+      continue;
+
+    if(!all && entry.lastmod + MaxResumeFileAge > now)
+      continue;
+
+    RDCLOG("Deleting partial copy '%s'", filename.c_str());
+    FileIO::Delete((dir + "/" + filename).c_str());
+  }
+}
+
 struct ClientThread
 {
   ClientThread()
@@ -291,58 +597,92 @@ static void ActiveRemoteClientThread(ClientThread *threadData,
     else if(type == eRemoteServer_CopyCaptureFromRemote)
     {
       std::string path;
+      std::vector<uint64_t> hashes;
 
       {
         READ_DATA_SCOPE();
         SERIALISE_ELEMENT(path);
+        SERIALISE_ELEMENT(hashes);
       }
 
       reader.EndChunk();
 
-      {
-        WRITE_DATA_SCOPE();
-        SCOPED_SERIALISE_CHUNK(eRemoteServer_CopyCaptureFromRemote);
+      FILE *f = FileIO::fopen(path.c_str(), "rb");
 
-        StreamReader fileStream(FileIO::fopen(path.c_str(), "rb"));
-        ser.SerialiseStream(path, fileStream);
-      }
+      if(f == NULL)
+        RDCERR("Couldn't open '%s' to copy from", path.c_str());
+
+      uint64_t size = f ? GetFileSize(f) : 0;
+      uint64_t offset = f ? FindResumeOffset(f, size, hashes) : 0;
+
+      SendFileBlocks(writer, f, offset, size, RENDERDOC_ProgressCallback());
+
+      if(f)
+        FileIO::fclose(f);
     }
     else if(type == eRemoteServer_CopyCaptureToRemote)
     {
-      std::string path;
-      std::string dummy, dummy2;
-      FileIO::GetDefaultFiles("remotecopy", path, dummy, dummy2);
+      uint64_t key = 0;
+
+      {
+        READ_DATA_SCOPE();
+        SERIALISE_ELEMENT(key);
+      }
+
+      reader.EndChunk();
+
+      std::string path = GetResumableFilePath(key);
 
       RDCLOG("Copying file to local path '%s'.", path.c_str());
 
       FileIO::CreateParentDirectory(path);
 
-      {
-        READ_DATA_SCOPE();
+      FILE *f = OpenResumableFile(path.c_str());
+
+      if(f == NULL)
+        RDCERR("Couldn't open '%s' to copy into", path.c_str());
 
-        StreamWriter streamWriter(FileIO::fopen(path.c_str(), "wb"), Ownership::Stream);
+      std::vector<uint64_t> hashes;
+      if(f)
+        hashes = HashFileBlocks(f);
 
-        ser.SerialiseStream(path.c_str(), streamWriter, NULL);
+      {
+        WRITE_DATA_SCOPE();
+        SCOPED_SERIALISE_CHUNK(eRemoteServer_CopyCaptureToRemote);
+        SERIALISE_ELEMENT(hashes);
       }
 
-      reader.EndChunk();
+      uint64_t received = 0, size = 0;
+      bool complete = ReceiveFileBlocks(reader, f, hashes.size() * FileBlockSize, received, size,
+                                        RENDERDOC_ProgressCallback());
+
+      if(f)
+        FileIO::fclose(f);
 
+      // a partial file is left behind on error so the copy can be resumed on a new connection
       if(reader.IsErrored())
       {
-        FileIO::Delete(path.c_str());
-
         RDCERR("Network error receiving file");
         break;
       }
 
-      RDCLOG("File received.");
+      if(complete)
+      {
+        RDCLOG("File received.");
 
-      tempFiles.push_back(path);
+        if(std::find(tempFiles.begin(), tempFiles.end(), path) == tempFiles.end())
+          tempFiles.push_back(path);
+      }
+      else
+      {
+        path.clear();
+      }
 
       {
         WRITE_DATA_SCOPE();
-        SCOPED_SERIALISE_CHUNK(eRemoteServer_CopyCaptureToRemote);
+        SCOPED_SERIALISE_CHUNK(eRemoteServer_FileReceived);
         SERIALISE_ELEMENT(path);
+        SERIALISE_ELEMENT(received);
       }
     }
     else if(type == eRemoteServer_TakeOwnershipCapture)
@@ -807,6 +1147,9 @@ void RenderDoc::BecomeRemoteServer(const char *listenhost, uint16_t port,
   if(sock == NULL)
     return;
 
+  // a server that exited uncleanly can't have cleaned up its partial copies
+  DeleteResumableFiles(false);
+
   std::vector<std::pair<uint32_t, uint32_t> > listenRanges;
   bool allowExecution = true;
 
@@ -1007,6 +1350,9 @@ void RenderDoc::BecomeRemoteServer(const char *listenhost, uint16_t port,
     delete inactives[i];
   }
 
+  // nothing can resume a partial copy once the server has gone
+  DeleteResumableFiles(true);
+
   SAFE_DELETE(sock);
 }
 
@@ -1294,67 +1640,134 @@ public:
   void CopyCaptureFromRemote(const char *remotepath, const char *localpath,
                              RENDERDOC_ProgressCallback progress)
   {
-    std::string path = remotepath;
+    // the data is received into a side file which is only moved into place when complete. If the
+    // copy is interrupted, the next copy to the same path will resume from it.
+    std::string partialpath = std::string(localpath) + ".partial";
 
+    for(int attempt = 0; attempt < MaxCopyAttempts; attempt++)
     {
-      WRITE_DATA_SCOPE();
-      SCOPED_SERIALISE_CHUNK(eRemoteServer_CopyCaptureFromRemote);
-      SERIALISE_ELEMENT(path);
-    }
+      FILE *f = OpenResumableFile(partialpath.c_str());
 
-    {
-      READ_DATA_SCOPE();
-      RemoteServerPacket type = ser.ReadChunk<RemoteServerPacket>();
+      if(f == NULL)
+      {
+        RDCERR("Couldn't open '%s' to copy into", partialpath.c_str());
+        return;
+      }
+
+      std::string path = remotepath;
+      std::vector<uint64_t> hashes = HashFileBlocks(f);
 
-      if(type == eRemoteServer_CopyCaptureFromRemote)
       {
-        StreamWriter streamWriter(FileIO::fopen(localpath, "wb"), Ownership::Stream);
+        WRITE_DATA_SCOPE();
+        SCOPED_SERIALISE_CHUNK(eRemoteServer_CopyCaptureFromRemote);
+        SERIALISE_ELEMENT(path);
+        SERIALISE_ELEMENT(hashes);
+      }
 
-        ser.SerialiseStream(localpath, streamWriter, progress);
+      uint64_t received = 0, size = 0;
+      bool complete =
+          ReceiveFileBlocks(reader, f, hashes.size() * FileBlockSize, received, size, progress);
 
-        if(ser.IsErrored())
-        {
-          RDCERR("Network error receiving file");
-          return;
-        }
+      FileIO::fclose(f);
+
+      if(reader.IsErrored())
+      {
+        RDCERR("Network error receiving file");
+        return;
       }
-      else
+
+      if(complete)
       {
-        RDCERR("Unexpected response to capture copy request");
+        FileIO::Move(partialpath.c_str(), localpath, true);
+        return;
       }
 
-      ser.EndChunk();
+      RDCWARN("Copy stopped at %llu of %llu bytes, retrying", received, size);
     }
+
+    RDCERR("Couldn't copy '%s' after %d attempts", remotepath, MaxCopyAttempts);
   }
 
   rdcstr CopyCaptureToRemote(const char *filename, RENDERDOC_ProgressCallback progress)
   {
-    {
-      WRITE_DATA_SCOPE();
-      SCOPED_SERIALISE_CHUNK(eRemoteServer_CopyCaptureToRemote);
+    FILE *f = FileIO::fopen(filename, "rb");
 
-      StreamReader fileStream(FileIO::fopen(filename, "rb"));
-      ser.SerialiseStream(filename, fileStream, progress);
+    if(f == NULL)
+    {
+      RDCERR("Couldn't open '%s' to copy from", filename);
+      return "";
     }
 
+    uint64_t size = GetFileSize(f);
+
+    // identifies this file to the server, so a copy that was interrupted can resume where it left
+    // off. The block hashes are still checked, so a false match only costs a full copy.
+    uint64_t key =
+        XXH64(filename, strlen(filename), size ^ FileIO::GetModifiedTimestamp(filename));
+
     std::string path;
 
+    for(int attempt = 0; attempt < MaxCopyAttempts; attempt++)
     {
-      READ_DATA_SCOPE();
-      RemoteServerPacket type = ser.ReadChunk<RemoteServerPacket>();
+      std::vector<uint64_t> hashes;
 
-      if(type == eRemoteServer_CopyCaptureToRemote)
       {
-        SERIALISE_ELEMENT(path);
+        WRITE_DATA_SCOPE();
+        SCOPED_SERIALISE_CHUNK(eRemoteServer_CopyCaptureToRemote);
+        SERIALISE_ELEMENT(key);
       }
-      else
+
       {
-        RDCERR("Unexpected response to capture copy request");
+        READ_DATA_SCOPE();
+        RemoteServerPacket type = ser.ReadChunk<RemoteServerPacket>();
+
+        if(type == eRemoteServer_CopyCaptureToRemote)
+        {
+          SERIALISE_ELEMENT(hashes);
+        }
+        else
+        {
+          RDCERR("Unexpected response to capture copy request");
+        }
+
+        ser.EndChunk();
+
+        if(ser.IsErrored() || type != eRemoteServer_CopyCaptureToRemote)
+          break;
       }
 
-      ser.EndChunk();
+      SendFileBlocks(writer, f, FindResumeOffset(f, size, hashes), size, progress);
+
+      uint64_t received = 0;
+
+      {
+        READ_DATA_SCOPE();
+        RemoteServerPacket type = ser.ReadChunk<RemoteServerPacket>();
+
+        if(type == eRemoteServer_FileReceived)
+        {
+          SERIALISE_ELEMENT(path);
+          SERIALISE_ELEMENT(received);
+        }
+        else
+        {
+          RDCERR("Unexpected response to capture copy");
+        }
+
+        ser.EndChunk();
+
+        if(ser.IsErrored() || type != eRemoteServer_FileReceived)
+          break;
+      }
+
+      if(!path.empty())
+        break;
+
+      RDCWARN("Copy stopped at %llu of %llu bytes, retrying", received, size);
     }
 
+    FileIO::fclose(f);
+
     return path;
   }
 
@@ -1880,3 +2293,121 @@ RENDERDOC_CreateRemoteServerConnection(const char *host, uint32_t port, IRemoteS
 
   return ReplayStatus::Succeeded;
 }
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#include "3rdparty/catch/catch.hpp"
+
+TEST_CASE("Copy captures through a loopback remote server", "[remote]")
+{
+  const uint16_t port = 39921;
+
+  volatile int32_t killServer = 0;
+
+  Threading::ThreadHandle serverThread = Threading::CreateThread([port, &killServer]() {
+    RenderDoc::Inst().BecomeRemoteServer("127.0.0.1", port,
+                                         [&killServer]() { return killServer != 0; },
+                                         RENDERDOC_PreviewWindowCallback());
+  });
+
+  IRemoteServer *remote = NULL;
+
+  // give the server a moment to start listening
+  for(int i = 0; i < 100 && remote == NULL; i++)
+  {
+    ReplayStatus status = RENDERDOC_CreateRemoteServerConnection("127.0.0.1", port, &remote);
+
+    if(status != ReplayStatus::Succeeded)
+      Threading::Sleep(20);
+  }
+
+  REQUIRE(remote != NULL);
+
+  // three and a half blocks, the first half compressible and the rest not.
+  bytebuf contents;
+  contents.resize(size_t(FileBlockSize * 7 / 2));
+
+  uint32_t rng = 0x12345678;
+  for(size_t i = 0; i < contents.size(); i++)
+  {
+    if(i < contents.size() / 2)
+    {
+      contents[i] = byte(i / 64);
+    }
+    else
+    {
+      rng = rng * 1664525 + 1013904223;
+      contents[i] = byte(rng >> 24);
+    }
+  }
+
+  std::string source = FileIO::GetTempFolderFilename() + "/renderdoc_copy_test_source.rdc";
+  std::string dest = FileIO::GetTempFolderFilename() + "/renderdoc_copy_test_dest.rdc";
+
+  REQUIRE(FileIO::dump(source.c_str(), contents.data(), contents.size()));
+
+  float firstProgress = -1.0f;
+  float lastProgress = -1.0f;
+  RENDERDOC_ProgressCallback progress = [&firstProgress, &lastProgress](float p) {
+    if(firstProgress < 0.0f)
+      firstProgress = p;
+    lastProgress = p;
+  };
+
+  rdcstr remotePath = remote->CopyCaptureToRemote(source.c_str(), progress);
+
+  REQUIRE_FALSE(remotePath.empty());
+  CHECK(lastProgress == 1.0f);
+
+  std::vector<unsigned char> received;
+
+  SECTION("Full copy back")
+  {
+    FileIO::Delete((dest + ".partial").c_str());
+
+    remote->CopyCaptureFromRemote(remotePath.c_str(), dest.c_str(), progress);
+
+    REQUIRE(FileIO::slurp(dest.c_str(), received));
+    REQUIRE(received.size() == contents.size());
+    CHECK(memcmp(received.data(), contents.data(), contents.size()) == 0);
+  };
+
+  SECTION("Resume an interrupted copy")
+  {
+    // two good blocks, then a corrupted one as if the previous copy was cut off mid-write
+    bytebuf partial;
+    partial.assign(contents.data(), size_t(FileBlockSize * 3));
+    partial[size_t(FileBlockSize * 2 + 100)] ^= 0xff;
+
+    REQUIRE(FileIO::dump((dest + ".partial").c_str(), partial.data(), partial.size()));
+
+    firstProgress = -1.0f;
+
+    remote->CopyCaptureFromRemote(remotePath.c_str(), dest.c_str(), progress);
+
+    // the first progress update is after the first block that was actually sent, the third one
+    CHECK(firstProgress == float(FileBlockSize * 3) / float(contents.size()));
+
+    REQUIRE(FileIO::slurp(dest.c_str(), received));
+    REQUIRE(received.size() == contents.size());
+    CHECK(memcmp(received.data(), contents.data(), contents.size()) == 0);
+    CHECK_FALSE(FileIO::exists((dest + ".partial").c_str()));
+  };
+
+  remote->ShutdownConnection();
+
+  // an abandoned partial copy to the server is deleted when the server shuts down
+  std::string abandoned = GetResumableFilePath(0x1234);
+  REQUIRE(FileIO::dump(abandoned.c_str(), contents.data(), size_t(FileBlockSize)));
+
+  killServer = 1;
+  Threading::JoinThread(serverThread);
+  Threading::CloseThread(serverThread);
+
+  CHECK_FALSE(FileIO::exists(abandoned.c_str()));
+
+  FileIO::Delete(source.c_str());
+  FileIO::Delete(dest.c_str());
+};
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
@@ -26,6 +26,7 @@
 #include "replay_proxy.h"
 #include "3rdparty/lz4/lz4.h"
 #include "serialise/lz4io.h"
+#include "serialise/zstdio.h"
 
 // utility macros for implementing proxied functions
 
@@ -61,6 +62,7 @@
 // dispatches to the right implementation of the Proxied_ function, depending on whether we're on
 // the remote server or not.
 #define PROXY_FUNCTION(name, ...)                                     \
+  SCOPED_PROBE(ProxyPacket);                                          \
   if(m_RemoteServer)                                                  \
     return CONCAT(Proxied_, name)(m_Reader, m_Writer, ##__VA_ARGS__); \
   else                                                                \
@@ -78,6 +80,71 @@ ReplayProxy::~ReplayProxy()
     delete it->second;
 }
 
+template <>
+std::string DoStringise(const ProxyTransferCodec &el)
+{
+  BEGIN_ENUM_STRINGISE(ProxyTransferCodec);
+  {
+    STRINGISE_ENUM_CLASS(LZ4);
+    STRINGISE_ENUM_CLASS(ZSTDFast);
+    STRINGISE_ENUM_CLASS(ZSTD);
+    STRINGISE_ENUM_CLASS(Count);
+  }
+  END_ENUM_STRINGISE();
+}
+
+void ProxyTransferTuner::Configure(const std::string &setting)
+{
+  m_Fixed = true;
+
+  if(setting == "lz4")
+    m_FixedCodec = ProxyTransferCodec::LZ4;
+  else if(setting == "zstdfast")
+    m_FixedCodec = ProxyTransferCodec::ZSTDFast;
+  else if(setting == "zstd")
+    m_FixedCodec = ProxyTransferCodec::ZSTD;
+  else
+    m_Fixed = false;
+}
+
+ProxyTransferCodec ProxyTransferTuner::Choose() const
+{
+  if(m_Fixed)
+    return m_FixedCodec;
+
+  const uint32_t count = (uint32_t)ProxyTransferCodec::Count;
+
+  // measure every codec once before comparing them
+  for(uint32_t c = 0; c < count; c++)
+    if(m_Throughput[c] <= 0.0)
+      return (ProxyTransferCodec)c;
+
+  // periodically re-measure each codec in turn, in case the connection has changed
+  if(m_Samples % ExploreInterval == 0)
+    return (ProxyTransferCodec)((m_Samples / ExploreInterval) % count);
+
+  uint32_t best = 0;
+  for(uint32_t c = 1; c < count; c++)
+    if(m_Throughput[c] > m_Throughput[best])
+      best = c;
+
+  return (ProxyTransferCodec)best;
+}
+
+void ProxyTransferTuner::Record(ProxyTransferCodec codec, uint64_t bytes, double milliseconds)
+{
+  if(m_Fixed || bytes < MinimumSampleSize || codec >= ProxyTransferCodec::Count)
+    return;
+
+  double throughput = double(bytes) / RDCMAX(milliseconds, 0.01);
+
+  // weight towards recent transfers so that changes in the connection are picked up quickly
+  double &avg = m_Throughput[(uint32_t)codec];
+  avg = (avg <= 0.0) ? throughput : avg * 0.75 + throughput * 0.25;
+
+  m_Samples++;
+}
+
 #pragma region Proxied Functions
 
 template <typename ParamSerialiser, typename ReturnSerialiser>
@@ -365,6 +432,31 @@ std::vector<EventUsage> ReplayProxy::GetUsage(ResourceId id)
   PROXY_FUNCTION(GetUsage, id);
 }
 
+template <typename ParamSerialiser, typename ReturnSerialiser>
+ResourceUsageIndex ReplayProxy::Proxied_GetUsageIndex(ParamSerialiser &paramser,
+                                                      ReturnSerialiser &retser)
+{
+  const ReplayProxyPacket packet = eReplayProxy_GetUsageIndex;
+  ResourceUsageIndex ret;
+
+  {
+    BEGIN_PARAMS();
+    END_PARAMS();
+  }
+
+  if(paramser.IsReading() && !paramser.IsErrored() && !m_IsErrored)
+    ret = m_Remote->GetUsageIndex();
+
+  SERIALISE_RETURN(ret);
+
+  return ret;
+}
+
+ResourceUsageIndex ReplayProxy::GetUsageIndex()
+{
+  PROXY_FUNCTION(GetUsageIndex);
+}
+
 template <typename ParamSerialiser, typename ReturnSerialiser>
 FrameRecord ReplayProxy::Proxied_GetFrameRecord(ParamSerialiser &paramser, ReturnSerialiser &retser)
 {
@@ -546,61 +638,31 @@ void ReplayProxy::Proxied_GetBufferData(ParamSerialiser &paramser, ReturnSeriali
 {
   const ReplayProxyPacket packet = eReplayProxy_GetBufferData;
 
+  PerformanceTimer transferTimer;
+  ProxyTransferCodec codec = ProxyTransferCodec::LZ4;
+
+  if(paramser.IsWriting())
+    codec = m_TransferTuner.Choose();
+
   {
     BEGIN_PARAMS();
     SERIALISE_ELEMENT(buff);
     SERIALISE_ELEMENT(offset);
     SERIALISE_ELEMENT(len);
+    SERIALISE_ELEMENT(codec);
     END_PARAMS();
   }
 
-  if(paramser.IsReading() && !paramser.IsErrored() && !m_IsErrored)
-    m_Remote->GetBufferData(buff, offset, len, retData);
-
-  // over-estimate of total uncompressed data written. Since the decompression chain needs to know
-  // the exact uncompressed size, we over-estimate (to allow for length/padding/etc) and then pad
-  // to this amount.
-  uint64_t dataSize = retData.size() + 2 * retser.GetChunkAlignment();
+  double remoteTime = 0.0;
 
+  if(paramser.IsReading() && !paramser.IsErrored() && !m_IsErrored)
   {
-    ReturnSerialiser &ser = retser;
-    PACKET_HEADER(packet);
-    SERIALISE_ELEMENT(dataSize);
-  }
-
-  char empty[128] = {};
-
-  // lz4 compress
-  if(retser.IsReading())
-  {
-    ReadSerialiser ser(new StreamReader(new LZ4Decompressor(retser.GetReader(), Ownership::Nothing),
-                                        dataSize, Ownership::Stream),
-                       Ownership::Stream);
-
-    SERIALISE_ELEMENT(retData);
-
-    uint64_t offs = ser.GetReader()->GetOffset();
-    RDCASSERT(offs <= dataSize, offs, dataSize);
-    RDCASSERT(dataSize - offs < sizeof(empty), offs, dataSize);
-
-    ser.GetReader()->Read(empty, dataSize - offs);
-  }
-  else
-  {
-    WriteSerialiser ser(new StreamWriter(new LZ4Compressor(retser.GetWriter(), Ownership::Nothing),
-                                         Ownership::Stream),
-                        Ownership::Stream);
-
-    SERIALISE_ELEMENT(retData);
-
-    uint64_t offs = ser.GetWriter()->GetOffset();
-    RDCASSERT(offs <= dataSize, offs, dataSize);
-    RDCASSERT(dataSize - offs < sizeof(empty), offs, dataSize);
-
-    ser.GetWriter()->Write(empty, dataSize - offs);
+    PerformanceTimer remoteTimer;
+    m_Remote->GetBufferData(buff, offset, len, retData);
+    remoteTime = remoteTimer.GetMilliseconds();
   }
 
-  retser.EndChunk();
+  CompressedTransferBytes(retser, packet, codec, transferTimer, remoteTime, retData);
 }
 
 void ReplayProxy::GetBufferData(ResourceId buff, uint64_t offset, uint64_t len, bytebuf &retData)
@@ -615,62 +677,32 @@ void ReplayProxy::Proxied_GetTextureData(ParamSerialiser &paramser, ReturnSerial
 {
   const ReplayProxyPacket packet = eReplayProxy_GetTextureData;
 
+  PerformanceTimer transferTimer;
+  ProxyTransferCodec codec = ProxyTransferCodec::LZ4;
+
+  if(paramser.IsWriting())
+    codec = m_TransferTuner.Choose();
+
   {
     BEGIN_PARAMS();
     SERIALISE_ELEMENT(tex);
     SERIALISE_ELEMENT(arrayIdx);
     SERIALISE_ELEMENT(mip);
     SERIALISE_ELEMENT(params);
+    SERIALISE_ELEMENT(codec);
     END_PARAMS();
   }
 
-  if(paramser.IsReading() && !paramser.IsErrored() && !m_IsErrored)
-    m_Remote->GetTextureData(tex, arrayIdx, mip, params, data);
+  double remoteTime = 0.0;
 
-  // over-estimate of total uncompressed data written. Since the decompression chain needs to know
-  // the exact uncompressed size, we over-estimate (to allow for length/padding/etc) and then pad
-  // to this amount.
-  uint64_t dataSize = data.size() + 2 * retser.GetChunkAlignment();
-
-  {
-    ReturnSerialiser &ser = retser;
-    PACKET_HEADER(packet);
-    SERIALISE_ELEMENT(dataSize);
-  }
-
-  char empty[128] = {};
-
-  // lz4 compress
-  if(retser.IsReading())
-  {
-    ReadSerialiser ser(new StreamReader(new LZ4Decompressor(retser.GetReader(), Ownership::Nothing),
-                                        dataSize, Ownership::Stream),
-                       Ownership::Stream);
-
-    SERIALISE_ELEMENT(data);
-
-    uint64_t offs = ser.GetReader()->GetOffset();
-    RDCASSERT(offs <= dataSize, offs, dataSize);
-    RDCASSERT(dataSize - offs < sizeof(empty), offs, dataSize);
-
-    ser.GetReader()->Read(empty, dataSize - offs);
-  }
-  else
+  if(paramser.IsReading() && !paramser.IsErrored() && !m_IsErrored)
   {
-    WriteSerialiser ser(new StreamWriter(new LZ4Compressor(retser.GetWriter(), Ownership::Nothing),
-                                         Ownership::Stream),
-                        Ownership::Stream);
-
-    SERIALISE_ELEMENT(data);
-
-    uint64_t offs = ser.GetWriter()->GetOffset();
-    RDCASSERT(offs <= dataSize, offs, dataSize);
-    RDCASSERT(dataSize - offs < sizeof(empty), offs, dataSize);
-
-    ser.GetWriter()->Write(empty, dataSize - offs);
+    PerformanceTimer remoteTimer;
+    m_Remote->GetTextureData(tex, arrayIdx, mip, params, data);
+    remoteTime = remoteTimer.GetMilliseconds();
   }
 
-  retser.EndChunk();
+  CompressedTransferBytes(retser, packet, codec, transferTimer, remoteTime, data);
 }
 
 void ReplayProxy::GetTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t mip,
@@ -1626,6 +1658,75 @@ void ReplayProxy::DeltaTransferBytes(SerialiserType &xferser, bytebuf &reference
   }
 }
 
+template <typename SerialiserType>
+void ReplayProxy::CompressedTransferBytes(SerialiserType &retser, ReplayProxyPacket packet,
+                                          ProxyTransferCodec codec,
+                                          const PerformanceTimer &transferTimer, double remoteTime,
+                                          bytebuf &data)
+{
+  // over-estimate of total uncompressed data written. Since the decompression chain needs to know
+  // the exact uncompressed size, we over-estimate (to allow for length/padding/etc) and then pad
+  // to this amount.
+  uint64_t dataSize = data.size() + 2 * retser.GetChunkAlignment();
+
+  {
+    SerialiserType &ser = retser;
+    PACKET_HEADER(packet);
+    SERIALISE_ELEMENT(dataSize);
+    SERIALISE_ELEMENT(remoteTime);
+  }
+
+  char empty[128] = {};
+
+  if(retser.IsReading())
+  {
+    Decompressor *decompressor = NULL;
+
+    if(codec == ProxyTransferCodec::LZ4)
+      decompressor = new LZ4Decompressor(retser.GetReader(), Ownership::Nothing);
+    else
+      decompressor = new ZSTDDecompressor(retser.GetReader(), Ownership::Nothing);
+
+    ReadSerialiser ser(new StreamReader(decompressor, dataSize, Ownership::Stream),
+                       Ownership::Stream);
+
+    SERIALISE_ELEMENT(data);
+
+    uint64_t offs = ser.GetReader()->GetOffset();
+    RDCASSERT(offs <= dataSize, offs, dataSize);
+    RDCASSERT(dataSize - offs < sizeof(empty), offs, dataSize);
+
+    ser.GetReader()->Read(empty, dataSize - offs);
+  }
+  else
+  {
+    Compressor *compressor = NULL;
+
+    if(codec == ProxyTransferCodec::LZ4)
+      compressor = new LZ4Compressor(retser.GetWriter(), Ownership::Nothing);
+    else if(codec == ProxyTransferCodec::ZSTDFast)
+      compressor = new ZSTDCompressor(retser.GetWriter(), Ownership::Nothing, 1);
+    else
+      compressor = new ZSTDCompressor(retser.GetWriter(), Ownership::Nothing);
+
+    WriteSerialiser ser(new StreamWriter(compressor, Ownership::Stream), Ownership::Stream);
+
+    SERIALISE_ELEMENT(data);
+
+    uint64_t offs = ser.GetWriter()->GetOffset();
+    RDCASSERT(offs <= dataSize, offs, dataSize);
+    RDCASSERT(dataSize - offs < sizeof(empty), offs, dataSize);
+
+    ser.GetWriter()->Write(empty, dataSize - offs);
+  }
+
+  retser.EndChunk();
+
+  // the time the remote spent fetching the data isn't part of the transfer
+  if(retser.IsReading() && !retser.IsErrored() && !m_IsErrored)
+    m_TransferTuner.Record(codec, data.size(), transferTimer.GetMilliseconds() - remoteTime);
+}
+
 template <typename ParamSerialiser, typename ReturnSerialiser>
 void ReplayProxy::Proxied_CacheBufferData(ParamSerialiser &paramser, ReturnSerialiser &retser,
                                           ResourceId buff)
@@ -2031,6 +2132,7 @@ bool ReplayProxy::Tick(int type)
     }
     case eReplayProxy_SavePipelineState: SavePipelineState(); break;
     case eReplayProxy_GetUsage: GetUsage(ResourceId()); break;
+    case eReplayProxy_GetUsageIndex: GetUsageIndex(); break;
     case eReplayProxy_GetLiveID: GetLiveID(ResourceId()); break;
     case eReplayProxy_GetFrameRecord: GetFrameRecord(); break;
     case eReplayProxy_IsRenderOutput: IsRenderOutput(ResourceId()); break;
@@ -2091,3 +2193,86 @@ bool ReplayProxy::Tick(int type)
 
   return true;
 }
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#include "3rdparty/catch/catch.hpp"
+
+TEST_CASE("Choose replay proxy transfer codecs", "[proxy]")
+{
+  const uint64_t size = ProxyTransferTuner::MinimumSampleSize;
+
+  SECTION("Each codec is measured before the fastest is picked")
+  {
+    ProxyTransferTuner tuner;
+    tuner.Configure("");
+
+    CHECK(tuner.Choose() == ProxyTransferCodec::LZ4);
+
+    // small transfers don't count as a measurement
+    tuner.Record(ProxyTransferCodec::LZ4, 1024, 0.001);
+    CHECK(tuner.Choose() == ProxyTransferCodec::LZ4);
+
+    tuner.Record(ProxyTransferCodec::LZ4, size, 10.0);
+    CHECK(tuner.Choose() == ProxyTransferCodec::ZSTDFast);
+
+    tuner.Record(ProxyTransferCodec::ZSTDFast, size, 5.0);
+    CHECK(tuner.Choose() == ProxyTransferCodec::ZSTD);
+
+    tuner.Record(ProxyTransferCodec::ZSTD, size, 8.0);
+    CHECK(tuner.Choose() == ProxyTransferCodec::ZSTDFast);
+
+    // if the link speeds up, the fastest codec changes once the average catches up
+    for(int i = 0; i < 5; i++)
+      tuner.Record(ProxyTransferCodec::ZSTDFast, size, 20.0);
+
+    CHECK(tuner.Choose() == ProxyTransferCodec::ZSTD);
+  };
+
+  SECTION("Other codecs are periodically re-measured")
+  {
+    ProxyTransferTuner tuner;
+    tuner.Configure("auto");
+
+    tuner.Record(ProxyTransferCodec::LZ4, size, 1.0);
+    tuner.Record(ProxyTransferCodec::ZSTDFast, size, 10.0);
+    tuner.Record(ProxyTransferCodec::ZSTD, size, 10.0);
+
+    rdcarray<ProxyTransferCodec> chosen;
+
+    for(uint32_t i = 0; i < ProxyTransferTuner::ExploreInterval * 3; i++)
+    {
+      ProxyTransferCodec codec = tuner.Choose();
+      chosen.push_back(codec);
+      tuner.Record(codec, size, codec == ProxyTransferCodec::LZ4 ? 1.0 : 10.0);
+    }
+
+    int counts[(uint32_t)ProxyTransferCodec::Count] = {};
+    for(ProxyTransferCodec c : chosen)
+      counts[(uint32_t)c]++;
+
+    CHECK(counts[(uint32_t)ProxyTransferCodec::ZSTDFast] == 1);
+    CHECK(counts[(uint32_t)ProxyTransferCodec::ZSTD] == 1);
+    CHECK(counts[(uint32_t)ProxyTransferCodec::LZ4] == (int)chosen.size() - 2);
+  };
+
+  SECTION("A configured codec is always used")
+  {
+    ProxyTransferTuner tuner;
+    tuner.Configure("zstd");
+
+    for(int i = 0; i < 100; i++)
+    {
+      CHECK(tuner.Choose() == ProxyTransferCodec::ZSTD);
+      tuner.Record(ProxyTransferCodec::ZSTD, size, 1000.0);
+    }
+
+    tuner.Configure("lz4");
+    CHECK(tuner.Choose() == ProxyTransferCodec::LZ4);
+
+    tuner.Configure("zstdfast");
+    CHECK(tuner.Choose() == ProxyTransferCodec::ZSTDFast);
+  };
+};
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
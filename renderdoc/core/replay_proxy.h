@@ -63,6 +63,7 @@ enum ReplayProxyPacket
 
   eReplayProxy_SavePipelineState,
   eReplayProxy_GetUsage,
+  eReplayProxy_GetUsageIndex,
   eReplayProxy_GetLiveID,
   eReplayProxy_GetFrameRecord,
   eReplayProxy_IsRenderOutput,
@@ -95,6 +96,49 @@ enum ReplayProxyPacket
   eReplayProxy_GetDisassemblyTargets,
 };
 
+// the codecs that bulk buffer and texture data can be compressed with when it's returned from the
+// remote server. The client picks one for each request and sends it along with the parameters.
+enum class ProxyTransferCodec : uint32_t
+{
+  LZ4,
+  ZSTDFast,
+  ZSTD,
+  Count,
+};
+
+DECLARE_REFLECTION_ENUM(ProxyTransferCodec);
+
+// Picks the codec for each bulk data transfer. Which codec is fastest depends on the link - over a
+// fast local network LZ4's cheap compression wins, over a slow or remote link it's worth spending
+// more time in zstd to send fewer bytes. Rather than guessing from a probe up front, the client
+// times real transfers (excluding the time the remote spent replaying) and keeps a running average
+// of the effective throughput of each codec, then uses whichever is currently fastest. Every so
+// often another codec is tried again so that changes in the connection are noticed.
+//
+// The ReplayProxy_TransferCodec config setting can be set to lz4, zstdfast or zstd to force a
+// codec, any other value means codecs are chosen adaptively.
+class ProxyTransferTuner
+{
+public:
+  void Configure(const std::string &setting);
+
+  ProxyTransferCodec Choose() const;
+  void Record(ProxyTransferCodec codec, uint64_t bytes, double milliseconds);
+
+  // transfers smaller than this are dominated by latency and don't say anything about the codec
+  static const uint64_t MinimumSampleSize = 256 * 1024;
+  // after this many samples, one transfer is spent re-measuring another codec
+  static const uint32_t ExploreInterval = 16;
+
+private:
+  bool m_Fixed = false;
+  ProxyTransferCodec m_FixedCodec = ProxyTransferCodec::LZ4;
+
+  // bytes per millisecond of each codec, or 0 if it hasn't been measured yet
+  double m_Throughput[(uint32_t)ProxyTransferCodec::Count] = {};
+  uint32_t m_Samples = 0;
+};
+
 #define IMPLEMENT_FUNCTION_PROXIED(rettype, name, ...)                                  \
   rettype name(__VA_ARGS__);                                                            \
   template <typename ParamSerialiser, typename ReturnSerialiser>                        \
@@ -118,6 +162,7 @@ public:
         m_Replay(NULL),
         m_RemoteServer(false)
   {
+    m_TransferTuner.Configure(RenderDoc::Inst().GetConfigSetting("ReplayProxy_TransferCodec"));
     GetAPIProperties();
     FetchStructuredFile();
   }
@@ -442,6 +487,7 @@ public:
   IMPLEMENT_FUNCTION_PROXIED(std::vector<uint32_t>, GetPassEvents, uint32_t eventId);
 
   IMPLEMENT_FUNCTION_PROXIED(std::vector<EventUsage>, GetUsage, ResourceId id);
+  IMPLEMENT_FUNCTION_PROXIED(ResourceUsageIndex, GetUsageIndex);
   IMPLEMENT_FUNCTION_PROXIED(FrameRecord, GetFrameRecord);
 
   IMPLEMENT_FUNCTION_PROXIED(bool, IsRenderOutput, ResourceId id);
@@ -510,6 +556,14 @@ public:
   template <typename SerialiserType>
   void DeltaTransferBytes(SerialiserType &xferser, bytebuf &referenceData, bytebuf &newData);
 
+  // utility function to serialise the return of GetBufferData/GetTextureData compressed with the
+  // codec the client picked. On the client, the transfer is timed from transferTimer to feed back
+  // into codec selection.
+  template <typename SerialiserType>
+  void CompressedTransferBytes(SerialiserType &retser, ReplayProxyPacket packet,
+                               ProxyTransferCodec codec, const PerformanceTimer &transferTimer,
+                               double remoteTime, bytebuf &data);
+
   void FileChanged() {}
   // will never be used
   ResourceId CreateProxyTexture(const TextureDescription &templateTex)
@@ -641,6 +695,9 @@ private:
 
   bool m_IsErrored = false;
 
+  // only used on the client, to choose the codec for bulk data returned from the remote
+  ProxyTransferTuner m_TransferTuner;
+
   FrameRecord m_FrameRecord;
   APIProperties m_APIProps;
 
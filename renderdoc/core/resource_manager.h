@@ -903,6 +903,7 @@ template <typename Configuration>
 void ResourceManager<Configuration>::InsertInitialContentsChunks(WriteSerialiser &ser)
 {
   SCOPED_LOCK(m_Lock);
+  SCOPED_PROBE(InsertInitialContents);
 
   uint32_t dirty = 0;
   uint32_t skipped = 0;
@@ -30,7 +30,7 @@
 #include "os/os_specific.h"
 #include "serialise/serialiser.h"
 
-static const uint32_t TargetControlProtocolVersion = 2;
+static const uint32_t TargetControlProtocolVersion = 3;
 
 enum PacketType : uint32_t
 {
@@ -45,6 +45,8 @@ enum PacketType : uint32_t
   ePacket_QueueCapture,
   ePacket_NewChild,
   ePacket_CaptureProgress,
+  ePacket_SetTelemetryInterval,
+  ePacket_FrameTelemetry,
 };
 
 DECLARE_REFLECTION_ENUM(PacketType);
@@ -64,6 +66,9 @@ std::string DoStringise(const PacketType &el)
     STRINGISE_ENUM_NAMED(ePacket_DeleteCapture, "Delete Capture");
     STRINGISE_ENUM_NAMED(ePacket_QueueCapture, "Queue Capture");
     STRINGISE_ENUM_NAMED(ePacket_NewChild, "New Child");
+    STRINGISE_ENUM_NAMED(ePacket_CaptureProgress, "Capture Progress");
+    STRINGISE_ENUM_NAMED(ePacket_SetTelemetryInterval, "Set Telemetry Interval");
+    STRINGISE_ENUM_NAMED(ePacket_FrameTelemetry, "Frame Telemetry");
   }
   END_ENUM_STRINGISE();
 }
@@ -114,6 +119,11 @@ void RenderDoc::TargetControlClientThread(uint32_t version, Network::Socket *cli
   const int progresstime = 100;    // update capture progress every 100ms
   int curtime = 0;
 
+  // telemetry is only sent if the client asks for it, at the interval it requests
+  uint32_t telemetryInterval = 0;
+  uint32_t telemetrytime = 0;
+  bool enabledProbes = false;
+
   std::vector<CaptureData> captures;
   std::vector<pair<uint32_t, uint32_t> > children;
   std::map<RDCDriver, bool> drivers;
@@ -129,6 +139,7 @@ void RenderDoc::TargetControlClientThread(uint32_t version, Network::Socket *cli
 
     Threading::Sleep(ticktime);
     curtime += ticktime;
+    telemetrytime += ticktime;
 
     std::map<RDCDriver, bool> curdrivers = RenderDoc::Inst().GetActiveDrivers();
 
@@ -228,6 +239,19 @@ void RenderDoc::TargetControlClientThread(uint32_t version, Network::Socket *cli
       }
     }
 
+    if(telemetryInterval > 0 && telemetrytime >= telemetryInterval)
+    {
+      telemetrytime = 0;
+
+      FrameTelemetryData telemetry = RenderDoc::Inst().FetchFrameTelemetry();
+
+      WRITE_DATA_SCOPE();
+      {
+        SCOPED_SERIALISE_CHUNK(ePacket_FrameTelemetry);
+        SERIALISE_ELEMENT(telemetry);
+      }
+    }
+
     if(curtime > pingtime)
     {
       WRITE_DATA_SCOPE();
@@ -256,6 +280,31 @@ void RenderDoc::TargetControlClientThread(uint32_t version, Network::Socket *cli
 
         RenderDoc::Inst().TriggerCapture(numFrames);
       }
+      else if(type == ePacket_SetTelemetryInterval)
+      {
+        uint32_t intervalMS = 0;
+
+        READ_DATA_SCOPE();
+        SERIALISE_ELEMENT(intervalMS);
+
+        // start from a clean slate whenever the interval changes
+        RenderDoc::Inst().SetFrameTelemetryEnabled(intervalMS > 0);
+
+        // turn on probes for the telemetry, unless something else already has
+        if(intervalMS > 0 && !Probes::IsEnabled())
+        {
+          Probes::SetEnabled(true);
+          enabledProbes = true;
+        }
+        else if(intervalMS == 0 && enabledProbes)
+        {
+          Probes::SetEnabled(false);
+          enabledProbes = false;
+        }
+
+        telemetryInterval = intervalMS;
+        telemetrytime = 0;
+      }
       else if(type == ePacket_QueueCapture)
       {
         uint32_t frameNum = 0;
@@ -316,6 +365,12 @@ void RenderDoc::TargetControlClientThread(uint32_t version, Network::Socket *cli
 
   RenderDoc::Inst().SetProgressCallback<CaptureProgress>(RENDERDOC_ProgressCallback());
 
+  if(telemetryInterval > 0)
+    RenderDoc::Inst().SetFrameTelemetryEnabled(false);
+
+  if(enabledProbes)
+    Probes::SetEnabled(false);
+
   // give up our connection
   {
     SCOPED_LOCK(RenderDoc::Inst().m_SingleClientLock);
@@ -579,6 +634,17 @@ public:
       SAFE_DELETE(m_Socket);
   }
 
+  void SetTelemetryInterval(uint32_t intervalMS)
+  {
+    WRITE_DATA_SCOPE();
+    SCOPED_SERIALISE_CHUNK(ePacket_SetTelemetryInterval);
+
+    SERIALISE_ELEMENT(intervalMS);
+
+    if(ser.IsErrored())
+      SAFE_DELETE(m_Socket);
+  }
+
   TargetControlMessage ReceiveMessage()
   {
     TargetControlMessage msg;
@@ -653,6 +719,16 @@ public:
       reader.EndChunk();
       return msg;
     }
+    else if(type == ePacket_FrameTelemetry)
+    {
+      msg.type = TargetControlMessageType::FrameTelemetry;
+
+      READ_DATA_SCOPE();
+      SERIALISE_ELEMENT(msg.telemetry).Named("Telemetry");
+
+      reader.EndChunk();
+      return msg;
+    }
     else if(type == ePacket_NewCapture)
     {
       msg.type = TargetControlMessageType::NewCapture;
@@ -316,6 +316,7 @@ public:
   void MarkResourceReferenced(ResourceId id, FrameRefType refType);
 
   vector<EventUsage> GetUsage(ResourceId id) { return m_ResourceUses[id]; }
+  const map<ResourceId, vector<EventUsage> > &GetAllUsage() { return m_ResourceUses; }
   void ClearMaps();
 
   uint32_t GetEventID() { return m_CurEventID; }
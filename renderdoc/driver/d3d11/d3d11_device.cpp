@@ -1092,6 +1092,8 @@ ReplayStatus WrappedID3D11Device::ReadLogInitialisation(RDCFile *rdc, bool store
 void WrappedID3D11Device::ReplayLog(uint32_t startEventID, uint32_t endEventID,
                                     ReplayLogType replayType)
 {
+  SCOPED_PROBE(ReplayLog);
+
   bool partial = true;
 
   if(startEventID == 0 && (replayType == eReplay_WithoutDraw || replayType == eReplay_Full))
@@ -1409,6 +1411,8 @@ bool WrappedID3D11Device::EndFrameCapture(void *dev, void *wnd)
   if(!IsActiveCapturing(m_State))
     return true;
 
+  SCOPED_PROBE(EndFrameCapture);
+
   CaptureFailReason reason;
 
   WrappedIDXGISwapChain4 *swap = NULL;
@@ -403,6 +403,8 @@ template <typename SerialiserType>
 bool WrappedID3D11Device::Serialise_InitialState(SerialiserType &ser, ResourceId resid,
                                                  ID3D11DeviceChild *res)
 {
+  SCOPED_PROBE(SerialiseInitialState);
+
   D3D11ResourceType type = Resource_Unknown;
   ResourceId Id = ResourceId();
 
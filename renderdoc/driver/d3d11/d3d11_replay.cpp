@@ -450,6 +450,14 @@ vector<EventUsage> D3D11Replay::GetUsage(ResourceId id)
   return m_pDevice->GetImmediateContext()->GetUsage(id);
 }
 
+ResourceUsageIndex D3D11Replay::GetUsageIndex()
+{
+  ResourceUsageIndex ret;
+  ret.Build(m_pDevice->GetImmediateContext()->GetAllUsage(),
+            [this](ResourceId id) { return m_pDevice->GetResourceManager()->GetOriginalID(id); });
+  return ret;
+}
+
 vector<DebugMessage> D3D11Replay::GetDebugMessages()
 {
   return m_pDevice->GetDebugMessages();
@@ -2802,14 +2810,13 @@ uint32_t D3D11Replay::PickVertex(uint32_t eventId, int32_t width, int32_t height
     byte *data = &oldData[0];
     byte *dataEnd = data + oldData.size();
 
-    bool valid;
-
     // the index buffer may refer to vertices past the start of the vertex buffer, so we can't just
     // conver the first N vertices we'll need.
     // Instead we grab min and max above, and convert every vertex in that range. This might
     // slightly over-estimate but not as bad as 0-max or the whole buffer.
-    for(uint32_t idx = minIndex; idx <= maxIndex; idx++)
-      vbData[idx] = HighlightCache::InterpretVertex(data, idx, cfg, dataEnd, valid);
+    if(minIndex <= maxIndex)
+      HighlightCache::InterpretVertices(data, minIndex, maxIndex - minIndex + 1, cfg, dataEnd,
+                                        vbData.data() + minIndex);
 
     D3D11_BOX box;
     box.top = 0;
@@ -122,6 +122,7 @@ public:
   string DisassembleShader(ResourceId pipeline, const ShaderReflection *refl, const string &target);
 
   vector<EventUsage> GetUsage(ResourceId id);
+  ResourceUsageIndex GetUsageIndex();
 
   FrameRecord GetFrameRecord();
 
@@ -23,6 +23,7 @@
  ******************************************************************************/
 
 #include "d3d11_shader_cache.h"
+#include "3rdparty/zstd/xxhash.h"
 #include "common/shader_cache.h"
 #include "driver/dx/official/d3dcompiler.h"
 #include "driver/shaders/dxbc/dxbc_inspect.h"
@@ -47,7 +48,7 @@ struct D3DBlobShaderCallbacks
       RDCFATAL("d3dcompiler.dll doesn't contain D3DCreateBlob");
   }
 
-  bool Create(uint32_t size, byte *data, ID3DBlob **ret) const
+  bool Create(uint32_t size, const byte *data, ID3DBlob **ret) const
   {
     RDCASSERT(ret);
 
@@ -75,39 +76,27 @@ D3D11ShaderCache::D3D11ShaderCache(WrappedID3D11Device *wrapper)
 {
   m_pDevice = wrapper;
 
-  bool success = LoadShaderCache("d3dshaders.cache", m_ShaderCacheMagic, m_ShaderCacheVersion,
-                                 m_ShaderCache, D3D11ShaderCacheCallbacks);
-
-  // if we failed to load from the cache
-  m_ShaderCacheDirty = !success;
+  // open the shader cache, nothing is read from it until a shader is looked up
+  m_ShaderCache = new ShaderCache<ID3DBlob *, D3DBlobShaderCallbacks>(
+      "d3dshaders.cache", m_ShaderCacheMagic, m_ShaderCacheVersion, D3D11ShaderCacheCallbacks);
 }
 
 D3D11ShaderCache::~D3D11ShaderCache()
 {
-  if(m_ShaderCacheDirty)
-  {
-    SaveShaderCache("d3dshaders.cache", m_ShaderCacheMagic, m_ShaderCacheVersion, m_ShaderCache,
-                    D3D11ShaderCacheCallbacks);
-  }
-  else
-  {
-    for(auto it = m_ShaderCache.begin(); it != m_ShaderCache.end(); ++it)
-      D3D11ShaderCacheCallbacks.Destroy(it->second);
-  }
+  SAFE_DELETE(m_ShaderCache);
 }
 
 std::string D3D11ShaderCache::GetShaderBlob(const char *source, const char *entry,
                                             const uint32_t compileFlags, const char *profile,
                                             ID3DBlob **srcblob)
 {
-  uint32_t hash = strhash(source);
-  hash = strhash(entry, hash);
-  hash = strhash(profile, hash);
-  hash ^= compileFlags;
+  uint64_t hash = XXH64(source, strlen(source), 0);
+  hash = XXH64(entry, strlen(entry), hash);
+  hash = XXH64(profile, strlen(profile), hash);
+  hash = XXH64(&compileFlags, sizeof(compileFlags), hash);
 
-  if(m_ShaderCache.find(hash) != m_ShaderCache.end())
+  if(m_ShaderCache->Find(hash, *srcblob))
   {
-    *srcblob = m_ShaderCache[hash];
     (*srcblob)->AddRef();
     return "";
   }
@@ -159,9 +148,8 @@ std::string D3D11ShaderCache::GetShaderBlob(const char *source, const char *entr
 
   if(m_CacheShaders)
   {
-    m_ShaderCache[hash] = byteBlob;
     byteBlob->AddRef();
-    m_ShaderCacheDirty = true;
+    m_ShaderCache->Add(hash, byteBlob);
   }
 
   SAFE_RELEASE(errBlob);
@@ -502,6 +502,8 @@ void STDMETHODCALLTYPE WrappedID3D12CommandQueue::ExecuteCommandLists(
 
           m_pDevice->MapDataWrite(res, subres, data, range);
 
+          RenderDoc::Inst().AddCoherentMapBytes(diffEnd - diffStart);
+
           if(ref == NULL)
           {
             res->AllocShadow(subres, size);
@@ -1329,6 +1329,8 @@ bool WrappedID3D12Device::EndFrameCapture(void *dev, void *wnd)
   if(!IsActiveCapturing(m_State))
     return true;
 
+  SCOPED_PROBE(EndFrameCapture);
+
   WrappedIDXGISwapChain4 *swap = NULL;
   SwapPresentInfo swapInfo = {};
 
@@ -2656,6 +2658,8 @@ ReplayStatus WrappedID3D12Device::ReadLogInitialisation(RDCFile *rdc, bool store
 void WrappedID3D12Device::ReplayLog(uint32_t startEventID, uint32_t endEventID,
                                     ReplayLogType replayType)
 {
+  SCOPED_PROBE(ReplayLog);
+
   bool partial = true;
 
   if(startEventID == 0 && (replayType == eReplay_WithoutDraw || replayType == eReplay_Full))
@@ -426,6 +426,14 @@ vector<EventUsage> D3D12Replay::GetUsage(ResourceId id)
   return m_pDevice->GetQueue()->GetUsage(id);
 }
 
+ResourceUsageIndex D3D12Replay::GetUsageIndex()
+{
+  ResourceUsageIndex ret;
+  ret.Build(m_pDevice->GetQueue()->GetAllUsage(),
+            [this](ResourceId id) { return m_pDevice->GetResourceManager()->GetOriginalID(id); });
+  return ret;
+}
+
 void D3D12Replay::FillResourceView(D3D12Pipe::View &view, D3D12Descriptor *desc)
 {
   D3D12ResourceManager *rm = m_pDevice->GetResourceManager();
@@ -1885,14 +1893,13 @@ uint32_t D3D12Replay::PickVertex(uint32_t eventId, int32_t width, int32_t height
     byte *data = &oldData[0];
     byte *dataEnd = data + oldData.size();
 
-    bool valid = true;
-
     // the index buffer may refer to vertices past the start of the vertex buffer, so we can't just
     // conver the first N vertices we'll need.
     // Instead we grab min and max above, and convert every vertex in that range. This might
     // slightly over-estimate but not as bad as 0-max or the whole buffer.
-    for(uint32_t idx = minIndex; idx <= maxIndex; idx++)
-      vbData[idx] = HighlightCache::InterpretVertex(data, idx, cfg, dataEnd, valid);
+    if(minIndex <= maxIndex)
+      HighlightCache::InterpretVertices(data, minIndex, maxIndex - minIndex + 1, cfg, dataEnd,
+                                        vbData.data() + minIndex);
 
     GetDebugManager()->FillBuffer(m_VertexPick.VB, 0, vbData.data(), sizeof(Vec4f) * (maxIndex + 1));
   }
@@ -23,6 +23,7 @@
  ******************************************************************************/
 
 #include "d3d12_shader_cache.h"
+#include "3rdparty/zstd/xxhash.h"
 #include "common/shader_cache.h"
 #include "driver/dx/official/d3dcompiler.h"
 #include "driver/shaders/dxbc/dxbc_inspect.h"
@@ -45,7 +46,7 @@ struct D3D12BlobShaderCallbacks
       RDCFATAL("d3dcompiler.dll doesn't contain D3DCreateBlob");
   }
 
-  bool Create(uint32_t size, byte *data, ID3DBlob **ret) const
+  bool Create(uint32_t size, const byte *data, ID3DBlob **ret) const
   {
     RDCASSERT(ret);
 
@@ -72,39 +73,27 @@ struct D3D12BlobShaderCallbacks
 
 D3D12ShaderCache::D3D12ShaderCache()
 {
-  bool success = LoadShaderCache("d3dshaders.cache", m_ShaderCacheMagic, m_ShaderCacheVersion,
-                                 m_ShaderCache, D3D12ShaderCacheCallbacks);
-
-  // if we failed to load from the cache
-  m_ShaderCacheDirty = !success;
+  // open the shader cache, nothing is read from it until a shader is looked up
+  m_ShaderCache = new ShaderCache<ID3DBlob *, D3D12BlobShaderCallbacks>(
+      "d3dshaders.cache", m_ShaderCacheMagic, m_ShaderCacheVersion, D3D12ShaderCacheCallbacks);
 }
 
 D3D12ShaderCache::~D3D12ShaderCache()
 {
-  if(m_ShaderCacheDirty)
-  {
-    SaveShaderCache("d3dshaders.cache", m_ShaderCacheMagic, m_ShaderCacheVersion, m_ShaderCache,
-                    D3D12ShaderCacheCallbacks);
-  }
-  else
-  {
-    for(auto it = m_ShaderCache.begin(); it != m_ShaderCache.end(); ++it)
-      D3D12ShaderCacheCallbacks.Destroy(it->second);
-  }
+  SAFE_DELETE(m_ShaderCache);
 }
 
 std::string D3D12ShaderCache::GetShaderBlob(const char *source, const char *entry,
                                             const uint32_t compileFlags, const char *profile,
                                             ID3DBlob **srcblob)
 {
-  uint32_t hash = strhash(source);
-  hash = strhash(entry, hash);
-  hash = strhash(profile, hash);
-  hash ^= compileFlags;
+  uint64_t hash = XXH64(source, strlen(source), 0);
+  hash = XXH64(entry, strlen(entry), hash);
+  hash = XXH64(profile, strlen(profile), hash);
+  hash = XXH64(&compileFlags, sizeof(compileFlags), hash);
 
-  if(m_ShaderCache.find(hash) != m_ShaderCache.end())
+  if(m_ShaderCache->Find(hash, *srcblob))
   {
-    *srcblob = m_ShaderCache[hash];
     (*srcblob)->AddRef();
     return "";
   }
@@ -156,9 +145,8 @@ std::string D3D12ShaderCache::GetShaderBlob(const char *source, const char *entr
 
   if(m_CacheShaders)
   {
-    m_ShaderCache[hash] = byteBlob;
     byteBlob->AddRef();
-    m_ShaderCacheDirty = true;
+    m_ShaderCache->Add(hash, byteBlob);
   }
 
   SAFE_RELEASE(errBlob);
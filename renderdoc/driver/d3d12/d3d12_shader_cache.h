@@ -32,6 +32,11 @@
 
 class WrappedID3D11Device;
 
+struct D3D12BlobShaderCallbacks;
+
+template <typename ResultType, typename ShaderCallbacks>
+class ShaderCache;
+
 class D3D12ShaderCache
 {
 public:
@@ -52,8 +57,8 @@ public:
   void SetCaching(bool enabled) { m_CacheShaders = enabled; }
 private:
   static const uint32_t m_ShaderCacheMagic = 0xf000baba;
-  static const uint32_t m_ShaderCacheVersion = 3;
+  static const uint32_t m_ShaderCacheVersion = 4;
 
-  bool m_ShaderCacheDirty = false, m_CacheShaders = false;
-  std::map<uint32_t, ID3DBlob *> m_ShaderCache;
+  bool m_CacheShaders = false;
+  ShaderCache<ID3DBlob *, D3D12BlobShaderCallbacks> *m_ShaderCache = NULL;
 };
\ No newline at end of file
@@ -1480,14 +1480,13 @@ uint32_t GLReplay::PickVertex(uint32_t eventId, int32_t width, int32_t height,
     byte *data = &oldData[0];
     byte *dataEnd = data + oldData.size();
 
-    bool valid;
-
     // the index buffer may refer to vertices past the start of the vertex buffer, so we can't just
     // conver the first N vertices we'll need.
     // Instead we grab min and max above, and convert every vertex in that range. This might
     // slightly over-estimate but not as bad as 0-max or the whole buffer.
-    for(uint32_t idx = minIndex; idx <= maxIndex; idx++)
-      vbData[idx] = HighlightCache::InterpretVertex(data, idx, cfg, dataEnd, valid);
+    if(minIndex <= maxIndex)
+      HighlightCache::InterpretVertices(data, minIndex, maxIndex - minIndex + 1, cfg, dataEnd,
+                                        vbData.data() + minIndex);
 
     gl.glBindBuffer(eGL_SHADER_STORAGE_BUFFER, DebugData.pickVBBuf);
     gl.glBufferSubData(eGL_SHADER_STORAGE_BUFFER, 0, (maxIndex + 1) * sizeof(Vec4f), vbData.data());
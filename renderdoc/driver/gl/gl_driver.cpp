@@ -1300,7 +1300,11 @@ void WrappedOpenGL::FreeTargetResource(ResourceId id)
 void WrappedOpenGL::SwapBuffers(void *windowHandle)
 {
   if(IsBackgroundCapturing(m_State))
+  {
+    SCOPED_FRAME_OVERHEAD();
+
     RenderDoc::Inst().Tick();
+  }
 
   // don't do anything if no context is active.
   if(GetCtx() == NULL)
@@ -1375,6 +1379,8 @@ void WrappedOpenGL::SwapBuffers(void *windowHandle)
 
   if(IsBackgroundCapturing(m_State))
   {
+    SCOPED_FRAME_OVERHEAD();
+
     uint32_t overlay = RenderDoc::Inst().GetOverlayBits();
 
     if(overlay & eRENDERDOC_Overlay_Enabled)
@@ -1602,6 +1608,8 @@ bool WrappedOpenGL::EndFrameCapture(void *dev, void *wnd)
   if(!IsActiveCapturing(m_State))
     return true;
 
+  SCOPED_PROBE(EndFrameCapture);
+
   SCOPED_LOCK(GetGLLock());
 
   CaptureFailReason reason = CaptureSucceeded;
@@ -2076,6 +2084,14 @@ void WrappedOpenGL::AttemptCapture()
     }
     m_ContextRecord->UnlockChunks();
   }
+
+  // any client memory uploads from a previous attempt were discarded along with its chunks
+  for(auto it = m_ContextData.begin(); it != m_ContextData.end(); ++it)
+  {
+    for(size_t i = 0; i < ARRAY_COUNT(it->second.m_ClientMemoryVBOContents); i++)
+      it->second.m_ClientMemoryVBOContents[i].clear();
+    it->second.m_ClientMemoryIBOContents.clear();
+  }
 }
 
 template <typename SerialiserType>
@@ -4480,6 +4496,8 @@ const DrawcallDescription *WrappedOpenGL::GetDrawcall(uint32_t eventId)
 
 void WrappedOpenGL::ReplayLog(uint32_t startEventID, uint32_t endEventID, ReplayLogType replayType)
 {
+  SCOPED_PROBE(ReplayLog);
+
   bool partial = true;
 
   if(startEventID == 0 && (replayType == eReplay_WithoutDraw || replayType == eReplay_Full))
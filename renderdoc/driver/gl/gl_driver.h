@@ -461,6 +461,11 @@ private:
     // temporary VBOs so that input mesh data is recorded. See struct ClientMemoryData
     GLuint m_ClientMemoryVBOs[16];
     GLuint m_ClientMemoryIBO;
+
+    // the data last uploaded to each of the buffers above in the current capture. Consecutive
+    // draws often read the same client memory, so it's only uploaded again if it has changed.
+    std::vector<byte> m_ClientMemoryVBOContents[16];
+    std::vector<byte> m_ClientMemoryIBOContents;
   };
 
   struct ClientMemoryData
@@ -480,6 +485,8 @@ private:
   ClientMemoryData *CopyClientMemoryArrays(GLint first, GLsizei count, GLenum indexType,
                                            const void *&indices);
   void RestoreClientMemoryArrays(ClientMemoryData *clientMemoryArrays, GLenum indexType);
+  void UploadClientMemory(GLenum target, std::vector<byte> &contents, const void *data,
+                          GLsizeiptr size);
 
   std::map<void *, ContextData> m_ContextData;
 
@@ -590,6 +597,7 @@ public:
 
   void SuppressDebugMessages(bool suppress) { m_SuppressDebugMessages = suppress; }
   vector<EventUsage> GetUsage(ResourceId id) { return m_ResourceUses[id]; }
+  const map<ResourceId, vector<EventUsage> > &GetAllUsage() { return m_ResourceUses; }
   void CreateContext(GLWindowingData winData, void *shareContext, GLInitParams initParams,
                      bool core, bool attribsCreate);
   void RegisterContext(GLWindowingData winData, void *shareContext, bool core, bool attribsCreate);
@@ -994,6 +994,8 @@ uint32_t GLResourceManager::GetSize_InitialState(ResourceId resid, GLResource re
 template <typename SerialiserType>
 bool GLResourceManager::Serialise_InitialState(SerialiserType &ser, ResourceId resid, GLResource res)
 {
+  SCOPED_PROBE(SerialiseInitialState);
+
   m_State = m_GL->GetState();
 
   SERIALISE_ELEMENT_LOCAL(Id, GetID(res)).TypedAs("GLResource");
@@ -59,10 +59,24 @@ struct PixelUnpackState : public PixelStorageState
   bool FastPath(GLsizei width, GLsizei height, GLsizei depth, GLenum dataformat, GLenum basetype);
   bool FastPathCompressed(GLsizei width, GLsizei height, GLsizei depth);
 
+  // describe where the rows of the source data are in client memory, so they can be serialised
+  // directly without repacking. Returns false if the data can't be used as-is and must be
+  // unpacked, e.g. if bytes need to be swapped.
+  bool GetPacked(const byte *pixels, GLsizei width, GLsizei height, GLsizei depth,
+                 GLenum dataformat, GLenum basetype, StridedByteBuffer &packed);
+  void GetPackedCompressed(const byte *pixels, GLsizei width, GLsizei height, GLsizei depth,
+                           GLsizei &imageSize, StridedByteBuffer &packed);
+
+  // the returned data is in per-thread scratch memory which is owned by the unpack state, and is
+  // only valid until the next call to Unpack or UnpackCompressed on the same thread.
   byte *Unpack(byte *pixels, GLsizei width, GLsizei height, GLsizei depth, GLenum dataformat,
                GLenum basetype);
   byte *UnpackCompressed(byte *pixels, GLsizei width, GLsizei height, GLsizei depth,
                          GLsizei &imageSize);
+
+private:
+  void GetSourceLayout(const byte *pixels, GLsizei width, GLsizei height, GLsizei depth,
+                       GLenum dataformat, GLenum basetype, StridedByteBuffer &layout);
 };
 
 void ResetPixelPackState(const GLHookSet &gl, bool compressed, GLint alignment);
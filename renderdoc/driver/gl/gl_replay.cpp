@@ -3043,6 +3043,14 @@ vector<EventUsage> GLReplay::GetUsage(ResourceId id)
   return m_pDriver->GetUsage(id);
 }
 
+ResourceUsageIndex GLReplay::GetUsageIndex()
+{
+  ResourceUsageIndex ret;
+  ret.Build(m_pDriver->GetAllUsage(),
+            [this](ResourceId id) { return m_pDriver->GetResourceManager()->GetOriginalID(id); });
+  return ret;
+}
+
 vector<PixelModification> GLReplay::PixelHistory(vector<EventUsage> events, ResourceId target,
                                                  uint32_t x, uint32_t y, uint32_t slice,
                                                  uint32_t mip, uint32_t sampleIdx, CompType typeHint)
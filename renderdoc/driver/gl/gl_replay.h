@@ -112,6 +112,7 @@ public:
   vector<DebugMessage> GetDebugMessages();
 
   vector<EventUsage> GetUsage(ResourceId id);
+  ResourceUsageIndex GetUsageIndex();
 
   FrameRecord GetFrameRecord();
 
@@ -2599,6 +2599,8 @@ void WrappedOpenGL::PersistentMapMemoryBarrier(const set<GLResourceRecord *> &ma
       memcpy(record->GetShadowPtr(1) + diffStart, record->GetShadowPtr(0) + diffStart,
              diffEnd - diffStart);
 
+      RenderDoc::Inst().AddCoherentMapBytes(diffEnd - diffStart);
+
       // we use our own flush function so it will serialise chunks when necessary, and it
       // also handles copying into the persistent mapped pointer and flushing the real GL
       // buffer
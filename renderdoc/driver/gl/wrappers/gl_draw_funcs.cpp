@@ -23,6 +23,7 @@
  * THE SOFTWARE.
  ******************************************************************************/
 
+#include <algorithm>
 #include "../gl_driver.h"
 #include "common/common.h"
 #include "strings/string_utils.h"
@@ -736,6 +737,40 @@ bool WrappedOpenGL::Serialise_glDrawArrays(SerialiserType &ser, GLenum mode, GLi
   return true;
 }
 
+// the number of bytes read for a single vertex of an attribute
+static size_t GetClientAttribSize(GLint size, GLenum type)
+{
+  switch(type)
+  {
+    case eGL_INT_2_10_10_10_REV:
+    case eGL_UNSIGNED_INT_2_10_10_10_REV:
+    case eGL_UNSIGNED_INT_10F_11F_11F_REV: return 4;
+    case eGL_FIXED: return 4 * size;
+    default: break;
+  }
+
+  // GL_BGRA attributes always have four components
+  if(size == eGL_BGRA)
+    size = 4;
+
+  return GLTypeSize(type) * size;
+}
+
+void WrappedOpenGL::UploadClientMemory(GLenum target, std::vector<byte> &contents, const void *data,
+                                       GLsizeiptr size)
+{
+  // if the buffer already starts with exactly this data there's nothing to do. Comparing against
+  // our own copy is cheaper than uploading and serialising the data again, and unlike a hash it
+  // can't be fooled into skipping an upload that changed.
+  if((size_t)size <= contents.size() && !memcmp(contents.data(), data, (size_t)size))
+    return;
+
+  gl_CurChunk = GLChunk::glBufferData;
+  glBufferData(target, size, data, eGL_STATIC_DRAW);
+
+  contents.assign((const byte *)data, (const byte *)data + size);
+}
+
 WrappedOpenGL::ClientMemoryData *WrappedOpenGL::CopyClientMemoryArrays(GLint first, GLsizei count,
                                                                        GLenum indexType,
                                                                        const void *&indices)
@@ -758,8 +793,7 @@ WrappedOpenGL::ClientMemoryData *WrappedOpenGL::CopyClientMemoryArrays(GLint fir
       gl_CurChunk = GLChunk::glBindBuffer;
       glBindBuffer(eGL_ELEMENT_ARRAY_BUFFER, cd.m_ClientMemoryIBO);
 
-      gl_CurChunk = GLChunk::glBufferData;
-      glBufferData(eGL_ELEMENT_ARRAY_BUFFER, idxlen, indices, eGL_STATIC_DRAW);
+      UploadClientMemory(eGL_ELEMENT_ARRAY_BUFFER, cd.m_ClientMemoryIBOContents, indices, idxlen);
 
       // Set offset to 0 - means we read data from start of our fake index buffer
       indices = 0;
@@ -773,6 +807,19 @@ WrappedOpenGL::ClientMemoryData *WrappedOpenGL::CopyClientMemoryArrays(GLint fir
   ClientMemoryData *clientMemory = new ClientMemoryData;
   m_Real.glGetIntegerv(eGL_ARRAY_BUFFER_BINDING, (GLint *)&clientMemory->prevArrayBufferBinding);
 
+  // the client memory read by each attribute. Interleaved attributes read overlapping ranges, which
+  // are coalesced below so that the memory is only uploaded once.
+  struct ClientMemoryRange
+  {
+    const byte *begin;
+    const byte *end;
+    size_t attrib;
+
+    bool operator<(const ClientMemoryRange &o) const { return begin < o.begin; }
+  };
+
+  std::vector<ClientMemoryRange> ranges;
+
   for(GLuint i = 0; i < ARRAY_COUNT(cd.m_ClientMemoryVBOs); i++)
   {
     GLint enabled = 0;
@@ -842,20 +889,53 @@ WrappedOpenGL::ClientMemoryData *WrappedOpenGL::CopyClientMemoryArrays(GLint fir
     m_Real.glGetVertexAttribiv(i, eGL_VERTEX_ATTRIB_ARRAY_STRIDE, &attrib.stride);
     m_Real.glGetVertexAttribPointerv(i, eGL_VERTEX_ATTRIB_ARRAY_POINTER, &attrib.pointer);
 
-    GLint totalStride = attrib.stride ? attrib.stride : (GLint)GLTypeSize(attrib.type) * attrib.size;
+    size_t attribSize = GetClientAttribSize(attrib.size, attrib.type);
+    size_t totalStride = attrib.stride ? (size_t)attrib.stride : attribSize;
+
+    // the range is from the pointer, since that becomes a zero offset, up to the end of the last
+    // vertex read. Reading any further could run off the end of the application's allocation.
+    ClientMemoryRange range;
+    range.begin = range.end = (const byte *)attrib.pointer;
+    range.attrib = clientMemory->attribs.size();
+    if(count > 0)
+      range.end += size_t(first + count - 1) * totalStride + attribSize;
+
+    ranges.push_back(range);
+    clientMemory->attribs.push_back(attrib);
+  }
+
+  std::sort(ranges.begin(), ranges.end());
+
+  for(size_t r = 0; r < ranges.size();)
+  {
+    const byte *begin = ranges[r].begin;
+    const byte *end = ranges[r].end;
+
+    // gather every following range that overlaps this one, and upload them together into the
+    // temporary buffer for the lowest attribute index.
+    GLuint bufIdx = clientMemory->attribs[ranges[r].attrib].index;
+    size_t groupEnd = r + 1;
+    for(; groupEnd < ranges.size() && ranges[groupEnd].begin < end; groupEnd++)
+    {
+      end = RDCMAX(end, ranges[groupEnd].end);
+      bufIdx = RDCMIN(bufIdx, clientMemory->attribs[ranges[groupEnd].attrib].index);
+    }
 
     gl_CurChunk = GLChunk::glBindBuffer;
-    glBindBuffer(eGL_ARRAY_BUFFER, cd.m_ClientMemoryVBOs[i]);
+    glBindBuffer(eGL_ARRAY_BUFFER, cd.m_ClientMemoryVBOs[bufIdx]);
 
-    // Copy all client memory, and the pointer becomes a zero offset.
-    gl_CurChunk = GLChunk::glBufferData;
-    glBufferData(eGL_ARRAY_BUFFER, (first + count) * totalStride, attrib.pointer, eGL_STATIC_DRAW);
+    UploadClientMemory(eGL_ARRAY_BUFFER, cd.m_ClientMemoryVBOContents[bufIdx], begin,
+                       GLsizeiptr(end - begin));
 
-    gl_CurChunk = GLChunk::glVertexAttribPointer;
-    glVertexAttribPointer(attrib.index, attrib.size, attrib.type, attrib.normalized, attrib.stride,
-                          NULL);
+    // each pointer becomes an offset from the start of the uploaded range.
+    for(; r < groupEnd; r++)
+    {
+      const ClientMemoryData::VertexAttrib &attrib = clientMemory->attribs[ranges[r].attrib];
 
-    clientMemory->attribs.push_back(attrib);
+      gl_CurChunk = GLChunk::glVertexAttribPointer;
+      glVertexAttribPointer(attrib.index, attrib.size, attrib.type, attrib.normalized,
+                            attrib.stride, (const void *)((const byte *)attrib.pointer - begin));
+    }
   }
 
   return clientMemory;
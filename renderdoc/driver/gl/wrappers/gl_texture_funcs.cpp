@@ -2018,23 +2018,19 @@ bool WrappedOpenGL::Serialise_glTextureImage1DEXT(SerialiserType &ser, GLuint te
   SERIALISE_ELEMENT(format);
   SERIALISE_ELEMENT(type);
 
-  byte *unpackedPixels = NULL;
-
   if(ser.IsWriting() && pixels)
   {
     PixelUnpackState unpack;
     unpack.Fetch(&m_Real, false);
 
     if(!unpack.FastPath(width, 0, 0, format, type))
-      pixels = unpackedPixels = unpack.Unpack((byte *)pixels, width, 0, 0, format, type);
+      pixels = unpack.Unpack((byte *)pixels, width, 0, 0, format, type);
   }
 
   size_t subimageSize = GetByteSize(width, 1, 1, format, type);
 
   SERIALISE_ELEMENT_ARRAY(pixels, subimageSize);
 
-  SAFE_DELETE_ARRAY(unpackedPixels);
-
   SERIALISE_CHECK_READ_ERRORS();
 
   if(IsReplayingAndReading())
@@ -2233,23 +2229,19 @@ bool WrappedOpenGL::Serialise_glTextureImage2DEXT(SerialiserType &ser, GLuint te
   SERIALISE_ELEMENT(format);
   SERIALISE_ELEMENT(type);
 
-  byte *unpackedPixels = NULL;
-
   if(ser.IsWriting() && pixels)
   {
     PixelUnpackState unpack;
     unpack.Fetch(&m_Real, false);
 
     if(!unpack.FastPath(width, 0, 0, format, type))
-      pixels = unpackedPixels = unpack.Unpack((byte *)pixels, width, height, 0, format, type);
+      pixels = unpack.Unpack((byte *)pixels, width, height, 0, format, type);
   }
 
   size_t subimageSize = GetByteSize(width, height, 1, format, type);
 
   SERIALISE_ELEMENT_ARRAY(pixels, subimageSize);
 
-  SAFE_DELETE_ARRAY(unpackedPixels);
-
   SERIALISE_CHECK_READ_ERRORS();
 
   if(IsReplayingAndReading())
@@ -2476,23 +2468,19 @@ bool WrappedOpenGL::Serialise_glTextureImage3DEXT(SerialiserType &ser, GLuint te
   SERIALISE_ELEMENT(format);
   SERIALISE_ELEMENT(type);
 
-  byte *unpackedPixels = NULL;
-
   if(ser.IsWriting() && pixels)
   {
     PixelUnpackState unpack;
     unpack.Fetch(&m_Real, false);
 
     if(!unpack.FastPath(width, height, depth, format, type))
-      pixels = unpackedPixels = unpack.Unpack((byte *)pixels, width, height, depth, format, type);
+      pixels = unpack.Unpack((byte *)pixels, width, height, depth, format, type);
   }
 
   size_t subimageSize = GetByteSize(width, height, depth, format, type);
 
   SERIALISE_ELEMENT_ARRAY(pixels, subimageSize);
 
-  SAFE_DELETE_ARRAY(unpackedPixels);
-
   SERIALISE_CHECK_READ_ERRORS();
 
   if(IsReplayingAndReading())
@@ -2697,22 +2685,18 @@ bool WrappedOpenGL::Serialise_glCompressedTextureImage1DEXT(SerialiserType &ser,
   SERIALISE_ELEMENT(width);
   SERIALISE_ELEMENT(border);
 
-  byte *unpackedPixels = NULL;
-
   if(ser.IsWriting() && pixels)
   {
     PixelUnpackState unpack;
     unpack.Fetch(&m_Real, true);
 
     if(!unpack.FastPathCompressed(width, 0, 0))
-      pixels = unpackedPixels = unpack.UnpackCompressed((byte *)pixels, width, 0, 0, imageSize);
+      pixels = unpack.UnpackCompressed((byte *)pixels, width, 0, 0, imageSize);
   }
 
   SERIALISE_ELEMENT(imageSize);
   SERIALISE_ELEMENT_ARRAY(pixels, imageSize);
 
-  SAFE_DELETE_ARRAY(unpackedPixels);
-
   SERIALISE_CHECK_READ_ERRORS();
 
   if(IsReplayingAndReading())
@@ -2911,7 +2895,6 @@ void WrappedOpenGL::StoreCompressedTexData(ResourceId texId, GLenum target, GLin
                                            GLsizei width, GLsizei height, GLsizei depth,
                                            GLenum format, GLsizei imageSize, const void *pixels)
 {
-  byte *unpackedPixels = NULL;
   byte *srcPixels = NULL;
   GLint unpackbuf = 0;
 
@@ -2925,8 +2908,7 @@ void WrappedOpenGL::StoreCompressedTexData(ResourceId texId, GLenum target, GLin
     if(unpack.FastPathCompressed(width, height, depth))
       srcPixels = (byte *)pixels;
     else
-      srcPixels = unpackedPixels =
-          unpack.UnpackCompressed((byte *)pixels, width, height, depth, imageSize);
+      srcPixels = unpack.UnpackCompressed((byte *)pixels, width, height, depth, imageSize);
   }
 
   if(unpackbuf != 0)
@@ -3000,8 +2982,6 @@ void WrappedOpenGL::StoreCompressedTexData(ResourceId texId, GLenum target, GLin
     RDCWARN("StoreCompressedTexData: No source pixels to copy from (tex:%llu, target:%s)", texId,
             ToStr(target).c_str());
   }
-
-  SAFE_DELETE_ARRAY(unpackedPixels);
 }
 
 template <typename SerialiserType>
@@ -3019,22 +2999,18 @@ bool WrappedOpenGL::Serialise_glCompressedTextureImage2DEXT(SerialiserType &ser,
   SERIALISE_ELEMENT(height);
   SERIALISE_ELEMENT(border);
 
-  byte *unpackedPixels = NULL;
-
   if(ser.IsWriting() && pixels)
   {
     PixelUnpackState unpack;
     unpack.Fetch(&m_Real, true);
 
     if(!unpack.FastPathCompressed(width, height, 0))
-      pixels = unpackedPixels = unpack.UnpackCompressed((byte *)pixels, width, height, 0, imageSize);
+      pixels = unpack.UnpackCompressed((byte *)pixels, width, height, 0, imageSize);
   }
 
   SERIALISE_ELEMENT(imageSize);
   SERIALISE_ELEMENT_ARRAY(pixels, imageSize);
 
-  SAFE_DELETE_ARRAY(unpackedPixels);
-
   SERIALISE_CHECK_READ_ERRORS();
 
   if(IsReplayingAndReading())
@@ -3277,23 +3253,18 @@ bool WrappedOpenGL::Serialise_glCompressedTextureImage3DEXT(SerialiserType &ser,
   SERIALISE_ELEMENT(depth);
   SERIALISE_ELEMENT(border);
 
-  byte *unpackedPixels = NULL;
-
   if(ser.IsWriting() && pixels)
   {
     PixelUnpackState unpack;
     unpack.Fetch(&m_Real, true);
 
     if(!unpack.FastPathCompressed(width, height, depth))
-      pixels = unpackedPixels =
-          unpack.UnpackCompressed((byte *)pixels, width, height, depth, imageSize);
+      pixels = unpack.UnpackCompressed((byte *)pixels, width, height, depth, imageSize);
   }
 
   SERIALISE_ELEMENT(imageSize);
   SERIALISE_ELEMENT_ARRAY(pixels, imageSize);
 
-  SAFE_DELETE_ARRAY(unpackedPixels);
-
   SERIALISE_CHECK_READ_ERRORS();
 
   if(IsReplayingAndReading())
@@ -4607,15 +4578,17 @@ bool WrappedOpenGL::Serialise_glTextureSubImage1DEXT(SerialiserType &ser, GLuint
 
   SERIALISE_ELEMENT_LOCAL(UnpackBufBound, unpackbuf != 0).Hidden();
 
-  byte *unpackedPixels = NULL;
+  StridedByteBuffer packedPixels;
 
   if(ser.IsWriting() && pixels && !UnpackBufBound)
   {
     PixelUnpackState unpack;
     unpack.Fetch(&m_Real, false);
 
-    if(!unpack.FastPath(width, 0, 0, format, type))
-      pixels = unpackedPixels = unpack.Unpack((byte *)pixels, width, 0, 0, format, type);
+    // if possible, serialise the rows straight out of the application's memory
+    if(!unpack.FastPath(width, 0, 0, format, type) &&
+       !unpack.GetPacked((const byte *)pixels, width, 0, 0, format, type, packedPixels))
+      pixels = unpack.Unpack((byte *)pixels, width, 0, 0, format, type);
   }
 
   size_t subimageSize = GetByteSize(width, 1, 1, format, type);
@@ -4627,7 +4600,10 @@ bool WrappedOpenGL::Serialise_glTextureSubImage1DEXT(SerialiserType &ser, GLuint
   // in.
   if(!UnpackBufBound)
   {
-    ser.Serialise("pixels", pixels, subimageSize, SerialiserFlags::AllocateMemory);
+    if(packedPixels.data)
+      ser.SerialiseStrided("pixels", packedPixels);
+    else
+      ser.Serialise("pixels", pixels, subimageSize, SerialiserFlags::AllocateMemory);
   }
   else
   {
@@ -4635,8 +4611,6 @@ bool WrappedOpenGL::Serialise_glTextureSubImage1DEXT(SerialiserType &ser, GLuint
     SERIALISE_ELEMENT(UnpackOffset);
   }
 
-  SAFE_DELETE_ARRAY(unpackedPixels);
-
   SERIALISE_CHECK_READ_ERRORS();
 
   if(IsReplayingAndReading())
@@ -4817,15 +4791,17 @@ bool WrappedOpenGL::Serialise_glTextureSubImage2DEXT(SerialiserType &ser, GLuint
 
   SERIALISE_ELEMENT_LOCAL(UnpackBufBound, unpackbuf != 0).Hidden();
 
-  byte *unpackedPixels = NULL;
+  StridedByteBuffer packedPixels;
 
   if(ser.IsWriting() && pixels && !UnpackBufBound)
   {
     PixelUnpackState unpack;
     unpack.Fetch(&m_Real, false);
 
-    if(!unpack.FastPath(width, height, 0, format, type))
-      pixels = unpackedPixels = unpack.Unpack((byte *)pixels, width, height, 0, format, type);
+    // if possible, serialise the rows straight out of the application's memory
+    if(!unpack.FastPath(width, height, 0, format, type) &&
+       !unpack.GetPacked((const byte *)pixels, width, height, 0, format, type, packedPixels))
+      pixels = unpack.Unpack((byte *)pixels, width, height, 0, format, type);
   }
 
   size_t subimageSize = GetByteSize(width, height, 1, format, type);
@@ -4837,7 +4813,10 @@ bool WrappedOpenGL::Serialise_glTextureSubImage2DEXT(SerialiserType &ser, GLuint
   // in.
   if(!UnpackBufBound)
   {
-    ser.Serialise("pixels", pixels, subimageSize, SerialiserFlags::AllocateMemory);
+    if(packedPixels.data)
+      ser.SerialiseStrided("pixels", packedPixels);
+    else
+      ser.Serialise("pixels", pixels, subimageSize, SerialiserFlags::AllocateMemory);
   }
   else
   {
@@ -4845,8 +4824,6 @@ bool WrappedOpenGL::Serialise_glTextureSubImage2DEXT(SerialiserType &ser, GLuint
     SERIALISE_ELEMENT(UnpackOffset);
   }
 
-  SAFE_DELETE_ARRAY(unpackedPixels);
-
   SERIALISE_CHECK_READ_ERRORS();
 
   if(IsReplayingAndReading())
@@ -5034,15 +5011,17 @@ bool WrappedOpenGL::Serialise_glTextureSubImage3DEXT(SerialiserType &ser, GLuint
 
   SERIALISE_ELEMENT_LOCAL(UnpackBufBound, unpackbuf != 0).Hidden();
 
-  byte *unpackedPixels = NULL;
+  StridedByteBuffer packedPixels;
 
   if(ser.IsWriting() && pixels && !UnpackBufBound)
   {
     PixelUnpackState unpack;
     unpack.Fetch(&m_Real, false);
 
-    if(!unpack.FastPath(width, height, depth, format, type))
-      pixels = unpackedPixels = unpack.Unpack((byte *)pixels, width, height, depth, format, type);
+    // if possible, serialise the rows straight out of the application's memory
+    if(!unpack.FastPath(width, height, depth, format, type) &&
+       !unpack.GetPacked((const byte *)pixels, width, height, depth, format, type, packedPixels))
+      pixels = unpack.Unpack((byte *)pixels, width, height, depth, format, type);
   }
 
   size_t subimageSize = GetByteSize(width, height, depth, format, type);
@@ -5054,7 +5033,10 @@ bool WrappedOpenGL::Serialise_glTextureSubImage3DEXT(SerialiserType &ser, GLuint
   // in.
   if(!UnpackBufBound)
   {
-    ser.Serialise("pixels", pixels, subimageSize, SerialiserFlags::AllocateMemory);
+    if(packedPixels.data)
+      ser.SerialiseStrided("pixels", packedPixels);
+    else
+      ser.Serialise("pixels", pixels, subimageSize, SerialiserFlags::AllocateMemory);
   }
   else
   {
@@ -5062,8 +5044,6 @@ bool WrappedOpenGL::Serialise_glTextureSubImage3DEXT(SerialiserType &ser, GLuint
     SERIALISE_ELEMENT(UnpackOffset);
   }
 
-  SAFE_DELETE_ARRAY(unpackedPixels);
-
   SERIALISE_CHECK_READ_ERRORS();
 
   if(IsReplayingAndReading())
@@ -5251,15 +5231,16 @@ bool WrappedOpenGL::Serialise_glCompressedTextureSubImage1DEXT(SerialiserType &s
 
   SERIALISE_ELEMENT_LOCAL(UnpackBufBound, unpackbuf != 0).Hidden();
 
-  byte *unpackedPixels = NULL;
+  StridedByteBuffer packedPixels;
 
   if(ser.IsWriting() && pixels && !UnpackBufBound)
   {
     PixelUnpackState unpack;
     unpack.Fetch(&m_Real, true);
 
+    // serialise the blocks straight out of the application's memory
     if(!unpack.FastPathCompressed(width, 0, 0))
-      pixels = unpackedPixels = unpack.UnpackCompressed((byte *)pixels, width, 0, 0, imageSize);
+      unpack.GetPackedCompressed((const byte *)pixels, width, 0, 0, imageSize, packedPixels);
   }
 
   uint64_t UnpackOffset = 0;
@@ -5271,7 +5252,10 @@ bool WrappedOpenGL::Serialise_glCompressedTextureSubImage1DEXT(SerialiserType &s
   // in.
   if(!UnpackBufBound)
   {
-    ser.Serialise("pixels", pixels, (uint32_t &)imageSize, SerialiserFlags::AllocateMemory);
+    if(packedPixels.data)
+      ser.SerialiseStrided("pixels", packedPixels);
+    else
+      ser.Serialise("pixels", pixels, (uint32_t &)imageSize, SerialiserFlags::AllocateMemory);
   }
   else
   {
@@ -5279,8 +5263,6 @@ bool WrappedOpenGL::Serialise_glCompressedTextureSubImage1DEXT(SerialiserType &s
     SERIALISE_ELEMENT(UnpackOffset);
   }
 
-  SAFE_DELETE_ARRAY(unpackedPixels);
-
   SERIALISE_CHECK_READ_ERRORS();
 
   if(IsReplayingAndReading())
@@ -5451,15 +5433,16 @@ bool WrappedOpenGL::Serialise_glCompressedTextureSubImage2DEXT(SerialiserType &s
 
   SERIALISE_ELEMENT_LOCAL(UnpackBufBound, unpackbuf != 0).Hidden();
 
-  byte *unpackedPixels = NULL;
+  StridedByteBuffer packedPixels;
 
   if(ser.IsWriting() && pixels && !UnpackBufBound)
   {
     PixelUnpackState unpack;
     unpack.Fetch(&m_Real, true);
 
+    // serialise the blocks straight out of the application's memory
     if(!unpack.FastPathCompressed(width, height, 0))
-      pixels = unpackedPixels = unpack.UnpackCompressed((byte *)pixels, width, height, 0, imageSize);
+      unpack.GetPackedCompressed((const byte *)pixels, width, height, 0, imageSize, packedPixels);
   }
 
   uint64_t UnpackOffset = 0;
@@ -5470,7 +5453,10 @@ bool WrappedOpenGL::Serialise_glCompressedTextureSubImage2DEXT(SerialiserType &s
   // in.
   if(!UnpackBufBound)
   {
-    ser.Serialise("pixels", pixels, (uint32_t &)imageSize, SerialiserFlags::AllocateMemory);
+    if(packedPixels.data)
+      ser.SerialiseStrided("pixels", packedPixels);
+    else
+      ser.Serialise("pixels", pixels, (uint32_t &)imageSize, SerialiserFlags::AllocateMemory);
   }
   else
   {
@@ -5478,8 +5464,6 @@ bool WrappedOpenGL::Serialise_glCompressedTextureSubImage2DEXT(SerialiserType &s
     SERIALISE_ELEMENT(UnpackOffset);
   }
 
-  SAFE_DELETE_ARRAY(unpackedPixels);
-
   SERIALISE_CHECK_READ_ERRORS();
 
   if(IsReplayingAndReading())
@@ -5667,15 +5651,17 @@ bool WrappedOpenGL::Serialise_glCompressedTextureSubImage3DEXT(
 
   SERIALISE_ELEMENT_LOCAL(UnpackBufBound, unpackbuf != 0).Hidden();
 
-  byte *unpackedPixels = NULL;
+  StridedByteBuffer packedPixels;
 
   if(ser.IsWriting() && pixels && !UnpackBufBound)
   {
     PixelUnpackState unpack;
     unpack.Fetch(&m_Real, true);
 
-    if(!unpack.FastPathCompressed(width, height, 0))
-      pixels = unpackedPixels = unpack.UnpackCompressed((byte *)pixels, width, height, 0, imageSize);
+    // serialise the blocks straight out of the application's memory
+    if(!unpack.FastPathCompressed(width, height, depth))
+      unpack.GetPackedCompressed((const byte *)pixels, width, height, depth, imageSize,
+                                 packedPixels);
   }
 
   uint64_t UnpackOffset = 0;
@@ -5686,7 +5672,10 @@ bool WrappedOpenGL::Serialise_glCompressedTextureSubImage3DEXT(
   // in.
   if(!UnpackBufBound)
   {
-    ser.Serialise("pixels", pixels, (uint32_t &)imageSize, SerialiserFlags::AllocateMemory);
+    if(packedPixels.data)
+      ser.SerialiseStrided("pixels", packedPixels);
+    else
+      ser.Serialise("pixels", pixels, (uint32_t &)imageSize, SerialiserFlags::AllocateMemory);
   }
   else
   {
@@ -5694,8 +5683,6 @@ bool WrappedOpenGL::Serialise_glCompressedTextureSubImage3DEXT(
     SERIALISE_ELEMENT(UnpackOffset);
   }
 
-  SAFE_DELETE_ARRAY(unpackedPixels);
-
   SERIALISE_CHECK_READ_ERRORS();
 
   if(IsReplayingAndReading())
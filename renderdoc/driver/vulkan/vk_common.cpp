@@ -239,6 +239,11 @@ bool VkInitParams::IsSupportedVersion(uint64_t ver)
 
   // we can check other older versions we support here.
 
+  // 0xB -> 0xC - large byte buffers can be references into a ContentBlobs section, marked by the
+  // top bit of their size. Older captures never set it, so they read the same.
+  if(ver == 0xB)
+    return true;
+
   return false;
 }
 
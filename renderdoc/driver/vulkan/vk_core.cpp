@@ -948,6 +948,9 @@ void WrappedVulkan::StartFrameCapture(void *dev, void *wnd)
     SCOPED_LOCK(m_CapTransitionLock);
     GetResourceManager()->PrepareInitialContents();
 
+    // wait for all the copies to finish before the application can modify anything
+    FlushInitStateBatch();
+
     RDCDEBUG("Attempting capture");
     m_FrameCaptureRecord->DeleteChunks();
 
@@ -974,6 +977,10 @@ bool WrappedVulkan::EndFrameCapture(void *dev, void *wnd)
   if(!IsActiveCapturing(m_State))
     return true;
 
+  SCOPED_PROBE(EndFrameCapture);
+
+  PerformanceTimer stallTimer;
+
   VkSwapchainKHR swap = VK_NULL_HANDLE;
 
   if(wnd)
@@ -1338,16 +1345,26 @@ bool WrappedVulkan::EndFrameCapture(void *dev, void *wnd)
 
   StreamWriter *captureWriter = NULL;
 
-  if(rdc)
-  {
-    SectionProperties props;
+  SectionProperties props;
 
-    // Compress with LZ4 so that it's fast
-    props.flags = SectionFlags::LZ4Compressed;
-    props.version = m_SectionVersion;
-    props.type = SectionType::FrameCapture;
+  // Compress with LZ4 so that it's fast
+  props.flags = SectionFlags::LZ4Compressed;
+  props.version = m_SectionVersion;
+  props.type = SectionType::FrameCapture;
 
-    captureWriter = rdc->WriteSection(props);
+  // the frame is only serialised into memory here. Compressing it and writing it to disk happens on
+  // a background thread so that the application can continue as soon as possible.
+  MemoryBlockCompressor *captureData = NULL;
+
+  // initial contents are often duplicated (e.g. zero-filled buffers), so large buffers are stored
+  // once per unique contents in a separate section.
+  BlobStore *blobs = NULL;
+
+  if(rdc)
+  {
+    captureData = new MemoryBlockCompressor();
+    captureWriter = new StreamWriter(captureData, Ownership::Nothing);
+    blobs = new BlobStore();
   }
   else
   {
@@ -1360,6 +1377,7 @@ bool WrappedVulkan::EndFrameCapture(void *dev, void *wnd)
     ser.SetChunkMetadataRecording(GetThreadSerialiser().GetChunkMetadataRecording());
 
     ser.SetUserData(GetResourceManager());
+    ser.SetBlobStore(blobs);
 
     {
       SCOPED_SERIALISE_CHUNK(SystemChunk::DriverInit, m_InitParams.GetSerialiseSize());
@@ -1371,8 +1389,13 @@ bool WrappedVulkan::EndFrameCapture(void *dev, void *wnd)
 
     GetResourceManager()->InsertReferencedChunks(ser);
 
+    // the chunk size estimates need to know if contents will only be written as blob references
+    m_InitialContentsBlobs = blobs != NULL;
+
     GetResourceManager()->InsertInitialContentsChunks(ser);
 
+    m_InitialContentsBlobs = false;
+
     RDCDEBUG("Creating Capture Scope");
 
     GetResourceManager()->Serialise_InitialContentsNeeded(ser);
@@ -1424,7 +1447,8 @@ bool WrappedVulkan::EndFrameCapture(void *dev, void *wnd)
     }
   }
 
-  RenderDoc::Inst().FinishCaptureWriting(rdc, m_CapturedFrames.back().frameNumber);
+  RenderDoc::Inst().QueueCaptureWriting(rdc, m_CapturedFrames.back().frameNumber, props,
+                                         captureData, blobs);
 
   SAFE_DELETE(m_HeaderChunk);
 
@@ -1446,6 +1470,9 @@ bool WrappedVulkan::EndFrameCapture(void *dev, void *wnd)
 
   FreeAllMemory(MemoryScope::InitialContents);
 
+  RDCLOG("Capture of frame %u stalled the application for %.2f ms",
+         m_CapturedFrames.back().frameNumber, stallTimer.GetMilliseconds());
+
   return true;
 }
 
@@ -1498,6 +1525,11 @@ ReplayStatus WrappedVulkan::ReadLogInitialisation(RDCFile *rdc, bool storeStruct
 
   ReadSerialiser ser(reader, Ownership::Stream);
 
+  // captures without deduplicated buffers don't have a blob section, and never reference one
+  BlobStore blobs;
+  if(m_SectionVersion >= 0xC && blobs.Open(rdc))
+    ser.SetBlobStore(&blobs);
+
   ser.SetStringDatabase(&m_StringDB);
   ser.SetUserData(GetResourceManager());
 
@@ -1523,6 +1555,9 @@ ReplayStatus WrappedVulkan::ReadLogInitialisation(RDCFile *rdc, bool storeStruct
 
   uint64_t frameDataSize = 0;
 
+  // pipeline shaders are reflected in bulk once all the pipelines have been created
+  m_CreationInfo.m_DeferReflection = true;
+
   for(;;)
   {
     PerformanceTimer timer;
@@ -1567,6 +1602,8 @@ ReplayStatus WrappedVulkan::ReadLogInitialisation(RDCFile *rdc, bool storeStruct
 
       m_FrameReader = new StreamReader(reader, frameDataSize);
 
+      m_CreationInfo.ProcessDeferredReflection(GetResourceManager(), m_ShaderCache);
+
       ReplayStatus status = ContextReplayLog(m_State, 0, 0, false);
 
       if(status != ReplayStatus::Succeeded)
@@ -1581,6 +1618,9 @@ ReplayStatus WrappedVulkan::ReadLogInitialisation(RDCFile *rdc, bool storeStruct
       break;
   }
 
+  // in case there was no capture scope, don't leave any pipelines unreflected
+  m_CreationInfo.ProcessDeferredReflection(GetResourceManager(), m_ShaderCache);
+
 #if ENABLED(RDOC_DEVEL)
   for(auto it = chunkInfos.begin(); it != chunkInfos.end(); ++it)
   {
@@ -2293,6 +2333,8 @@ bool WrappedVulkan::ProcessChunk(ReadSerialiser &ser, VulkanChunk chunk)
 
 void WrappedVulkan::ReplayLog(uint32_t startEventID, uint32_t endEventID, ReplayLogType replayType)
 {
+  SCOPED_PROBE(ReplayLog);
+
   bool partial = true;
 
   if(startEventID == 0 && (replayType == eReplay_WithoutDraw || replayType == eReplay_Full))
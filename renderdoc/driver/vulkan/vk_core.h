@@ -55,7 +55,7 @@ struct VkInitParams
   uint32_t GetSerialiseSize();
 
   // check if a frame capture section version is supported
-  static const uint64_t CurrentVersion = 0xB;
+  static const uint64_t CurrentVersion = 0xC;
   static bool IsSupportedVersion(uint64_t ver);
 };
 
@@ -223,6 +223,9 @@ private:
   bool m_MarkedActive = false;
   uint32_t m_SubmitCounter = 0;
 
+  // set while initial contents are being serialised into a capture with a blob store attached
+  bool m_InitialContentsBlobs = false;
+
   uint64_t threadSerialiserTLSSlot;
 
   Threading::CriticalSection m_ThreadSerialisersLock;
@@ -395,6 +398,20 @@ private:
     // -> FlushQ() ----back to freesems-------^
   } m_InternalCmds;
 
+  // initial state copies made when preparing a capture are submitted without waiting for each one.
+  // The temporary objects they use are kept here until the batch is flushed. The readback memory
+  // itself isn't recycled through a staging ring: each resource's copy has to stay mapped-readable
+  // until it's serialised at the end of the frame, so only the submissions are batched.
+  struct
+  {
+    vector<VkBuffer> buffers;
+    vector<VkImage> images;
+    VkDeviceSize pendingBytes = 0;
+  } m_InitStateBatch;
+
+  void SubmitInitStateBatch(VkDeviceSize copySize);
+  void FlushInitStateBatch();
+
   // Internal lumped/pooled memory allocations
 
   // Each memory scope gets a separate vector of allocation objects. The vector contains the list of
@@ -795,6 +812,7 @@ public:
   uint32_t GetGPULocalMemoryIndex(uint32_t resourceRequiredBitmask);
 
   vector<EventUsage> GetUsage(ResourceId id) { return m_ResourceUses[id]; }
+  const map<ResourceId, vector<EventUsage> > &GetAllUsage() { return m_ResourceUses; }
   // return the pre-selected device and queue
   VkDevice GetDev()
   {
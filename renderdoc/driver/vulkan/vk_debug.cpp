@@ -1007,16 +1007,15 @@ uint32_t VulkanReplay::PickVertex(uint32_t eventId, int32_t w, int32_t h, const
     byte *data = &oldData[0];
     byte *dataEnd = data + oldData.size();
 
-    bool valid = true;
-
     FloatVector *vbData = (FloatVector *)m_VertexPick.VBUpload.Map();
 
     // the index buffer may refer to vertices past the start of the vertex buffer, so we can't just
     // conver the first N vertices we'll need.
     // Instead we grab min and max above, and convert every vertex in that range. This might
     // slightly over-estimate but not as bad as 0-max or the whole buffer.
-    for(uint32_t idx = minIndex; idx <= maxIndex; idx++)
-      vbData[idx] = HighlightCache::InterpretVertex(data, idx, cfg, dataEnd, valid);
+    if(minIndex <= maxIndex)
+      HighlightCache::InterpretVertices(data, minIndex, maxIndex - minIndex + 1, cfg, dataEnd,
+                                        vbData + minIndex);
 
     m_VertexPick.VBUpload.Unmap();
   }
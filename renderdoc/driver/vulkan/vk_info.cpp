@@ -24,6 +24,7 @@
 
 #include "vk_info.h"
 #include "3rdparty/glslang/SPIRV/spirv.hpp"
+#include "vk_shader_cache.h"
 
 void DescSetLayout::Init(VulkanResourceManager *resourceMan, VulkanCreationInfo &info,
                          const VkDescriptorSetLayoutCreateInfo *pCreateInfo)
@@ -136,10 +137,9 @@ void VulkanCreationInfo::Pipeline::Init(VulkanResourceManager *resourceMan, Vulk
     shad.module = id;
     shad.entryPoint = pCreateInfo->pStages[i].pName;
 
-    ShaderModule::Reflection &reflData = info.m_ShaderModule[id].m_Reflections[shad.entryPoint];
+    info.ReflectShader(resourceMan, id, shad.entryPoint, pCreateInfo->pStages[i].stage);
 
-    reflData.Init(resourceMan, id, info.m_ShaderModule[id].spirv, shad.entryPoint,
-                  pCreateInfo->pStages[i].stage);
+    ShaderModule::Reflection &reflData = info.m_ShaderModule[id].m_Reflections[shad.entryPoint];
 
     if(pCreateInfo->pStages[i].pSpecializationInfo)
     {
@@ -347,10 +347,9 @@ void VulkanCreationInfo::Pipeline::Init(VulkanResourceManager *resourceMan, Vulk
     shad.module = id;
     shad.entryPoint = pCreateInfo->stage.pName;
 
-    ShaderModule::Reflection &reflData = info.m_ShaderModule[id].m_Reflections[shad.entryPoint];
+    info.ReflectShader(resourceMan, id, shad.entryPoint, pCreateInfo->stage.stage);
 
-    reflData.Init(resourceMan, id, info.m_ShaderModule[id].spirv, shad.entryPoint,
-                  pCreateInfo->stage.stage);
+    ShaderModule::Reflection &reflData = info.m_ShaderModule[id].m_Reflections[shad.entryPoint];
 
     if(pCreateInfo->stage.pSpecializationInfo)
     {
@@ -594,6 +593,11 @@ void VulkanCreationInfo::ImageView::Init(VulkanResourceManager *resourceMan, Vul
   swizzle[3] = Convert(pCreateInfo->components.a, 3);
 }
 
+VulkanCreationInfo::ShaderModule::~ShaderModule()
+{
+  SAFE_DELETE(spirv);
+}
+
 void VulkanCreationInfo::ShaderModule::Init(VulkanResourceManager *resourceMan,
                                             VulkanCreationInfo &info,
                                             const VkShaderModuleCreateInfo *pCreateInfo)
@@ -606,12 +610,27 @@ void VulkanCreationInfo::ShaderModule::Init(VulkanResourceManager *resourceMan,
   else
   {
     RDCASSERT(pCreateInfo->codeSize % sizeof(uint32_t) == 0);
-    ParseSPIRV((uint32_t *)pCreateInfo->pCode, pCreateInfo->codeSize / sizeof(uint32_t), spirv);
+    spirvWords.assign(pCreateInfo->pCode,
+                      pCreateInfo->pCode + pCreateInfo->codeSize / sizeof(uint32_t));
   }
 }
 
+SPVModule &VulkanCreationInfo::ShaderModule::GetSPIRV()
+{
+  if(spirv == NULL)
+  {
+    spirv = new SPVModule();
+
+    if(!spirvWords.empty())
+      ParseSPIRV(spirvWords.data(), spirvWords.size(), *spirv);
+  }
+
+  return *spirv;
+}
+
 void VulkanCreationInfo::ShaderModule::Reflection::Init(VulkanResourceManager *resourceMan,
-                                                        ResourceId id, const SPVModule &spv,
+                                                        VulkanShaderCache *cache, ResourceId id,
+                                                        ShaderModule &module,
                                                         const std::string &entry,
                                                         VkShaderStageFlagBits stage)
 {
@@ -620,15 +639,90 @@ void VulkanCreationInfo::ShaderModule::Reflection::Init(VulkanResourceManager *r
     entryPoint = entry;
     stageIndex = StageIndex(stage);
 
-    spv.MakeReflection(ShaderStage(stageIndex), entryPoint, refl, mapping, patchData);
+    const vector<uint32_t> &words = module.GetSPIRVWords();
+
+    // if the reflection is in the cache, the module doesn't need to be parsed at all
+    bool cached = cache && !words.empty() &&
+                  cache->GetCachedReflection(words, entryPoint, ShaderStage(stageIndex), refl,
+                                             mapping, patchData);
+
+    if(!cached)
+    {
+      module.GetSPIRV().MakeReflection(ShaderStage(stageIndex), entryPoint, refl, mapping,
+                                       patchData);
+
+      if(cache && !words.empty())
+        cache->CacheReflection(words, entryPoint, ShaderStage(stageIndex), refl, mapping,
+                               patchData);
+    }
 
     refl.resourceId = resourceMan->GetOriginalID(id);
     refl.entryPoint = entryPoint;
 
-    if(!spv.spirv.empty())
+    if(!words.empty())
     {
       refl.encoding = ShaderEncoding::SPIRV;
-      refl.rawBytes.assign((byte *)spv.spirv.data(), spv.spirv.size() * sizeof(uint32_t));
+      refl.rawBytes.assign((byte *)words.data(), words.size() * sizeof(uint32_t));
     }
   }
+}
+
+void VulkanCreationInfo::ReflectShader(VulkanResourceManager *resourceMan, ResourceId id,
+                                       const std::string &entry, VkShaderStageFlagBits stage)
+{
+  ShaderModule &module = m_ShaderModule[id];
+
+  // make sure the reflection exists, so pointers to it can be taken straight away
+  ShaderModule::Reflection &reflData = module.m_Reflections[entry];
+
+  if(!reflData.entryPoint.empty())
+    return;
+
+  if(m_DeferReflection)
+    m_DeferredReflections.push_back({id, entry, stage});
+  else
+    reflData.Init(resourceMan, NULL, id, module, entry, stage);
+}
+
+void VulkanCreationInfo::ProcessDeferredReflection(VulkanResourceManager *resourceMan,
+                                                   VulkanShaderCache *cache)
+{
+  m_DeferReflection = false;
+
+  if(m_DeferredReflections.empty())
+    return;
+
+  SCOPED_TIMER("Reflecting %zu deferred shaders", m_DeferredReflections.size());
+
+  // group by module, so that each module is parsed once and is only touched by one thread.
+  std::map<ResourceId, vector<const DeferredReflection *>> modules;
+  for(const DeferredReflection &d : m_DeferredReflections)
+    modules[d.module].push_back(&d);
+
+  struct ModuleWork
+  {
+    ResourceId id;
+    ShaderModule *module;
+    vector<const DeferredReflection *> *reflections;
+  };
+
+  // look everything up on this thread, so the workers don't touch any of the maps
+  vector<ModuleWork> work;
+  work.reserve(modules.size());
+  for(auto it = modules.begin(); it != modules.end(); ++it)
+    work.push_back({it->first, &m_ShaderModule[it->first], &it->second});
+
+  Threading::ParallelFor((uint32_t)work.size(), [&work, resourceMan, cache](uint32_t i) {
+    ModuleWork &w = work[i];
+
+    for(const DeferredReflection *d : *w.reflections)
+      w.module->m_Reflections[d->entryPoint].Init(resourceMan, cache, w.id, *w.module,
+                                                  d->entryPoint, d->stage);
+
+    // everything that's needed for replay is in the reflection now, so don't keep the parsed
+    // module around. It's re-parsed on demand e.g. for disassembly.
+    w.module->ReleaseSPIRV();
+  });
+
+  m_DeferredReflections.clear();
 }
\ No newline at end of file
@@ -29,6 +29,7 @@
 #include "vk_manager.h"
 
 struct VulkanCreationInfo;
+class VulkanShaderCache;
 
 struct DescSetLayout
 {
@@ -346,11 +347,23 @@ struct VulkanCreationInfo
 
   struct ShaderModule
   {
+    ShaderModule() = default;
+    ~ShaderModule();
+
+    // no copies, the parsed module is owned
+    ShaderModule(const ShaderModule &other) = delete;
+    ShaderModule &operator=(const ShaderModule &other) = delete;
+
     void Init(VulkanResourceManager *resourceMan, VulkanCreationInfo &info,
               const VkShaderModuleCreateInfo *pCreateInfo);
 
-    SPVModule spirv;
-
+    // The SPIR-V is only parsed the first time something needs the parsed module. Most modules are
+    // only ever reflected for their pipelines, and parsing is much slower and larger than keeping
+    // the words around.
+    SPVModule &GetSPIRV();
+    const vector<uint32_t> &GetSPIRVWords() const { return spirvWords; }
+    // discard the parsed module, it will be re-parsed if needed again.
+    void ReleaseSPIRV() { SAFE_DELETE(spirv); }
     string unstrippedPath;
 
     struct Reflection
@@ -362,14 +375,37 @@ struct VulkanCreationInfo
       ShaderBindpointMapping mapping;
       SPIRVPatchData patchData;
 
-      void Init(VulkanResourceManager *resourceMan, ResourceId id, const SPVModule &spv,
-                const std::string &entry, VkShaderStageFlagBits stage);
+      // if a shader cache is given, the reflection is fetched from or added to its on-disk cache
+      void Init(VulkanResourceManager *resourceMan, VulkanShaderCache *cache, ResourceId id,
+                ShaderModule &module, const std::string &entry, VkShaderStageFlagBits stage);
     };
     map<string, Reflection> m_Reflections;
+
+  private:
+    vector<uint32_t> spirvWords;
+    SPVModule *spirv = NULL;
   };
   map<ResourceId, ShaderModule> m_ShaderModule;
 
+  // while a capture is loading, reflecting pipeline shaders is deferred and then done all at once
+  // in ProcessDeferredReflection(), which parses each module only once and spreads the modules
+  // across threads.
+  bool m_DeferReflection = false;
+
+  void ReflectShader(VulkanResourceManager *resourceMan, ResourceId id, const std::string &entry,
+                     VkShaderStageFlagBits stage);
+  void ProcessDeferredReflection(VulkanResourceManager *resourceMan, VulkanShaderCache *cache);
+
   map<ResourceId, string> m_Names;
   map<ResourceId, SwapchainInfo> m_SwapChain;
   map<ResourceId, DescSetLayout> m_DescSetLayout;
+
+private:
+  struct DeferredReflection
+  {
+    ResourceId module;
+    string entryPoint;
+    VkShaderStageFlagBits stage;
+  };
+  vector<DeferredReflection> m_DeferredReflections;
 };
@@ -34,12 +34,10 @@
 // VKTODOLOW The code pattern for creating a few contiguous arrays all in one
 // AllocAlignedBuffer for the initial contents buffer is ugly.
 
-// VKTODOLOW in general we do a lot of "create buffer, use it, flush/sync then destroy".
-// I don't know what the exact cost is, but it would be nice to batch up the buffers/etc
-// used across init state use, and only do a single flush. Also we could then get some
-// nice command buffer reuse (although need to be careful we don't create too large a
-// command buffer that stalls the GPU).
-// See INITSTATEBATCH
+// Non-sparse initial state copies are batched - each copy is submitted without waiting, and the
+// temporary buffers/images are kept in m_InitStateBatch until the batch is flushed, either when
+// enough data is in flight or once all initial contents are prepared. Sparse resources still
+// create, use, flush/sync and destroy their own temporaries. See INITSTATEBATCH
 
 bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
 {
@@ -97,7 +95,6 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
     }
 
     VkDevice d = GetDev();
-    // INITSTATEBATCH
     VkCommandBuffer cmd = GetNextCmd();
 
     ImageLayouts *layout = NULL;
@@ -351,18 +348,12 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
     vkr = ObjDisp(d)->EndCommandBuffer(Unwrap(cmd));
     RDCASSERTEQUAL(vkr, VK_SUCCESS);
 
-    // INITSTATEBATCH
-    SubmitCmds();
-    FlushQ();
-
-    ObjDisp(d)->DestroyBuffer(Unwrap(d), Unwrap(dstBuf), NULL);
-    GetResourceManager()->ReleaseWrappedResource(dstBuf);
-
+    // the temporary objects can't be destroyed until the copy has actually executed
+    m_InitStateBatch.buffers.push_back(dstBuf);
     if(arrayIm != VK_NULL_HANDLE)
-    {
-      ObjDisp(d)->DestroyImage(Unwrap(d), Unwrap(arrayIm), NULL);
-      GetResourceManager()->ReleaseWrappedResource(arrayIm);
-    }
+      m_InitStateBatch.images.push_back(arrayIm);
+
+    SubmitInitStateBatch(readbackmem.size);
 
     GetResourceManager()->SetInitialContents(id, VkInitialContents(type, readbackmem));
 
@@ -373,7 +364,6 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
     VkResult vkr = VK_SUCCESS;
 
     VkDevice d = GetDev();
-    // INITSTATEBATCH
     VkCommandBuffer cmd = GetNextCmd();
 
     VkResourceRecord *record = GetResourceManager()->GetResourceRecord(id);
@@ -437,14 +427,10 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
     vkr = ObjDisp(d)->EndCommandBuffer(Unwrap(cmd));
     RDCASSERTEQUAL(vkr, VK_SUCCESS);
 
-    // INITSTATEBATCH
-    SubmitCmds();
-    FlushQ();
+    m_InitStateBatch.buffers.push_back(srcBuf);
+    m_InitStateBatch.buffers.push_back(dstBuf);
 
-    ObjDisp(d)->DestroyBuffer(Unwrap(d), Unwrap(srcBuf), NULL);
-    ObjDisp(d)->DestroyBuffer(Unwrap(d), Unwrap(dstBuf), NULL);
-    GetResourceManager()->ReleaseWrappedResource(srcBuf);
-    GetResourceManager()->ReleaseWrappedResource(dstBuf);
+    SubmitInitStateBatch(readbackmem.size);
 
     GetResourceManager()->SetInitialContents(id, VkInitialContents(type, readbackmem));
 
@@ -458,6 +444,45 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
   return false;
 }
 
+// how much readback data can be queued up in initial state copies before we wait for the GPU to
+// catch up. This bounds how many command buffers and temporary objects are in flight at once.
+static const VkDeviceSize InitStateBatchSize = 256 * 1024 * 1024;
+
+void WrappedVulkan::SubmitInitStateBatch(VkDeviceSize copySize)
+{
+  // submit without waiting, so that the GPU can get on with this copy while we record the next one
+  SubmitCmds();
+
+  m_InitStateBatch.pendingBytes += copySize;
+
+  if(m_InitStateBatch.pendingBytes >= InitStateBatchSize)
+    FlushInitStateBatch();
+}
+
+void WrappedVulkan::FlushInitStateBatch()
+{
+  SubmitCmds();
+  FlushQ();
+
+  VkDevice d = GetDev();
+
+  for(VkBuffer buf : m_InitStateBatch.buffers)
+  {
+    ObjDisp(d)->DestroyBuffer(Unwrap(d), Unwrap(buf), NULL);
+    GetResourceManager()->ReleaseWrappedResource(buf);
+  }
+
+  for(VkImage im : m_InitStateBatch.images)
+  {
+    ObjDisp(d)->DestroyImage(Unwrap(d), Unwrap(im), NULL);
+    GetResourceManager()->ReleaseWrappedResource(im);
+  }
+
+  m_InitStateBatch.buffers.clear();
+  m_InitStateBatch.images.clear();
+  m_InitStateBatch.pendingBytes = 0;
+}
+
 uint32_t WrappedVulkan::GetSize_InitialState(ResourceId id, WrappedVkRes *res)
 {
   VkResourceRecord *record = GetResourceManager()->GetResourceRecord(id);
@@ -487,7 +512,14 @@ uint32_t WrappedVulkan::GetSize_InitialState(ResourceId id, WrappedVkRes *res)
       return GetSize_SparseInitialState(id, res);
 
     // the size primarily comes from the buffer, the size of which we conveniently have stored.
-    return uint32_t(128 + initContents.mem.size + WriteSerialiser::GetChunkAlignment());
+    uint64_t contentsSize = initContents.mem.size;
+
+    // with a blob store only a reference is written, and the chunk would otherwise be padded out to
+    // the full contents size.
+    if(m_InitialContentsBlobs && contentsSize >= BlobStore::MinimumBlobSize)
+      contentsSize = 0;
+
+    return uint32_t(128 + contentsSize + WriteSerialiser::GetChunkAlignment());
   }
 
   RDCERR("Unhandled resource type %s", ToStr(type).c_str());
@@ -511,6 +543,8 @@ const char *NameOfType(VkResourceType type)
 template <typename SerialiserType>
 bool WrappedVulkan::Serialise_InitialState(SerialiserType &ser, ResourceId id, WrappedVkRes *)
 {
+  SCOPED_PROBE(SerialiseInitialState);
+
   VkResourceType type;
 
   VkResourceRecord *record = NULL;
@@ -1226,7 +1226,7 @@ void VulkanReplay::InitPostVSBuffers(uint32_t eventId)
   }
 
   uint32_t bufStride = 0;
-  vector<uint32_t> modSpirv = moduleInfo.spirv.spirv;
+  vector<uint32_t> modSpirv = moduleInfo.GetSPIRVWords();
 
   struct CompactedAttrBuffer
   {
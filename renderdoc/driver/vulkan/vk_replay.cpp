@@ -308,12 +308,14 @@ rdcarray<ShaderEntryPoint> VulkanReplay::GetShaderEntryPoints(ResourceId shader)
   if(shad == m_pDriver->m_CreationInfo.m_ShaderModule.end())
     return {};
 
-  std::vector<std::string> entries = shad->second.spirv.EntryPoints();
+  const SPVModule &spirv = shad->second.GetSPIRV();
+
+  std::vector<std::string> entries = spirv.EntryPoints();
 
   rdcarray<ShaderEntryPoint> ret;
 
   for(const std::string &e : entries)
-    ret.push_back({e, shad->second.spirv.StageForEntry(e)});
+    ret.push_back({e, spirv.StageForEntry(e)});
 
   return ret;
 }
@@ -328,8 +330,8 @@ ShaderReflection *VulkanReplay::GetShader(ResourceId shader, ShaderEntryPoint en
     return NULL;
   }
 
-  shad->second.m_Reflections[entry.name].Init(GetResourceManager(), shader, shad->second.spirv,
-                                              entry.name,
+  shad->second.m_Reflections[entry.name].Init(GetResourceManager(), m_pDriver->GetShaderCache(),
+                                              shader, shad->second, entry.name,
                                               VkShaderStageFlagBits(1 << uint32_t(entry.stage)));
 
   return &shad->second.m_Reflections[entry.name].refl;
@@ -368,7 +370,16 @@ string VulkanReplay::DisassembleShader(ResourceId pipeline, const ShaderReflecti
     std::string &disasm = it->second.m_Reflections[refl->entryPoint.c_str()].disassembly;
 
     if(disasm.empty())
-      disasm = it->second.spirv.Disassemble(refl->entryPoint.c_str());
+    {
+      VulkanShaderCache *cache = m_pDriver->GetShaderCache();
+      const vector<uint32_t> &words = it->second.GetSPIRVWords();
+
+      if(!cache->GetCachedDisassembly(words, refl->entryPoint, disasm))
+      {
+        disasm = it->second.GetSPIRV().Disassemble(refl->entryPoint.c_str());
+        cache->CacheDisassembly(words, refl->entryPoint, disasm);
+      }
+    }
 
     return disasm;
   }
@@ -2200,6 +2211,14 @@ vector<EventUsage> VulkanReplay::GetUsage(ResourceId id)
   return m_pDriver->GetUsage(id);
 }
 
+ResourceUsageIndex VulkanReplay::GetUsageIndex()
+{
+  ResourceUsageIndex ret;
+  ret.Build(m_pDriver->GetAllUsage(),
+            [this](ResourceId id) { return m_pDriver->GetResourceManager()->GetOriginalID(id); });
+  return ret;
+}
+
 void VulkanReplay::GetTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t mip,
                                   const GetTextureDataParams &params, bytebuf &data)
 {
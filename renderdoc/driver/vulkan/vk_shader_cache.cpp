@@ -23,7 +23,8 @@
  ******************************************************************************/
 
 #include "vk_shader_cache.h"
-#include "common/shader_cache.h"
+#include "3rdparty/zstd/xxhash.h"
+#include "api/replay/version.h"
 #include "data/glsl_shaders.h"
 #include "driver/shaders/spirv/spirv_common.h"
 #include "strings/string_utils.h"
@@ -91,7 +92,7 @@ RDCCOMPILE_ASSERT(ARRAY_COUNT(builtinShaders) == arraydim<BuiltinShader>(),
 
 struct VulkanBlobShaderCallbacks
 {
-  bool Create(uint32_t size, byte *data, SPIRVBlob *ret) const
+  bool Create(uint32_t size, const byte *data, SPIRVBlob *ret) const
   {
     RDCASSERT(ret);
 
@@ -111,14 +112,43 @@ struct VulkanBlobShaderCallbacks
   const byte *GetData(SPIRVBlob blob) const { return (const byte *)blob->data(); }
 } VulkanShaderCacheCallbacks;
 
-VulkanShaderCache::VulkanShaderCache(WrappedVulkan *driver)
+// the different kinds of data stored in the reflection cache. The build entry, with a hash of 0,
+// holds the version of the code that generated everything else since the reflection isn't valid for
+// another build.
+enum class ReflectionCacheType : uint32_t
 {
-  // Load shader cache, if present
-  bool success = LoadShaderCache("vkshaders.cache", m_ShaderCacheMagic, m_ShaderCacheVersion,
-                                 m_ShaderCache, VulkanShaderCacheCallbacks);
+  Build = 0,
+  Reflection,
+  Disassembly,
+};
+
+// new entries aren't added to the reflection cache once it reaches this size, so that it can't grow
+// without bound as more and more different captures are opened.
+static const uint64_t MaxReflectionCacheSize = 128 * 1024 * 1024;
 
-  // if we failed to load from the cache
-  m_ShaderCacheDirty = !success;
+DECLARE_REFLECTION_STRUCT(SPIRVPatchData::InterfaceAccess);
+DECLARE_REFLECTION_STRUCT(SPIRVPatchData);
+
+template <class SerialiserType>
+void DoSerialise(SerialiserType &ser, SPIRVPatchData::InterfaceAccess &el)
+{
+  SERIALISE_MEMBER(ID);
+  SERIALISE_MEMBER(accessChain);
+  SERIALISE_MEMBER(isMatrix);
+}
+
+template <class SerialiserType>
+void DoSerialise(SerialiserType &ser, SPIRVPatchData &el)
+{
+  SERIALISE_MEMBER(inputs);
+  SERIALISE_MEMBER(outputs);
+}
+
+VulkanShaderCache::VulkanShaderCache(WrappedVulkan *driver)
+{
+  // open the shader cache, nothing is read from it until a shader is looked up
+  m_ShaderCache = new ShaderCache<SPIRVBlob, VulkanBlobShaderCallbacks>(
+      "vkshaders.cache", m_ShaderCacheMagic, m_ShaderCacheVersion, VulkanShaderCacheCallbacks);
 
   m_pDriver = driver;
   m_Device = driver->GetDev();
@@ -184,45 +214,316 @@ VulkanShaderCache::VulkanShaderCache(WrappedVulkan *driver)
   }
 
   SetCaching(false);
+
+  // pipelines are only created and shaders only reflected from the capture on replay
+  if(IsReplayMode(driver->GetState()))
+  {
+    CreatePipelineCache();
+
+    m_ReflectionCache =
+        new ShaderCacheFile(FileIO::GetAppFolderFilename("vkreflection.cache"),
+                            m_ReflectionCacheMagic, m_ReflectionCacheVersion);
+
+    // identify the build that reflected the cached shaders. Builds without a git hash all share
+    // the same placeholder, so for those the library's modification time tells builds apart.
+    std::string buildKey = StringFormat::Fmt("%s %u", GitVersionHash, m_ReflectionCacheVersion);
+
+    if(!strncmp(GitVersionHash, "NO_GIT_COMMIT_HASH", 18))
+    {
+      std::string library;
+      FileIO::GetLibraryFilename(library);
+      buildKey += StringFormat::Fmt(" %llu", FileIO::GetModifiedTimestamp(library));
+    }
+
+    const byte *build = NULL;
+    uint32_t buildSize = 0;
+
+    // throw away everything if the cache was written by a different build
+    if(!m_ReflectionCache->Find((uint64_t)ReflectionCacheType::Build, build, buildSize) ||
+       buildSize != buildKey.size() || memcmp(build, buildKey.data(), buildSize))
+    {
+      m_ReflectionCache->Clear();
+      m_ReflectionCache->Add((uint64_t)ReflectionCacheType::Build, (const byte *)buildKey.data(),
+                             (uint32_t)buildKey.size());
+    }
+  }
 }
 
 VulkanShaderCache::~VulkanShaderCache()
 {
-  if(m_ShaderCacheDirty)
+  if(m_PipelineCache != VK_NULL_HANDLE)
   {
-    SaveShaderCache("vkshaders.cache", m_ShaderCacheMagic, m_ShaderCacheVersion, m_ShaderCache,
-                    VulkanShaderCacheCallbacks);
+    SavePipelineCache();
+
+    ObjDisp(m_Device)->DestroyPipelineCache(Unwrap(m_Device), m_PipelineCache, NULL);
   }
-  else
+
+  SAFE_DELETE(m_ShaderCache);
+
+  if(m_ReflectionCache && m_ReflectionHits + m_ReflectionMisses > 0)
   {
-    for(auto it = m_ShaderCache.begin(); it != m_ShaderCache.end(); ++it)
-      VulkanShaderCacheCallbacks.Destroy(it->second);
+    RDCLOG("SPIR-V reflection cache: %u hits, %u misses, %llu entries (%llu bytes)",
+           m_ReflectionHits, m_ReflectionMisses, m_ReflectionCache->GetEntryCount(),
+           m_ReflectionCache->GetSize());
   }
 
+  SAFE_DELETE(m_ReflectionCache);
+
   for(size_t i = 0; i < ARRAY_COUNT(m_BuiltinShaderModules); i++)
     m_pDriver->vkDestroyShaderModule(m_Device, m_BuiltinShaderModules[i], NULL);
 }
 
+static uint64_t GetReflectionHash(const std::vector<uint32_t> &spirv, const std::string &entry,
+                                  ReflectionCacheType type, ShaderStage stage)
+{
+  uint64_t hash = XXH64(spirv.data(), spirv.size() * sizeof(uint32_t), (uint64_t)type);
+  hash = XXH64(entry.c_str(), entry.size(), hash);
+  hash = XXH64(&stage, sizeof(stage), hash);
+  return hash;
+}
+
+bool VulkanShaderCache::GetCachedReflection(const std::vector<uint32_t> &spirv,
+                                            const std::string &entry, ShaderStage stage,
+                                            ShaderReflection &refl, ShaderBindpointMapping &mapping,
+                                            SPIRVPatchData &patchData)
+{
+  if(!m_ReflectionCache)
+    return false;
+
+  uint64_t hash = GetReflectionHash(spirv, entry, ReflectionCacheType::Reflection, stage);
+
+  SCOPED_LOCK(m_ReflectionLock);
+
+  const byte *data = NULL;
+  uint32_t size = 0;
+
+  if(m_ReflectionCache->Find(hash, data, size))
+  {
+    ReadSerialiser ser(new StreamReader(data, size), Ownership::Stream);
+
+    ser.Serialise("refl", refl);
+    ser.Serialise("mapping", mapping);
+    ser.Serialise("patchData", patchData);
+
+    if(!ser.IsErrored())
+    {
+      m_ReflectionHits++;
+      return true;
+    }
+
+    RDCWARN("Corrupt entry in SPIR-V reflection cache");
+  }
+
+  m_ReflectionMisses++;
+  return false;
+}
+
+void VulkanShaderCache::CacheReflection(const std::vector<uint32_t> &spirv,
+                                        const std::string &entry, ShaderStage stage,
+                                        ShaderReflection &refl, ShaderBindpointMapping &mapping,
+                                        SPIRVPatchData &patchData)
+{
+  if(!m_ReflectionCache)
+    return;
+
+  uint64_t hash = GetReflectionHash(spirv, entry, ReflectionCacheType::Reflection, stage);
+
+  // serialise outside of the lock, since this can be called from several threads at once
+  WriteSerialiser ser(new StreamWriter(4 * 1024), Ownership::Stream);
+
+  ser.Serialise("refl", refl);
+  ser.Serialise("mapping", mapping);
+  ser.Serialise("patchData", patchData);
+
+  StreamWriter *writer = ser.GetWriter();
+
+  SCOPED_LOCK(m_ReflectionLock);
+
+  if(m_ReflectionCache->GetSize() + writer->GetOffset() <= MaxReflectionCacheSize)
+    m_ReflectionCache->Add(hash, writer->GetData(), (uint32_t)writer->GetOffset());
+}
+
+bool VulkanShaderCache::GetCachedDisassembly(const std::vector<uint32_t> &spirv,
+                                             const std::string &entry, std::string &disasm)
+{
+  if(!m_ReflectionCache)
+    return false;
+
+  uint64_t hash =
+      GetReflectionHash(spirv, entry, ReflectionCacheType::Disassembly, ShaderStage::Count);
+
+  SCOPED_LOCK(m_ReflectionLock);
+
+  const byte *data = NULL;
+  uint32_t size = 0;
+
+  if(m_ReflectionCache->Find(hash, data, size))
+  {
+    m_ReflectionHits++;
+    disasm.assign((const char *)data, size);
+    return true;
+  }
+
+  m_ReflectionMisses++;
+  return false;
+}
+
+void VulkanShaderCache::CacheDisassembly(const std::vector<uint32_t> &spirv,
+                                         const std::string &entry, const std::string &disasm)
+{
+  if(!m_ReflectionCache)
+    return;
+
+  uint64_t hash =
+      GetReflectionHash(spirv, entry, ReflectionCacheType::Disassembly, ShaderStage::Count);
+
+  SCOPED_LOCK(m_ReflectionLock);
+
+  if(m_ReflectionCache->GetSize() + disasm.size() <= MaxReflectionCacheSize)
+    m_ReflectionCache->Add(hash, (const byte *)disasm.data(), (uint32_t)disasm.size());
+}
+
+// the pipeline cache is never loaded or saved when it grows beyond this, so that it can't grow
+// without bound as more and more different captures are opened.
+static const size_t MaxPipelineCacheSize = 256 * 1024 * 1024;
+
+std::string VulkanShaderCache::GetPipelineCacheFilename()
+{
+  // the driver ignores any cache data that isn't compatible, but keying on the UUID lets several
+  // devices or driver versions each keep their own cache.
+  const uint8_t *uuid = m_pDriver->GetDeviceProps().pipelineCacheUUID;
+
+  std::string filename = "vkpipelines_";
+  for(size_t i = 0; i < VK_UUID_SIZE; i++)
+    filename += StringFormat::Fmt("%02x", uuid[i]);
+  filename += ".cache";
+
+  return FileIO::GetAppFolderFilename(filename);
+}
+
+void VulkanShaderCache::CreatePipelineCache()
+{
+  std::vector<byte> data;
+
+  std::string filename = GetPipelineCacheFilename();
+
+  FILE *f = FileIO::fopen(filename.c_str(), "rb");
+
+  if(f)
+  {
+    FileIO::fseek64(f, 0, SEEK_END);
+    uint64_t len = FileIO::ftell64(f);
+    FileIO::fseek64(f, 0, SEEK_SET);
+
+    if(len <= MaxPipelineCacheSize)
+    {
+      data.resize((size_t)len);
+      if(FileIO::fread(data.data(), 1, data.size(), f) != data.size())
+        data.clear();
+    }
+    else
+    {
+      RDCWARN("Pipeline cache %s is too large at %llu bytes, starting again", filename.c_str(),
+              len);
+    }
+
+    FileIO::fclose(f);
+  }
+
+  VkPipelineCacheCreateInfo cacheInfo = {
+      VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO, NULL, 0, data.size(), data.data(),
+  };
+
+  VkResult vkr =
+      ObjDisp(m_Device)->CreatePipelineCache(Unwrap(m_Device), &cacheInfo, NULL, &m_PipelineCache);
+
+  // invalid data should be ignored by the driver, but in case it isn't try again empty
+  if(vkr != VK_SUCCESS && !data.empty())
+  {
+    RDCWARN("Couldn't create pipeline cache from %s: %s", filename.c_str(), ToStr(vkr).c_str());
+
+    data.clear();
+    cacheInfo.initialDataSize = 0;
+    cacheInfo.pInitialData = NULL;
+
+    vkr = ObjDisp(m_Device)->CreatePipelineCache(Unwrap(m_Device), &cacheInfo, NULL,
+                                                 &m_PipelineCache);
+  }
+
+  if(vkr != VK_SUCCESS)
+  {
+    RDCERR("Couldn't create pipeline cache: %s", ToStr(vkr).c_str());
+    m_PipelineCache = VK_NULL_HANDLE;
+    return;
+  }
+
+  m_PipelineCacheLoadedSize = data.size();
+
+  if(!data.empty())
+    RDCLOG("Loaded %zu bytes of pipeline cache data", data.size());
+}
+
+void VulkanShaderCache::SavePipelineCache()
+{
+  size_t size = 0;
+  VkResult vkr =
+      ObjDisp(m_Device)->GetPipelineCacheData(Unwrap(m_Device), m_PipelineCache, &size, NULL);
+
+  // drivers only add to the cache, so if it's the same size there's nothing new to save.
+  if(vkr != VK_SUCCESS || size == 0 || size == m_PipelineCacheLoadedSize)
+    return;
+
+  if(size > MaxPipelineCacheSize)
+  {
+    RDCWARN("Not saving pipeline cache, %zu bytes is too large", size);
+    return;
+  }
+
+  std::vector<byte> data;
+  data.resize(size);
+
+  vkr = ObjDisp(m_Device)->GetPipelineCacheData(Unwrap(m_Device), m_PipelineCache, &size,
+                                                data.data());
+
+  if(vkr != VK_SUCCESS)
+  {
+    RDCERR("Couldn't get pipeline cache data: %s", ToStr(vkr).c_str());
+    return;
+  }
+
+  std::string filename = GetPipelineCacheFilename();
+
+  FILE *f = FileIO::fopen(filename.c_str(), "wb");
+
+  if(!f)
+  {
+    RDCERR("Error opening pipeline cache %s for write", filename.c_str());
+    return;
+  }
+
+  FileIO::fwrite(data.data(), 1, size, f);
+  FileIO::fclose(f);
+
+  RDCLOG("Saved %zu bytes of pipeline cache data", size);
+}
+
 std::string VulkanShaderCache::GetSPIRVBlob(const SPIRVCompilationSettings &settings,
                                             const std::vector<std::string> &sources,
                                             SPIRVBlob &outBlob)
 {
   RDCASSERT(sources.size() > 0);
 
-  uint32_t hash = strhash(sources[0].c_str());
-  for(size_t i = 1; i < sources.size(); i++)
-    hash = strhash(sources[i].c_str(), hash);
+  uint64_t hash = 0;
+  for(size_t i = 0; i < sources.size(); i++)
+    hash = XXH64(sources[i].c_str(), sources[i].size(), hash);
 
   char typestr[3] = {'a', 'a', 0};
   typestr[0] += (char)settings.stage;
   typestr[1] += (char)settings.lang;
-  hash = strhash(typestr, hash);
+  hash = XXH64(typestr, 2, hash);
 
-  if(m_ShaderCache.find(hash) != m_ShaderCache.end())
-  {
-    outBlob = m_ShaderCache[hash];
+  if(m_ShaderCache->Find(hash, outBlob))
     return "";
-  }
 
   SPIRVBlob spirv = new std::vector<uint32_t>();
   std::string errors = CompileSPIRV(settings, sources, *spirv);
@@ -243,10 +544,7 @@ std::string VulkanShaderCache::GetSPIRVBlob(const SPIRVCompilationSettings &sett
   outBlob = spirv;
 
   if(m_CacheShaders)
-  {
-    m_ShaderCache[hash] = spirv;
-    m_ShaderCacheDirty = true;
-  }
+    m_ShaderCache->Add(hash, spirv);
 
   return errors;
 }
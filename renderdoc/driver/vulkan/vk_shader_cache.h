@@ -25,11 +25,14 @@
 #pragma once
 
 #include "api/replay/renderdoc_replay.h"
+#include "common/shader_cache.h"
 #include "core/core.h"
 #include "vk_core.h"
 
 typedef std::vector<uint32_t> *SPIRVBlob;
 
+struct VulkanBlobShaderCallbacks;
+
 enum class BuiltinShader
 {
   BlitVS,
@@ -76,15 +79,48 @@ public:
   void MakeComputePipelineInfo(VkComputePipelineCreateInfo &pipeCreateInfo, ResourceId pipeline);
 
   void SetCaching(bool enabled) { m_CacheShaders = enabled; }
+  // unwrapped driver pipeline cache to use for any pipelines created on replay. It's saved to disk
+  // per device on shutdown, so re-opening a capture doesn't pay to compile its pipelines again.
+  VkPipelineCache GetPipelineCache() { return m_PipelineCache; }
+  // reflection and disassembly of SPIR-V modules is cached on disk keyed by the module contents, so
+  // shaders that appear again in later captures don't need to be parsed or reflected. These can be
+  // called from several threads at once.
+  bool GetCachedReflection(const std::vector<uint32_t> &spirv, const std::string &entry,
+                           ShaderStage stage, ShaderReflection &refl,
+                           ShaderBindpointMapping &mapping, SPIRVPatchData &patchData);
+  void CacheReflection(const std::vector<uint32_t> &spirv, const std::string &entry,
+                       ShaderStage stage, ShaderReflection &refl, ShaderBindpointMapping &mapping,
+                       SPIRVPatchData &patchData);
+  bool GetCachedDisassembly(const std::vector<uint32_t> &spirv, const std::string &entry,
+                            std::string &disasm);
+  void CacheDisassembly(const std::vector<uint32_t> &spirv, const std::string &entry,
+                        const std::string &disasm);
+
 private:
   static const uint32_t m_ShaderCacheMagic = 0xf00d00d5;
-  static const uint32_t m_ShaderCacheVersion = 1;
+  static const uint32_t m_ShaderCacheVersion = 2;
+
+  static const uint32_t m_ReflectionCacheMagic = 0xf00d00d6;
+  // bump this whenever the SPIR-V reflection output or the serialisation of ShaderReflection,
+  // ShaderBindpointMapping or SPIRVPatchData changes, so that stale entries are discarded.
+  static const uint32_t m_ReflectionCacheVersion = 2;
+
+  std::string GetPipelineCacheFilename();
+  void CreatePipelineCache();
+  void SavePipelineCache();
 
   WrappedVulkan *m_pDriver = NULL;
   VkDevice m_Device = VK_NULL_HANDLE;
 
-  bool m_ShaderCacheDirty = false, m_CacheShaders = false;
-  std::map<uint32_t, SPIRVBlob> m_ShaderCache;
+  bool m_CacheShaders = false;
+  ShaderCache<SPIRVBlob, VulkanBlobShaderCallbacks> *m_ShaderCache = NULL;
+
+  Threading::CriticalSection m_ReflectionLock;
+  uint32_t m_ReflectionHits = 0, m_ReflectionMisses = 0;
+  ShaderCacheFile *m_ReflectionCache = NULL;
+
+  VkPipelineCache m_PipelineCache = VK_NULL_HANDLE;
+  size_t m_PipelineCacheLoadedSize = 0;
 
   SPIRVBlob m_BuiltinShaderBlobs[arraydim<BuiltinShader>()] = {NULL};
   VkShaderModule m_BuiltinShaderModules[arraydim<BuiltinShader>()] = {VK_NULL_HANDLE};
@@ -423,6 +423,7 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
                                       const VkSubmitInfo *pSubmits, VkFence fence)
 {
   SCOPED_DBG_SINK();
+  SCOPED_PROBE(QueueSubmit);
 
   if(!m_MarkedActive)
   {
@@ -584,6 +585,9 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
   SERIALISE_TIME_CALL(ret = ObjDisp(queue)->QueueSubmit(Unwrap(queue), submitCount,
                                                         unwrappedSubmits, Unwrap(fence)));
 
+  // everything from here on is our own tracking, after the real submit has returned
+  SCOPED_FRAME_OVERHEAD();
+
   bool capframe = false;
   set<ResourceId> refdIDs;
 
@@ -766,6 +770,8 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
             state.mapFlushed = false;
           }
 
+          RenderDoc::Inst().AddCoherentMapBytes(diffEnd - diffStart);
+
           GetResourceManager()->MarkPendingDirty(record->GetResourceID());
         }
         else
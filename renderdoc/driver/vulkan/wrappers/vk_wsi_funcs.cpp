@@ -617,6 +617,8 @@ VkResult WrappedVulkan::vkQueuePresentKHR(VkQueue queue, const VkPresentInfoKHR
 {
   if(IsBackgroundCapturing(m_State))
   {
+    SCOPED_FRAME_OVERHEAD();
+
     RenderDoc::Inst().Tick();
 
     GetResourceManager()->FlushPendingDirty();
@@ -659,6 +661,8 @@ VkResult WrappedVulkan::vkQueuePresentKHR(VkQueue queue, const VkPresentInfoKHR
 
   if(IsBackgroundCapturing(m_State))
   {
+    SCOPED_FRAME_OVERHEAD();
+
     uint32_t overlay = RenderDoc::Inst().GetOverlayBits();
 
     if(overlay & eRENDERDOC_Overlay_Enabled)
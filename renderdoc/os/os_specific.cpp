@@ -196,6 +196,7 @@ string OSUtility::MakeMachineIdentString(uint64_t ident)
 #if ENABLED(ENABLE_UNIT_TESTS)
 
 #include "3rdparty/catch/catch.hpp"
+#include "common/threading.h"
 
 TEST_CASE("Test OS-specific functions", "[osspecific]")
 {
@@ -559,6 +560,68 @@ TEST_CASE("Test OS-specific functions", "[osspecific]")
       lock.Unlock();
   };
 
+  SECTION("Conditions")
+  {
+    // a producer hands values over one at a time, each side waiting for the other
+    Threading::CriticalSection lock;
+    Threading::Condition cond;
+    int32_t value = 0;
+    int32_t consumed = 0;
+
+    Threading::ThreadHandle th = Threading::CreateThread([&lock, &cond, &value, &consumed]() {
+      for(int32_t i = 1; i <= 100; i++)
+      {
+        SCOPED_LOCK(lock);
+        while(value != 0)
+          cond.Wait(lock);
+        value = i;
+        cond.NotifyAll();
+      }
+    });
+
+    {
+      SCOPED_LOCK(lock);
+      for(int32_t i = 1; i <= 100; i++)
+      {
+        while(value == 0)
+          cond.Wait(lock);
+        CHECK(value == i);
+        consumed++;
+        value = 0;
+        cond.NotifyAll();
+      }
+    }
+
+    Threading::JoinThread(th);
+    Threading::CloseThread(th);
+
+    CHECK(consumed == 100);
+  };
+
+  SECTION("Parallel for")
+  {
+    CHECK(Threading::GetLogicalCoreCount() >= 1);
+
+    std::vector<int32_t> hits(1000, 0);
+    volatile int32_t total = 0;
+
+    Threading::ParallelFor((uint32_t)hits.size(), [&hits, &total](uint32_t i) {
+      hits[i]++;
+      Atomic::Inc32(&total);
+    });
+
+    CHECK(total == 1000);
+
+    // every index is visited exactly once
+    for(int32_t h : hits)
+      CHECK(h == 1);
+
+    // nothing to do is fine too
+    Threading::ParallelFor(0, [&total](uint32_t i) { Atomic::Inc32(&total); });
+
+    CHECK(total == 1000);
+  };
+
   SECTION("IP processing")
   {
     CHECK(Network::MakeIP(127, 0, 0, 1) == 0x7f000001);
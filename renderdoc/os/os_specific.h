@@ -89,6 +89,9 @@ uint64_t GetUnixTimestamp();
 
 namespace Threading
 {
+template <class data, class lockdata>
+class ConditionTemplate;
+
 template <class data>
 class CriticalSectionTemplate
 {
@@ -104,6 +107,29 @@ private:
   CriticalSectionTemplate &operator=(const CriticalSectionTemplate &other);
   CriticalSectionTemplate(const CriticalSectionTemplate &other);
 
+  template <class, class>
+  friend class ConditionTemplate;
+
+  data m_Data;
+};
+
+// a condition to wait on while holding a CriticalSection. The lock must be held exactly once, it's
+// released while waiting and reacquired before Wait returns. Waits can wake spuriously, so callers
+// must re-check what they're waiting for.
+template <class data, class lockdata>
+class ConditionTemplate
+{
+public:
+  ConditionTemplate();
+  ~ConditionTemplate();
+  void Wait(CriticalSectionTemplate<lockdata> &lock);
+  void NotifyAll();
+
+private:
+  // no copying
+  ConditionTemplate &operator=(const ConditionTemplate &other);
+  ConditionTemplate(const ConditionTemplate &other);
+
   data m_Data;
 };
 
@@ -114,7 +140,7 @@ uint64_t AllocateTLSSlot();
 void *GetTLSValue(uint64_t slot);
 void SetTLSValue(uint64_t slot, void *value);
 
-// must typedef CriticalSectionTemplate<X> CriticalSection
+// must typedef CriticalSectionTemplate<X> CriticalSection and ConditionTemplate<Y, X> Condition
 
 typedef uint64_t ThreadHandle;
 ThreadHandle CreateThread(std::function<void()> entryFunc);
@@ -122,6 +148,7 @@ uint64_t GetCurrentID();
 void JoinThread(ThreadHandle handle);
 void CloseThread(ThreadHandle handle);
 void Sleep(uint32_t milliseconds);
+uint32_t GetLogicalCoreCount();
 
 // kind of windows specific, to handle this case:
 // http://blogs.msdn.com/b/oldnewthing/archive/2013/11/05/10463645.aspx
@@ -149,6 +176,8 @@ public:
   bool IsRecvDataWaiting();
 
   bool SendDataBlocking(const void *buf, uint32_t length);
+  // sends both buffers in order, as one gathered write where possible.
+  bool SendDataBlocking(const void *buf1, uint32_t length1, const void *buf2, uint32_t length2);
   bool RecvDataBlocking(void *data, uint32_t length);
   bool RecvDataNonBlocking(void *data, uint32_t &length);
 
@@ -196,6 +225,7 @@ int32_t Dec32(volatile int32_t *i);
 int64_t Inc64(volatile int64_t *i);
 int64_t Dec64(volatile int64_t *i);
 int64_t ExchAdd64(volatile int64_t *i, int64_t a);
+int64_t Exch64(volatile int64_t *i, int64_t newVal);
 int32_t CmpExch32(volatile int32_t *dest, int32_t oldVal, int32_t newVal);
 };
 
@@ -254,6 +284,7 @@ string GetFullPathname(const string &filename);
 string FindFileInPath(const string &fileName);
 
 void GetExecutableFilename(string &selfName);
+void GetLibraryFilename(string &selfName);
 
 uint64_t GetModifiedTimestamp(const string &filename);
 
@@ -264,6 +295,11 @@ std::vector<PathEntry> GetFilesInDirectory(const char *path);
 
 FILE *fopen(const char *filename, const char *mode);
 
+// maps a whole file read-only into memory, returns NULL if it can't be opened or is empty. The file
+// can be appended to while it's mapped, but won't be visible past the mapped size.
+const byte *MapFile(const char *filename, uint64_t &size);
+void UnmapFile(const byte *data, uint64_t size);
+
 size_t fread(void *buf, size_t elementSize, size_t count, FILE *f);
 size_t fwrite(const void *buf, size_t elementSize, size_t count, FILE *f);
 
@@ -27,11 +27,13 @@
 #include <netdb.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
+#include <poll.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 #include <unistd.h>
 #include <string>
@@ -130,37 +132,79 @@ Socket *Socket::AcceptClient(bool wait)
   return NULL;
 }
 
-bool Socket::SendDataBlocking(const void *buf, uint32_t length)
+// sockets are always left in non-blocking mode. Rather than switching to blocking mode with a
+// timeout around every blocking send or receive, which costs several extra syscalls each time, we
+// only wait when the socket isn't ready.
+static bool WaitForSocket(int socket, short events, uint32_t timeoutMS)
 {
-  if(length == 0)
-    return true;
+  pollfd pfd = {};
+  pfd.fd = socket;
+  pfd.events = events;
 
-  uint32_t sent = 0;
+  int ret = 0;
+
+  do
+  {
+    ret = poll(&pfd, 1, (int)timeoutMS);
+  } while(ret < 0 && errno == EINTR);
 
-  char *src = (char *)buf;
+  return ret > 0;
+}
 
-  int flags = fcntl(socket, F_GETFL, 0);
-  fcntl(socket, F_SETFL, flags & ~O_NONBLOCK);
+bool Socket::SendDataBlocking(const void *buf, uint32_t length)
+{
+  return SendDataBlocking(buf, length, NULL, 0);
+}
 
-  timeval oldtimeout = {0};
-  socklen_t len = sizeof(oldtimeout);
-  getsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, (char *)&oldtimeout, &len);
+bool Socket::SendDataBlocking(const void *buf1, uint32_t length1, const void *buf2,
+                              uint32_t length2)
+{
+  iovec iov[2];
+  iov[0].iov_base = (void *)buf1;
+  iov[0].iov_len = length1;
+  iov[1].iov_base = (void *)buf2;
+  iov[1].iov_len = length2;
 
-  timeval timeout = {0};
-  timeout.tv_sec = (timeoutMS / 1000);
-  timeout.tv_usec = (timeoutMS % 1000) * 1000;
-  setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, (const char *)&timeout, sizeof(timeout));
+  iovec *vec = iov;
+  int count = 2;
+  size_t sent = 0;
 
-  while(sent < length)
+  for(;;)
   {
-    int ret = send(socket, src, length - sent, 0);
+    // skip past whatever has been sent, including any empty buffers
+    while(count > 0 && sent >= vec->iov_len)
+    {
+      sent -= vec->iov_len;
+      vec++;
+      count--;
+    }
+
+    if(count == 0)
+      break;
+
+    vec->iov_base = (char *)vec->iov_base + sent;
+    vec->iov_len -= sent;
+
+    msghdr msg = {};
+    msg.msg_iov = vec;
+    msg.msg_iovlen = count;
+
+    ssize_t ret = sendmsg((int)socket, &msg, 0);
 
     if(ret <= 0)
     {
       int err = errno;
 
-      if(err == EWOULDBLOCK || err == EAGAIN)
+      sent = 0;
+
+      if(ret < 0 && err == EINTR)
+        continue;
+
+      if(ret < 0 && (err == EWOULDBLOCK || err == EAGAIN))
       {
+        if(WaitForSocket((int)socket, POLLOUT, timeoutMS))
+          continue;
+
         RDCWARN("Timeout in send");
         Shutdown();
         return false;
@@ -173,17 +217,9 @@ bool Socket::SendDataBlocking(const void *buf, uint32_t length)
       }
     }
 
-    sent += ret;
-    src += ret;
+    sent = (size_t)ret;
   }
 
-  flags = fcntl(socket, F_GETFL, 0);
-  fcntl(socket, F_SETFL, flags | O_NONBLOCK);
-
-  setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, (const char *)&oldtimeout, sizeof(oldtimeout));
-
-  RDCASSERT(sent == length);
-
   return true;
 }
 
@@ -250,40 +286,31 @@ bool Socket::RecvDataNonBlocking(void *buf, uint32_t &length)
 
 bool Socket::RecvDataBlocking(void *buf, uint32_t length)
 {
-  if(length == 0)
-    return true;
-
   uint32_t received = 0;
 
   char *dst = (char *)buf;
 
-  int flags = fcntl(socket, F_GETFL, 0);
-  fcntl(socket, F_SETFL, flags & ~O_NONBLOCK);
-
-  timeval oldtimeout = {0};
-  socklen_t len = sizeof(oldtimeout);
-  getsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, (char *)&oldtimeout, &len);
-
-  timeval timeout = {0};
-  timeout.tv_sec = (timeoutMS / 1000);
-  timeout.tv_usec = (timeoutMS % 1000) * 1000;
-  setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, (const char *)&timeout, sizeof(timeout));
-
   while(received < length)
   {
-    int ret = recv(socket, dst, length - received, 0);
+    ssize_t ret = recv((int)socket, dst, length - received, 0);
 
     if(ret == 0)
     {
       Shutdown();
       return false;
     }
-    else if(ret <= 0)
+    else if(ret < 0)
     {
       int err = errno;
 
+      if(err == EINTR)
+        continue;
+
       if(err == EWOULDBLOCK || err == EAGAIN)
       {
+        if(WaitForSocket((int)socket, POLLIN, timeoutMS))
+          continue;
+
         RDCWARN("Timeout in recv");
         Shutdown();
         return false;
@@ -296,17 +323,10 @@ bool Socket::RecvDataBlocking(void *buf, uint32_t length)
       }
     }
 
-    received += ret;
+    received += (uint32_t)ret;
     dst += ret;
   }
 
-  flags = fcntl(socket, F_GETFL, 0);
-  fcntl(socket, F_SETFL, flags | O_NONBLOCK);
-
-  setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, (const char *)&oldtimeout, sizeof(oldtimeout));
-
-  RDCASSERT(received == length);
-
   return true;
 }
 
@@ -83,6 +83,7 @@ struct pthreadLockData
   pthread_mutexattr_t attr;
 };
 typedef CriticalSectionTemplate<pthreadLockData> CriticalSection;
+typedef ConditionTemplate<pthread_cond_t, pthreadLockData> Condition;
 };
 
 namespace Bits
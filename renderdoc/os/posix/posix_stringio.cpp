@@ -32,6 +32,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/file.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <time.h>
@@ -136,6 +137,14 @@ string FindFileInPath(const string &fileName)
   return filePath;
 }
 
+void GetLibraryFilename(string &selfName)
+{
+  // look up the shared object's path via dladdr
+  Dl_info info;
+  dladdr((void *)&soLocator, &info);
+  selfName = info.dli_fname ? info.dli_fname : "";
+}
+
 string GetReplayAppFilename()
 {
   // look up the shared object's path via dladdr
@@ -394,6 +403,40 @@ FILE *fopen(const char *filename, const char *mode)
   return ::fopen(filename, mode);
 }
 
+const byte *MapFile(const char *filename, uint64_t &size)
+{
+  size = 0;
+
+  int fd = open(filename, O_RDONLY);
+
+  if(fd < 0)
+    return NULL;
+
+  struct ::stat st;
+  if(fstat(fd, &st) != 0 || st.st_size == 0)
+  {
+    close(fd);
+    return NULL;
+  }
+
+  void *ret = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+  // the mapping holds its own reference to the file
+  close(fd);
+
+  if(ret == MAP_FAILED)
+    return NULL;
+
+  size = (uint64_t)st.st_size;
+  return (const byte *)ret;
+}
+
+void UnmapFile(const byte *data, uint64_t size)
+{
+  if(data)
+    munmap((void *)data, (size_t)size);
+}
+
 std::string ErrorString()
 {
   int err = errno;
@@ -60,6 +60,11 @@ int64_t ExchAdd64(volatile int64_t *i, int64_t a)
   return __sync_add_and_fetch(i, int64_t(a));
 }
 
+int64_t Exch64(volatile int64_t *i, int64_t newVal)
+{
+  return __atomic_exchange_n(i, newVal, __ATOMIC_SEQ_CST);
+}
+
 int32_t CmpExch32(volatile int32_t *dest, int32_t oldVal, int32_t newVal)
 {
   return __sync_val_compare_and_swap(dest, oldVal, newVal);
@@ -101,6 +106,30 @@ void CriticalSection::Unlock()
   pthread_mutex_unlock(&m_Data.lock);
 }
 
+template <>
+Condition::ConditionTemplate()
+{
+  pthread_cond_init(&m_Data, NULL);
+}
+
+template <>
+Condition::~ConditionTemplate()
+{
+  pthread_cond_destroy(&m_Data);
+}
+
+template <>
+void Condition::Wait(CriticalSection &lock)
+{
+  pthread_cond_wait(&m_Data, &lock.m_Data.lock);
+}
+
+template <>
+void Condition::NotifyAll()
+{
+  pthread_cond_broadcast(&m_Data);
+}
+
 struct ThreadInitData
 {
   std::function<void()> entryFunc;
@@ -243,4 +272,10 @@ void Sleep(uint32_t milliseconds)
 {
   usleep(milliseconds * 1000);
 }
+
+uint32_t GetLogicalCoreCount()
+{
+  long count = sysconf(_SC_NPROCESSORS_ONLN);
+  return count > 0 ? (uint32_t)count : 1;
+}
 };
@@ -146,12 +146,31 @@ Socket *Socket::AcceptClient(bool wait)
 
 bool Socket::SendDataBlocking(const void *buf, uint32_t length)
 {
-  if(length == 0)
-    return true;
+  return SendDataBlocking(buf, length, NULL, 0);
+}
 
-  uint32_t sent = 0;
+bool Socket::SendDataBlocking(const void *buf1, uint32_t length1, const void *buf2,
+                              uint32_t length2)
+{
+  WSABUF bufs[2];
+  bufs[0].buf = (char *)buf1;
+  bufs[0].len = length1;
+  bufs[1].buf = (char *)buf2;
+  bufs[1].len = length2;
+
+  WSABUF *vec = bufs;
+  DWORD count = 2;
+  DWORD sent = 0;
+
+  // skip any empty buffers
+  while(count > 0 && vec->len == 0)
+  {
+    vec++;
+    count--;
+  }
 
-  char *src = (char *)buf;
+  if(count == 0)
+    return true;
 
   u_long enable = 0;
   ioctlsocket(socket, FIONBIO, &enable);
@@ -163,11 +182,11 @@ bool Socket::SendDataBlocking(const void *buf, uint32_t length)
   DWORD timeout = timeoutMS;
   setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, (const char *)&timeout, sizeof(timeout));
 
-  while(sent < length)
+  while(count > 0)
   {
-    int ret = send(socket, src, length - sent, 0);
+    int ret = WSASend(socket, vec, count, &sent, 0, NULL, NULL);
 
-    if(ret <= 0)
+    if(ret != 0)
     {
       int err = WSAGetLastError();
 
@@ -185,8 +204,19 @@ bool Socket::SendDataBlocking(const void *buf, uint32_t length)
       }
     }
 
-    sent += ret;
-    src += ret;
+    // skip past whatever has been sent
+    while(count > 0 && sent >= vec->len)
+    {
+      sent -= vec->len;
+      vec++;
+      count--;
+    }
+
+    if(count > 0)
+    {
+      vec->buf += sent;
+      vec->len -= sent;
+    }
   }
 
   enable = 1;
@@ -194,8 +224,6 @@ bool Socket::SendDataBlocking(const void *buf, uint32_t length)
 
   setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, (const char *)&oldtimeout, sizeof(oldtimeout));
 
-  RDCASSERT(sent == length);
-
   return true;
 }
 
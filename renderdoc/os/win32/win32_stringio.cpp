@@ -168,6 +168,14 @@ void GetExecutableFilename(string &selfName)
   selfName = StringFormat::Wide2UTF8(wstring(curFile));
 }
 
+void GetLibraryFilename(string &selfName)
+{
+  wchar_t curFile[512] = {0};
+  GetModuleFileNameW(GetModuleHandleA(STRINGIZE(RDOC_DLL_FILE) ".dll"), curFile, 511);
+
+  selfName = StringFormat::Wide2UTF8(wstring(curFile));
+}
+
 bool IsRelativePath(const string &path)
 {
   if(path.empty())
@@ -544,6 +552,51 @@ FILE *fopen(const char *filename, const char *mode)
   return ret;
 }
 
+const byte *MapFile(const char *filename, uint64_t &size)
+{
+  size = 0;
+
+  wstring wfn = StringFormat::UTF82Wide(string(filename));
+
+  HANDLE file = ::CreateFileW(wfn.c_str(), GENERIC_READ,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+  if(file == INVALID_HANDLE_VALUE)
+    return NULL;
+
+  LARGE_INTEGER len = {};
+  if(!::GetFileSizeEx(file, &len) || len.QuadPart == 0)
+  {
+    ::CloseHandle(file);
+    return NULL;
+  }
+
+  HANDLE mapping = ::CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+  // the view holds its own reference to the mapping and file
+  ::CloseHandle(file);
+
+  if(mapping == NULL)
+    return NULL;
+
+  void *ret = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+  ::CloseHandle(mapping);
+
+  if(ret == NULL)
+    return NULL;
+
+  size = (uint64_t)len.QuadPart;
+  return (const byte *)ret;
+}
+
+void UnmapFile(const byte *data, uint64_t size)
+{
+  if(data)
+    ::UnmapViewOfFile(data);
+}
+
 bool exists(const char *filename)
 {
   wstring wfn = StringFormat::UTF82Wide(filename);
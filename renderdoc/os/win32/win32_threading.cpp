@@ -73,6 +73,11 @@ int64_t ExchAdd64(volatile int64_t *i, int64_t a)
   return (int64_t)InterlockedExchangeAdd64((volatile LONG64 *)i, a);
 }
 
+int64_t Exch64(volatile int64_t *i, int64_t newVal)
+{
+  return (int64_t)InterlockedExchange64((volatile LONG64 *)i, newVal);
+}
+
 int32_t CmpExch32(volatile int32_t *dest, int32_t oldVal, int32_t newVal)
 {
   return (int32_t)InterlockedCompareExchange((volatile LONG *)dest, newVal, oldVal);
@@ -106,6 +111,25 @@ void CriticalSection::Unlock()
   LeaveCriticalSection(&m_Data);
 }
 
+Condition::ConditionTemplate()
+{
+  InitializeConditionVariable(&m_Data);
+}
+
+Condition::~ConditionTemplate()
+{
+}
+
+void Condition::Wait(CriticalSection &lock)
+{
+  SleepConditionVariableCS(&m_Data, &lock.m_Data, INFINITE);
+}
+
+void Condition::NotifyAll()
+{
+  WakeAllConditionVariable(&m_Data);
+}
+
 struct ThreadInitData
 {
   std::function<void()> entryFunc;
@@ -251,4 +275,11 @@ void Sleep(uint32_t milliseconds)
 {
   ::Sleep((DWORD)milliseconds);
 }
+
+uint32_t GetLogicalCoreCount()
+{
+  SYSTEM_INFO info = {};
+  GetSystemInfo(&info);
+  return info.dwNumberOfProcessors > 0 ? (uint32_t)info.dwNumberOfProcessors : 1;
+}
 };
@@ -73,11 +73,16 @@ static const char *GetCaptureFilePathTemplate()
 
 static uint32_t GetNumCaptures()
 {
+  // captures are only listed once they're fully written
+  RenderDoc::Inst().FlushCaptureWriting();
+
   return (uint32_t)RenderDoc::Inst().GetCaptures().size();
 }
 
 static uint32_t GetCapture(uint32_t idx, char *filename, uint32_t *pathlength, uint64_t *timestamp)
 {
+  RenderDoc::Inst().FlushCaptureWriting();
+
   vector<CaptureData> caps = RenderDoc::Inst().GetCaptures();
 
   if(idx >= (uint32_t)caps.size())
@@ -0,0 +1,454 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "event_search.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <algorithm>
+#include "common/common.h"
+#include "strings/string_utils.h"
+
+static bool IsTokenChar(char c)
+{
+  return isalnum((unsigned char)c) || c == '_' || c == ':' || c == '#' || c == '.' || c == '-';
+}
+
+// split a string into lower-cased tokens, on anything that isn't part of an identifier, number or
+// ResourceId.
+static void Tokenise(const char *str, std::vector<std::string> &tokens)
+{
+  tokens.clear();
+
+  std::string cur;
+
+  for(const char *c = str; *c; c++)
+  {
+    if(IsTokenChar(*c))
+    {
+      cur.push_back((char)tolower((unsigned char)*c));
+    }
+    else if(!cur.empty())
+    {
+      tokens.push_back(cur);
+      cur.clear();
+    }
+  }
+
+  if(!cur.empty())
+    tokens.push_back(cur);
+}
+
+static bool NameEquals(const rdcstr &name, const std::string &lowerName)
+{
+  if(name.size() != lowerName.size())
+    return false;
+
+  for(size_t i = 0; i < lowerName.size(); i++)
+    if(tolower((unsigned char)name[i]) != lowerName[i])
+      return false;
+
+  return true;
+}
+
+static void SortUnique(std::vector<uint32_t> &list)
+{
+  std::sort(list.begin(), list.end());
+  list.erase(std::unique(list.begin(), list.end()), list.end());
+}
+
+static void AddEvent(std::vector<uint32_t> &list, uint32_t eventId)
+{
+  // events are added in order, so this catches duplicates from the same event
+  if(list.empty() || list.back() != eventId)
+    list.push_back(eventId);
+}
+
+static bool IsContainer(const SDObject *obj)
+{
+  return obj->type.basetype == SDBasic::Chunk || obj->type.basetype == SDBasic::Struct ||
+         obj->type.basetype == SDBasic::Array;
+}
+
+static std::string GetStringValue(const SDObject *obj)
+{
+  if(obj->type.basetype == SDBasic::Resource)
+    return ToStr(obj->data.basic.id);
+
+  if(obj->type.basetype == SDBasic::String || (obj->type.flags & SDTypeFlags::HasCustomString))
+    return obj->data.str.c_str();
+
+  return std::string();
+}
+
+static bool GetNumericValue(const SDObject *obj, double &value)
+{
+  switch(obj->type.basetype)
+  {
+    case SDBasic::Enum:
+    case SDBasic::UnsignedInteger: value = (double)obj->data.basic.u; return true;
+    case SDBasic::SignedInteger: value = (double)obj->data.basic.i; return true;
+    case SDBasic::Float: value = obj->data.basic.d; return true;
+    case SDBasic::Boolean: value = obj->data.basic.b ? 1.0 : 0.0; return true;
+    case SDBasic::Character: value = (double)obj->data.basic.c; return true;
+    default: break;
+  }
+
+  return false;
+}
+
+void EventSearchIndex::Build(const SDFile &file, const rdcarray<DrawcallDescription> &draws)
+{
+  m_File = &file;
+
+  AddDrawcalls(draws);
+
+  // events are almost always visited in order, but make sure every list is sorted and unique so
+  // that they can be intersected.
+  for(auto it = m_Tokens.begin(); it != m_Tokens.end(); ++it)
+    SortUnique(it->second);
+
+  for(auto it = m_Parameters.begin(); it != m_Parameters.end(); ++it)
+    SortUnique(it->second);
+}
+
+void EventSearchIndex::AddDrawcalls(const rdcarray<DrawcallDescription> &draws)
+{
+  for(const DrawcallDescription &draw : draws)
+  {
+    for(const APIEvent &ev : draw.events)
+    {
+      if(ev.chunkIndex >= m_File->chunks.size())
+        continue;
+
+      if(ev.eventId >= m_EventChunks.size())
+        m_EventChunks.resize(ev.eventId + 1, ~0U);
+
+      m_EventChunks[ev.eventId] = ev.chunkIndex;
+
+      const SDChunk *chunk = m_File->chunks[ev.chunkIndex];
+
+      AddTokens(ev.eventId, chunk->name.c_str());
+      AddObject(ev.eventId, chunk, chunk->name);
+    }
+
+    AddTokens(draw.eventId, draw.name.c_str());
+
+    AddDrawcalls(draw.children);
+  }
+}
+
+void EventSearchIndex::AddTokens(uint32_t eventId, const char *str)
+{
+  std::vector<std::string> tokens;
+  Tokenise(str, tokens);
+
+  for(const std::string &t : tokens)
+    AddEvent(m_Tokens[t], eventId);
+}
+
+void EventSearchIndex::AddObject(uint32_t eventId, const SDObject *obj, const rdcstr &name)
+{
+  if(IsContainer(obj))
+  {
+    // array elements don't have their own names, so they're found by the array's name
+    for(const SDObject *child : obj->data.children)
+      AddObject(eventId, child, child->name == "$el" ? name : child->name);
+
+    return;
+  }
+
+  AddEvent(m_Parameters[strlower(name.c_str())], eventId);
+
+  std::string str = GetStringValue(obj);
+
+  if(!str.empty())
+    AddTokens(eventId, str.c_str());
+}
+
+rdcarray<uint32_t> EventSearchIndex::Search(const char *query) const
+{
+  std::vector<std::string> terms;
+  split(std::string(query ? query : ""), terms, ' ');
+
+  EventList result;
+  bool first = true;
+
+  std::vector<std::string> tokens;
+
+  for(const std::string &term : terms)
+  {
+    if(term.empty())
+      continue;
+
+    EventList matches;
+
+    size_t opPos = term.find_first_of("<>=");
+
+    if(opPos != std::string::npos && opPos > 0)
+    {
+      Comparison cmp;
+      cmp.name = strlower(term.substr(0, opPos));
+      cmp.op = term.substr(opPos, term[opPos] != '=' && term[opPos + 1] == '=' ? 2 : 1);
+      cmp.text = strlower(term.substr(opPos + cmp.op.size()));
+
+      char *end = NULL;
+      cmp.value = strtod(cmp.text.c_str(), &end);
+      cmp.numeric = !cmp.text.empty() && end && *end == 0;
+
+      // strings can only be compared for equality
+      if(cmp.numeric || cmp.op == "=")
+        matches = MatchComparison(cmp);
+    }
+    else
+    {
+      // plain text is tokenised the same way as the indexed strings, and every token must match
+      Tokenise(term.c_str(), tokens);
+
+      if(tokens.empty())
+        continue;
+
+      for(size_t i = 0; i < tokens.size(); i++)
+      {
+        EventList tokenMatches = MatchText(tokens[i]);
+
+        if(i == 0)
+        {
+          matches.swap(tokenMatches);
+        }
+        else
+        {
+          EventList both;
+          std::set_intersection(matches.begin(), matches.end(), tokenMatches.begin(),
+                                tokenMatches.end(), std::back_inserter(both));
+          matches.swap(both);
+        }
+      }
+    }
+
+    if(first)
+    {
+      result.swap(matches);
+      first = false;
+    }
+    else
+    {
+      EventList both;
+      std::set_intersection(result.begin(), result.end(), matches.begin(), matches.end(),
+                            std::back_inserter(both));
+      result.swap(both);
+    }
+
+    if(result.empty())
+      break;
+  }
+
+  rdcarray<uint32_t> ret;
+  ret.assign(result.data(), result.size());
+  return ret;
+}
+
+EventSearchIndex::EventList EventSearchIndex::MatchText(const std::string &token) const
+{
+  // ResourceIds are matched exactly, otherwise ResourceId::1 would match every resource starting
+  // with a 1.
+  if(token.compare(0, sizeof("resourceid::") - 1, "resourceid::") == 0)
+  {
+    auto it = m_Tokens.find(token);
+    if(it == m_Tokens.end())
+      return EventList();
+
+    return it->second;
+  }
+
+  EventList ret;
+  size_t numLists = 0;
+
+  for(auto it = m_Tokens.begin(); it != m_Tokens.end(); ++it)
+  {
+    if(it->first.find(token) != std::string::npos)
+    {
+      ret.insert(ret.end(), it->second.begin(), it->second.end());
+      numLists++;
+    }
+  }
+
+  if(numLists > 1)
+    SortUnique(ret);
+
+  return ret;
+}
+
+EventSearchIndex::EventList EventSearchIndex::MatchComparison(const Comparison &cmp) const
+{
+  EventList ret;
+
+  auto it = m_Parameters.find(cmp.name);
+  if(it == m_Parameters.end())
+    return ret;
+
+  for(uint32_t eventId : it->second)
+  {
+    const SDChunk *chunk = m_File->chunks[m_EventChunks[eventId]];
+
+    if(MatchObject(chunk, chunk->name, cmp))
+      ret.push_back(eventId);
+  }
+
+  return ret;
+}
+
+bool EventSearchIndex::MatchObject(const SDObject *obj, const rdcstr &name,
+                                   const Comparison &cmp) const
+{
+  if(IsContainer(obj))
+  {
+    for(const SDObject *child : obj->data.children)
+      if(MatchObject(child, child->name == "$el" ? name : child->name, cmp))
+        return true;
+
+    return false;
+  }
+
+  if(!NameEquals(name, cmp.name))
+    return false;
+
+  double value = 0.0;
+  if(cmp.numeric && GetNumericValue(obj, value))
+  {
+    if(cmp.op == "=")
+      return value == cmp.value;
+    else if(cmp.op == "<")
+      return value < cmp.value;
+    else if(cmp.op == "<=")
+      return value <= cmp.value;
+    else if(cmp.op == ">")
+      return value > cmp.value;
+    else if(cmp.op == ">=")
+      return value >= cmp.value;
+
+    return false;
+  }
+
+  return cmp.op == "=" && strlower(GetStringValue(obj)) == cmp.text;
+}
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#include "3rdparty/catch/catch.hpp"
+
+TEST_CASE("Event search index", "[search]")
+{
+  SDFile file;
+
+  auto makeChunk = [&file](const char *name) {
+    SDChunk *chunk = new SDChunk(name);
+    file.chunks.push_back(chunk);
+    return chunk;
+  };
+
+  SDChunk *chunk = makeChunk("vkCmdBindPipeline");
+  chunk->data.children.push_back(makeSDObject("pipeline", ResourceId()));
+
+  chunk = makeChunk("vkCmdDispatch");
+  chunk->data.children.push_back(makeSDObject("groupCountX", 128U));
+  chunk->data.children.push_back(makeSDObject("groupCountY", 1U));
+
+  chunk = makeChunk("vkCmdDispatch");
+  chunk->data.children.push_back(makeSDObject("groupCountX", 16U));
+  chunk->data.children.push_back(makeSDObject("groupCountY", 1U));
+
+  chunk = makeChunk("vkCmdSetDebugName");
+  chunk->data.children.push_back(makeSDObject("name", "Shadow Depth"));
+
+  SDObject *arr = new SDObject("offsets", "uint32_t");
+  arr->type.basetype = SDBasic::Array;
+  arr->data.children.push_back(makeSDObject("$el", 4U));
+  arr->data.children.push_back(makeSDObject("$el", 96U));
+  chunk->data.children.push_back(arr);
+
+  rdcarray<DrawcallDescription> draws;
+  draws.resize(3);
+
+  draws[0].eventId = 2;
+  draws[0].name = "vkCmdDispatch(128, 1, 1)";
+  draws[0].events.resize(2);
+  draws[0].events[0].eventId = 1;
+  draws[0].events[0].chunkIndex = 0;
+  draws[0].events[1].eventId = 2;
+  draws[0].events[1].chunkIndex = 1;
+
+  draws[1].eventId = 3;
+  draws[1].name = "vkCmdDispatch(16, 1, 1)";
+  draws[1].events.resize(1);
+  draws[1].events[0].eventId = 3;
+  draws[1].events[0].chunkIndex = 2;
+
+  draws[2].eventId = 4;
+  draws[2].name = "Shadow Pass";
+  draws[2].events.resize(1);
+  draws[2].events[0].eventId = 4;
+  draws[2].events[0].chunkIndex = 3;
+
+  EventSearchIndex index;
+  index.Build(file, draws);
+
+  auto search = [&index](const char *query) {
+    rdcarray<uint32_t> results = index.Search(query);
+    return std::vector<uint32_t>(results.begin(), results.end());
+  };
+
+  SECTION("Text searches match names and parameters case-insensitively")
+  {
+    CHECK(search("dispatch") == std::vector<uint32_t>({2, 3}));
+    CHECK(search("SHADOW") == std::vector<uint32_t>({4}));
+    CHECK(search("shadow depth") == std::vector<uint32_t>({4}));
+    CHECK(search("shadow dispatch").empty());
+    CHECK(search("bindpipeline") == std::vector<uint32_t>({1}));
+    CHECK(search("").empty());
+    CHECK(search("  dispatch   16 ") == std::vector<uint32_t>({3}));
+    CHECK(search("missing").empty());
+  };
+
+  SECTION("ResourceIds are matched exactly")
+  {
+    CHECK(search("ResourceId::0") == std::vector<uint32_t>({1}));
+    CHECK(search("ResourceId::").empty());
+  };
+
+  SECTION("Parameter comparisons")
+  {
+    CHECK(search("groupCountX>64") == std::vector<uint32_t>({2}));
+    CHECK(search("groupcountx<=16") == std::vector<uint32_t>({3}));
+    CHECK(search("groupCountY=1") == std::vector<uint32_t>({2, 3}));
+    CHECK(search("vkCmdDispatch groupCountX>=16") == std::vector<uint32_t>({2, 3}));
+    CHECK(search("groupCountZ>0").empty());
+    CHECK(search("offsets=96") == std::vector<uint32_t>({4}));
+    CHECK(search("offsets>100").empty());
+    CHECK(search("name=shadow").empty());
+    CHECK(search("name<shadow").empty());
+    CHECK(search("pipeline=resourceid::0") == std::vector<uint32_t>({1}));
+  };
+}
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
@@ -0,0 +1,77 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include "api/replay/renderdoc_replay.h"
+
+// A search index over the events in a capture, see IReplayController::SearchEvents for the query
+// syntax.
+//
+// Drawcall names, function names and string-like parameter values are split into lower-cased
+// tokens, and each distinct token maps to the sorted list of events containing it. A text term
+// only has to be matched against the distinct tokens rather than every event, so queries cost
+// roughly the size of the vocabulary plus the number of results.
+//
+// Parameter comparisons can't sensibly be indexed by value, so instead each distinct parameter
+// name maps to the events that have it, and only those events' chunks are checked.
+class EventSearchIndex
+{
+public:
+  // the file must stay alive as long as the index is searched.
+  void Build(const SDFile &file, const rdcarray<DrawcallDescription> &draws);
+
+  rdcarray<uint32_t> Search(const char *query) const;
+
+private:
+  typedef std::vector<uint32_t> EventList;
+
+  struct Comparison
+  {
+    std::string name;
+    std::string op;
+    std::string text;
+    double value;
+    bool numeric;
+  };
+
+  void AddDrawcalls(const rdcarray<DrawcallDescription> &draws);
+  void AddTokens(uint32_t eventId, const char *str);
+  void AddObject(uint32_t eventId, const SDObject *obj, const rdcstr &name);
+
+  EventList MatchText(const std::string &term) const;
+  EventList MatchComparison(const Comparison &cmp) const;
+  bool MatchObject(const SDObject *obj, const rdcstr &name, const Comparison &cmp) const;
+
+  const SDFile *m_File = NULL;
+
+  // the chunk index for each event, indexed by eventId
+  std::vector<uint32_t> m_EventChunks;
+
+  std::map<std::string, EventList> m_Tokens;
+  std::map<std::string, EventList> m_Parameters;
+};
@@ -116,6 +116,39 @@ void DoSerialise(SerialiserType &ser, CaptureOptions &el)
   SIZE_CHECK(20);
 }
 
+template <class SerialiserType>
+void DoSerialise(SerialiserType &ser, ProbeStatistics &el)
+{
+  SERIALISE_MEMBER(name);
+  SERIALISE_MEMBER(count);
+  SERIALISE_MEMBER(totalTime);
+  SERIALISE_MEMBER(minTime);
+  SERIALISE_MEMBER(maxTime);
+  SERIALISE_MEMBER(histogram);
+
+  SIZE_CHECK(64);
+}
+
+template <class SerialiserType>
+void DoSerialise(SerialiserType &ser, FrameTelemetryData &el)
+{
+  SERIALISE_MEMBER(frameCount);
+  SERIALISE_MEMBER(intervalTime);
+  SERIALISE_MEMBER(avgFrameTime);
+  SERIALISE_MEMBER(minFrameTime);
+  SERIALISE_MEMBER(maxFrameTime);
+  SERIALISE_MEMBER(frameTimeBuckets);
+  SERIALISE_MEMBER(frameTimeHistogram);
+  SERIALISE_MEMBER(avgOverheadTime);
+  SERIALISE_MEMBER(maxOverheadTime);
+  SERIALISE_MEMBER(coherentMapBytes);
+  SERIALISE_MEMBER(liveChunks);
+  SERIALISE_MEMBER(chunkMemory);
+  SERIALISE_MEMBER(probes);
+
+  SIZE_CHECK(128);
+}
+
 template <typename SerialiserType>
 void DoSerialise(SerialiserType &ser, ResourceFormat &el)
 {
@@ -2072,6 +2105,8 @@ INSTANTIATE_SERIALISE_TYPE(PathEntry)
 INSTANTIATE_SERIALISE_TYPE(SectionProperties)
 INSTANTIATE_SERIALISE_TYPE(EnvironmentModification)
 INSTANTIATE_SERIALISE_TYPE(CaptureOptions)
+INSTANTIATE_SERIALISE_TYPE(ProbeStatistics)
+INSTANTIATE_SERIALISE_TYPE(FrameTelemetryData)
 INSTANTIATE_SERIALISE_TYPE(ResourceFormat)
 INSTANTIATE_SERIALISE_TYPE(Bindpoint)
 INSTANTIATE_SERIALISE_TYPE(ShaderBindpointMapping)
@@ -198,6 +198,8 @@ ReplayController::~ReplayController()
 
   m_TargetResources.clear();
 
+  WaitForSearchIndex();
+
   if(m_pDevice)
     m_pDevice->Shutdown();
   m_pDevice = NULL;
@@ -205,6 +207,8 @@ ReplayController::~ReplayController()
 
 void ReplayController::SetFrameEvent(uint32_t eventId, bool force)
 {
+  SCOPED_PROBE(SetFrameEvent);
+
   if(eventId != m_EventID || force)
   {
     m_EventID = eventId;
@@ -212,7 +216,7 @@ void ReplayController::SetFrameEvent(uint32_t eventId, bool force)
     m_pDevice->ReplayLog(eventId, eReplay_WithoutDraw);
 
     for(size_t i = 0; i < m_Outputs.size(); i++)
-      m_Outputs[i]->SetFrameEvent(eventId);
+      m_Outputs[i]->SetFrameEvent(eventId, force);
 
     m_pDevice->ReplayLog(eventId, eReplay_OnlyDraw);
 
@@ -289,6 +293,25 @@ rdcarray<DrawcallDescription> ReplayController::GetDrawcalls()
   return m_FrameRecord.drawcallList;
 }
 
+rdcarray<uint32_t> ReplayController::SearchEvents(const char *query)
+{
+  WaitForSearchIndex();
+
+  return m_SearchIndex.Search(query);
+}
+
+void ReplayController::WaitForSearchIndex()
+{
+  SCOPED_LOCK(m_SearchIndexLock);
+
+  if(m_SearchIndexThread)
+  {
+    Threading::JoinThread(m_SearchIndexThread);
+    Threading::CloseThread(m_SearchIndexThread);
+    m_SearchIndexThread = 0;
+  }
+}
+
 rdcarray<CounterResult> ReplayController::FetchCounters(const rdcarray<GPUCounter> &counters)
 {
   std::vector<GPUCounter> counterArray(counters.begin(), counters.end());
@@ -338,10 +361,12 @@ ShaderReflection *ReplayController::GetShader(ResourceId shader, ShaderEntryPoin
 
 rdcarray<EventUsage> ReplayController::GetUsage(ResourceId id)
 {
-  id = m_pDevice->GetLiveID(id);
-  if(id == ResourceId())
-    return rdcarray<EventUsage>();
-  return m_pDevice->GetUsage(id);
+  return m_UsageIndex.GetUsage(id);
+}
+
+rdcarray<ResourceId> ReplayController::GetEventResources(uint32_t eventId)
+{
+  return m_UsageIndex.GetEventResources(eventId);
 }
 
 MeshFormat ReplayController::GetPostVSData(uint32_t instID, MeshDataStage stage)
@@ -398,6 +423,8 @@ bytebuf ReplayController::GetTextureData(ResourceId tex, uint32_t arrayIdx, uint
 
 bool ReplayController::SaveTexture(const TextureSave &saveData, const char *path)
 {
+  SCOPED_PROBE(SaveTexture);
+
   TextureSave sd = saveData;    // mutable copy
   ResourceId liveid = m_pDevice->GetLiveID(sd.resourceId);
 
@@ -1253,7 +1280,7 @@ rdcarray<PixelModification> ReplayController::PixelHistory(ResourceId target, ui
   if(id == ResourceId())
     return ret;
 
-  std::vector<EventUsage> usage = m_pDevice->GetUsage(id);
+  std::vector<EventUsage> usage = m_UsageIndex.GetUsage(target);
 
   vector<EventUsage> events;
 
@@ -1456,7 +1483,7 @@ ReplayOutput *ReplayController::CreateOutput(WindowingData window, ReplayOutputT
 
   m_pDevice->ReplayLog(m_EventID, eReplay_WithoutDraw);
 
-  out->SetFrameEvent(m_EventID);
+  out->SetFrameEvent(m_EventID, true);
 
   m_pDevice->ReplayLog(m_EventID, eReplay_OnlyDraw);
 
@@ -1638,6 +1665,17 @@ ReplayStatus ReplayController::PostCreateInit(IReplayDriver *device, RDCFile *rd
   DrawcallDescription *previous = NULL;
   SetupDrawcallPointers(&m_Drawcalls, m_FrameRecord.drawcallList, NULL, previous);
 
+  // usage is fixed once the capture has been replayed the first time, so fetch it all at once
+  // rather than asking the driver again every time a resource is looked at.
+  m_UsageIndex = m_pDevice->GetUsageIndex();
+  m_UsageIndex.BuildEventView();
+
+  // the structured data and drawcalls don't change after this point, so the search index can be
+  // built in the background while the UI is loading the capture.
+  const SDFile *file = &m_pDevice->GetStructuredFile();
+  m_SearchIndexThread = Threading::CreateThread(
+      [this, file]() { m_SearchIndex.Build(*file, m_FrameRecord.drawcallList); });
+
   return ReplayStatus::Succeeded;
 }
 
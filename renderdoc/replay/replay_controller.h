@@ -25,11 +25,13 @@
 
 #pragma once
 
+#include <map>
 #include <set>
 #include <vector>
 #include "api/replay/renderdoc_replay.h"
 #include "common/common.h"
 #include "core/core.h"
+#include "replay/event_search.h"
 #include "replay/replay_driver.h"
 
 struct ReplayController;
@@ -64,10 +66,37 @@ private:
   ReplayOutput(ReplayController *parent, WindowingData window, ReplayOutputType type);
   virtual ~ReplayOutput();
 
-  void SetFrameEvent(int eventId);
+  void SetFrameEvent(int eventId, bool force);
 
   void RefreshOverlay();
 
+  bool TextureWrittenBetween(ResourceId texture, uint32_t eventA, uint32_t eventB);
+  void FetchCPUWriteEvents();
+
+  // identifies the texture subresource that min/max and histogram results were calculated for
+  struct TextureStatsKey
+  {
+    ResourceId texture;
+    uint32_t sliceFace;
+    uint32_t mip;
+    uint32_t sample;
+    CompType typeHint;
+
+    bool operator<(const TextureStatsKey &o) const;
+  };
+
+  struct HistogramKey
+  {
+    TextureStatsKey tex;
+    float minval;
+    float maxval;
+    uint32_t channels;
+
+    bool operator<(const HistogramKey &o) const;
+  };
+
+  bool GetTextureStatsKey(TextureStatsKey &key);
+
   void ClearBackground(uint64_t outputID, const FloatVector &backgroundColor);
 
   void DisplayContext();
@@ -107,6 +136,19 @@ private:
 
   vector<uint32_t> passEvents;
 
+  // computing min/max or a histogram needs a GPU readback, and the texture viewer asks again each
+  // time it refreshes, so results are kept until the event changes or the replay is modified.
+  std::map<TextureStatsKey, rdcpair<PixelValue, PixelValue>> m_MinMaxCache;
+  std::map<HistogramKey, rdcarray<uint32_t>> m_HistogramCache;
+
+  // sorted events at which each thumbnailed texture is written, so moving between events only
+  // re-renders the thumbnails whose contents could actually have changed.
+  std::map<ResourceId, std::vector<uint32_t>> m_TextureWrites;
+
+  // sorted events that write mapped memory from the CPU, which could change any texture
+  std::vector<uint32_t> m_CPUWriteEvents;
+  bool m_CPUWritesFetched = false;
+
   int32_t m_Width;
   int32_t m_Height;
 
@@ -159,6 +201,7 @@ public:
   FrameDescription GetFrameInfo();
   const SDFile &GetStructuredFile();
   rdcarray<DrawcallDescription> GetDrawcalls();
+  rdcarray<uint32_t> SearchEvents(const char *query);
   rdcarray<CounterResult> FetchCounters(const rdcarray<GPUCounter> &counters);
   rdcarray<GPUCounter> EnumerateCounters();
   CounterDescription DescribeCounter(GPUCounter counterID);
@@ -181,6 +224,7 @@ public:
   MeshFormat GetPostVSData(uint32_t instID, MeshDataStage stage);
 
   rdcarray<EventUsage> GetUsage(ResourceId id);
+  rdcarray<ResourceId> GetEventResources(uint32_t eventId);
 
   bytebuf GetBufferData(ResourceId buff, uint64_t offset, uint64_t len);
   bytebuf GetTextureData(ResourceId buff, uint32_t arrayIdx, uint32_t mip);
@@ -210,6 +254,14 @@ private:
   FrameRecord m_FrameRecord;
   vector<DrawcallDescription *> m_Drawcalls;
 
+  ResourceUsageIndex m_UsageIndex;
+
+  void WaitForSearchIndex();
+
+  EventSearchIndex m_SearchIndex;
+  Threading::ThreadHandle m_SearchIndexThread = 0;
+  Threading::CriticalSection m_SearchIndexLock;
+
   APIProperties m_APIProps;
   std::vector<std::string> m_GCNTargets;
 
@@ -23,6 +23,7 @@
  ******************************************************************************/
 
 #include "replay_driver.h"
+#include <algorithm>
 #include "maths/formatpacking.h"
 #include "serialise/serialiser.h"
 
@@ -53,6 +54,128 @@ void DoSerialise(SerialiserType &ser, GetTextureDataParams &el)
 
 INSTANTIATE_SERIALISE_TYPE(GetTextureDataParams);
 
+template <typename SerialiserType>
+void DoSerialise(SerialiserType &ser, ResourceUsageIndex &el)
+{
+  SERIALISE_MEMBER(resources);
+  SERIALISE_MEMBER(offsets);
+  SERIALISE_MEMBER(usage);
+}
+
+INSTANTIATE_SERIALISE_TYPE(ResourceUsageIndex);
+
+void ResourceUsageIndex::Build(const std::map<ResourceId, std::vector<EventUsage> > &uses,
+                               std::function<ResourceId(ResourceId)> getOriginalID)
+{
+  // the drivers track usage by live ID, but it's looked up by original ID so that callers don't
+  // need to go through the driver to remap it first.
+  std::vector<std::pair<ResourceId, const std::vector<EventUsage> *> > sorted;
+  sorted.reserve(uses.size());
+
+  size_t total = 0;
+  for(auto it = uses.begin(); it != uses.end(); ++it)
+  {
+    if(it->second.empty())
+      continue;
+
+    sorted.push_back(std::make_pair(getOriginalID(it->first), &it->second));
+    total += it->second.size();
+  }
+
+  std::sort(sorted.begin(), sorted.end());
+
+  resources.clear();
+  offsets.clear();
+  usage.clear();
+
+  resources.reserve(sorted.size());
+  offsets.reserve(sorted.size() + 1);
+  usage.reserve(total);
+
+  for(size_t i = 0; i < sorted.size(); i++)
+  {
+    resources.push_back(sorted[i].first);
+    offsets.push_back((uint32_t)usage.size());
+    usage.insert(usage.end(), sorted[i].second->begin(), sorted[i].second->end());
+  }
+
+  offsets.push_back((uint32_t)usage.size());
+
+  eventOffsets.clear();
+  eventResources.clear();
+}
+
+void ResourceUsageIndex::BuildEventView()
+{
+  eventOffsets.clear();
+  eventResources.clear();
+
+  if(usage.empty())
+    return;
+
+  uint32_t maxEID = 0;
+  for(const EventUsage &u : usage)
+    maxEID = RDCMAX(maxEID, u.eventId);
+
+  // count the resources used at each event, shifted up by one so that a running sum turns the
+  // counts into the start of each event's range. A resource used several ways at the same event
+  // is only listed once, which is easy since its usage is in event order.
+  eventOffsets.resize(maxEID + 2);
+
+  for(size_t r = 0; r < resources.size(); r++)
+  {
+    for(uint32_t i = offsets[r]; i < offsets[r + 1]; i++)
+    {
+      if(i == offsets[r] || usage[i].eventId != usage[i - 1].eventId)
+        eventOffsets[usage[i].eventId + 1]++;
+    }
+  }
+
+  for(size_t e = 1; e < eventOffsets.size(); e++)
+    eventOffsets[e] += eventOffsets[e - 1];
+
+  eventResources.resize(eventOffsets.back());
+
+  std::vector<uint32_t> cursor(eventOffsets.begin(), eventOffsets.end() - 1);
+
+  for(size_t r = 0; r < resources.size(); r++)
+  {
+    for(uint32_t i = offsets[r]; i < offsets[r + 1]; i++)
+    {
+      if(i == offsets[r] || usage[i].eventId != usage[i - 1].eventId)
+        eventResources[cursor[usage[i].eventId]++] = (uint32_t)r;
+    }
+  }
+}
+
+std::vector<EventUsage> ResourceUsageIndex::GetUsage(ResourceId id) const
+{
+  auto it = std::lower_bound(resources.begin(), resources.end(), id);
+
+  if(it == resources.end() || *it != id)
+    return std::vector<EventUsage>();
+
+  size_t r = it - resources.begin();
+
+  return std::vector<EventUsage>(usage.begin() + offsets[r], usage.begin() + offsets[r + 1]);
+}
+
+std::vector<ResourceId> ResourceUsageIndex::GetEventResources(uint32_t eventId) const
+{
+  std::vector<ResourceId> ret;
+
+  // compare in size_t, eventId + 1 would wrap for the largest event ID
+  if(eventOffsets.empty() || eventId >= eventOffsets.size() - 1)
+    return ret;
+
+  ret.reserve(eventOffsets[eventId + 1] - eventOffsets[eventId]);
+
+  for(uint32_t i = eventOffsets[eventId]; i < eventOffsets[eventId + 1]; i++)
+    ret.push_back(resources[eventResources[i]]);
+
+  return ret;
+}
+
 DrawcallDescription *SetupDrawcallPointers(vector<DrawcallDescription *> *drawcallTable,
                                            rdcarray<DrawcallDescription> &draws,
                                            DrawcallDescription *parent,
@@ -290,6 +413,151 @@ FloatVector HighlightCache::InterpretVertex(byte *data, uint32_t vert, const Mes
   return ret;
 }
 
+template <typename T, uint32_t compCount, typename Convert>
+static void DecodeVertexComponents(const byte *data, uint32_t stride, uint32_t count,
+                                   FloatVector *out, Convert convert)
+{
+  for(uint32_t v = 0; v < count; v++)
+  {
+    const T *src = (const T *)(data + v * stride);
+
+    // decode into a local so the whole vertex is written out in one go
+    FloatVector ret(0.0f, 0.0f, 0.0f, 1.0f);
+    float *dst = &ret.x;
+
+    for(uint32_t c = 0; c < compCount; c++)
+      dst[c] = convert(src[c]);
+
+    out[v] = ret;
+  }
+}
+
+// the component count is a template parameter so that the inner loop is fully unrolled and the
+// compiler is free to vectorise the conversion.
+template <typename T, typename Convert>
+static void DecodeVertexComponents(const byte *data, uint32_t stride, uint32_t count,
+                                   uint32_t compCount, FloatVector *out, Convert convert)
+{
+  switch(compCount)
+  {
+    case 1: DecodeVertexComponents<T, 1>(data, stride, count, out, convert); break;
+    case 2: DecodeVertexComponents<T, 2>(data, stride, count, out, convert); break;
+    case 3: DecodeVertexComponents<T, 3>(data, stride, count, out, convert); break;
+    case 4: DecodeVertexComponents<T, 4>(data, stride, count, out, convert); break;
+    default: break;
+  }
+}
+
+void HighlightCache::InterpretVertices(byte *data, uint32_t first, uint32_t count,
+                                       const MeshDisplay &cfg, byte *end, FloatVector *out)
+{
+  const ResourceFormat &fmt = cfg.position.format;
+  const uint32_t stride = cfg.position.vertexByteStride;
+
+  uint32_t vertSize = fmt.compCount * fmt.compByteWidth;
+  if(fmt.type == ResourceFormatType::R10G10B10A2 || fmt.type == ResourceFormatType::R11G11B10)
+    vertSize = 4;
+
+  // work out how many vertices are entirely within the data, everything after is invalid
+  uint32_t numValid = 0;
+  data += uint64_t(first) * stride;
+
+  if(data + vertSize <= end)
+  {
+    if(stride == 0)
+      numValid = count;
+    else
+      numValid = RDCMIN(count, uint32_t((end - data - vertSize) / stride + 1));
+  }
+
+  for(uint32_t v = numValid; v < count; v++)
+    out[v] = FloatVector(0.0f, 0.0f, 0.0f, 1.0f);
+
+  if(numValid == 0)
+    return;
+
+  if(fmt.type == ResourceFormatType::R10G10B10A2)
+  {
+    for(uint32_t v = 0; v < numValid; v++)
+    {
+      Vec4f f = ConvertFromR10G10B10A2(*(uint32_t *)(data + v * stride));
+      out[v] = FloatVector(f.x, f.y, f.z, f.w);
+    }
+    return;
+  }
+  else if(fmt.type == ResourceFormatType::R11G11B10)
+  {
+    for(uint32_t v = 0; v < numValid; v++)
+    {
+      Vec3f f = ConvertFromR11G11B10(*(uint32_t *)(data + v * stride));
+      out[v] = FloatVector(f.x, f.y, f.z, 1.0f);
+    }
+    return;
+  }
+  else if((fmt.Special() && fmt.type != ResourceFormatType::Undefined) || fmt.compCount > 4)
+  {
+    bool valid = true;
+    for(uint32_t v = 0; v < numValid; v++)
+      out[v] = InterpretVertex(data, v, cfg, end, valid);
+    return;
+  }
+
+  if(fmt.compByteWidth == 4 && (fmt.compType == CompType::Float || fmt.compType == CompType::Depth))
+  {
+    // by far the most common case, which the compiler can turn into straight copies
+    DecodeVertexComponents<float>(data, stride, numValid, fmt.compCount, out,
+                                  [](float f) { return f; });
+  }
+  else if(fmt.compByteWidth == 2 && fmt.compType == CompType::Float)
+  {
+    DecodeVertexComponents<uint16_t>(data, stride, numValid, fmt.compCount, out,
+                                     [](uint16_t h) { return ConvertFromHalf(h); });
+  }
+  else if(fmt.compByteWidth == 2 && fmt.compType == CompType::UNorm)
+  {
+    DecodeVertexComponents<uint16_t>(data, stride, numValid, fmt.compCount, out,
+                                     [](uint16_t u) { return float(u) / 65535.0f; });
+  }
+  else if(fmt.compByteWidth == 2 && fmt.compType == CompType::SNorm)
+  {
+    DecodeVertexComponents<int16_t>(data, stride, numValid, fmt.compCount, out, [](int16_t i) {
+      return i == -32768 ? -1.0f : float(i) / 32767.0f;
+    });
+  }
+  else if(fmt.compByteWidth == 1 && fmt.compType == CompType::UNorm && !fmt.srgbCorrected)
+  {
+    DecodeVertexComponents<uint8_t>(data, stride, numValid, fmt.compCount, out,
+                                    [](uint8_t u) { return float(u) / 255.0f; });
+  }
+  else if(fmt.compByteWidth == 1 && fmt.compType == CompType::SNorm)
+  {
+    DecodeVertexComponents<int8_t>(data, stride, numValid, fmt.compCount, out,
+                                   [](int8_t i) { return i == -128 ? -1.0f : float(i) / 127.0f; });
+  }
+  else
+  {
+    // any other regular format still avoids the per-vertex bounds checks and dispatch
+    for(uint32_t v = 0; v < numValid; v++)
+    {
+      byte *src = data + v * stride;
+
+      FloatVector ret(0.0f, 0.0f, 0.0f, 1.0f);
+      float *dst = &ret.x;
+
+      for(uint32_t c = 0; c < fmt.compCount; c++)
+        dst[c] = ConvertComponent(fmt, src + c * fmt.compByteWidth);
+
+      out[v] = ret;
+    }
+  }
+
+  if(fmt.bgraOrder)
+  {
+    for(uint32_t v = 0; v < numValid; v++)
+      std::swap(out[v].x, out[v].z);
+  }
+}
+
 void HighlightCache::CacheHighlightingData(uint32_t eventId, const MeshDisplay &cfg)
 {
   if(EID != eventId || cfg.type != stage || cfg.position.vertexResourceId != buf ||
@@ -716,3 +984,171 @@ bool HighlightCache::FetchHighlightPositions(const MeshDisplay &cfg, FloatVector
 
   return valid;
 }
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#include "3rdparty/catch/catch.hpp"
+#include "common/timing.h"
+
+static MeshDisplay GetVertexTestConfig(CompType compType, uint32_t compByteWidth,
+                                       uint32_t compCount, uint32_t stride)
+{
+  MeshDisplay cfg;
+  cfg.position.format.type = ResourceFormatType::Regular;
+  cfg.position.format.compType = compType;
+  cfg.position.format.compByteWidth = compByteWidth;
+  cfg.position.format.compCount = compCount;
+  cfg.position.vertexByteStride = stride;
+  return cfg;
+}
+
+TEST_CASE("Batched vertex position decoding", "[mesh]")
+{
+  std::vector<byte> data(1024);
+  for(size_t i = 0; i < data.size(); i++)
+    data[i] = byte((i * 37 + 11) & 0xff);
+
+  // keep any float data finite so that results can be compared
+  for(size_t i = 3; i < data.size(); i += 4)
+    data[i] &= 0x3f;
+
+  std::vector<MeshDisplay> configs = {
+      GetVertexTestConfig(CompType::Float, 4, 3, 12),
+      GetVertexTestConfig(CompType::Float, 4, 4, 20),
+      GetVertexTestConfig(CompType::Float, 2, 4, 8),
+      GetVertexTestConfig(CompType::UNorm, 2, 2, 6),
+      GetVertexTestConfig(CompType::SNorm, 2, 3, 8),
+      GetVertexTestConfig(CompType::UNorm, 1, 4, 4),
+      GetVertexTestConfig(CompType::SNorm, 1, 3, 5),
+      GetVertexTestConfig(CompType::UInt, 2, 3, 6),
+      GetVertexTestConfig(CompType::UNorm, 1, 4, 4),
+      GetVertexTestConfig(CompType::UNorm, 4, 4, 16),
+  };
+
+  configs[8].position.format.bgraOrder = true;
+  configs[9].position.format.type = ResourceFormatType::R10G10B10A2;
+
+  byte *begin = data.data();
+  // cut the data short so that the last few vertices are out of bounds
+  byte *end = begin + data.size() - 13;
+
+  for(const MeshDisplay &cfg : configs)
+  {
+    const uint32_t first = 3;
+    const uint32_t count = 1024 / cfg.position.vertexByteStride - first + 4;
+
+    std::vector<FloatVector> batched(count);
+    HighlightCache::InterpretVertices(begin, first, count, cfg, end, batched.data());
+
+    for(uint32_t v = 0; v < count; v++)
+    {
+      bool valid = true;
+      FloatVector single = HighlightCache::InterpretVertex(begin, first + v, cfg, end, valid);
+
+      INFO("vertex " << first + v << " of format " << ToStr(cfg.position.format.compType) << " x "
+                     << uint32_t(cfg.position.format.compCount));
+
+      // compare bitwise, since half floats made from arbitrary data can be NaN
+      CHECK(memcmp(&batched[v], &single, sizeof(FloatVector)) == 0);
+    }
+  }
+}
+
+TEST_CASE("Resource usage index", "[usage]")
+{
+  ResourceId a = ResourceIDGen::GetNewUniqueID();
+  ResourceId b = ResourceIDGen::GetNewUniqueID();
+  ResourceId c = ResourceIDGen::GetNewUniqueID();
+  ResourceId unused = ResourceIDGen::GetNewUniqueID();
+
+  std::map<ResourceId, std::vector<EventUsage> > uses;
+  uses[a] = {EventUsage(5, ResourceUsage::VertexBuffer), EventUsage(9, ResourceUsage::CopySrc)};
+  uses[b] = {EventUsage(5, ResourceUsage::PS_Resource), EventUsage(5, ResourceUsage::VS_Resource),
+             EventUsage(12, ResourceUsage::ColorTarget)};
+  uses[c] = {};
+
+  ResourceUsageIndex index;
+  index.Build(uses, [](ResourceId id) { return id; });
+  index.BuildEventView();
+
+  SECTION("Resource lookup")
+  {
+    CHECK(index.resources.size() == 2);
+
+    std::vector<EventUsage> usage = index.GetUsage(b);
+    REQUIRE(usage.size() == 3);
+    CHECK(usage[0].usage == ResourceUsage::PS_Resource);
+    CHECK(usage[2].eventId == 12);
+
+    CHECK(index.GetUsage(a).size() == 2);
+    CHECK(index.GetUsage(c).empty());
+    CHECK(index.GetUsage(unused).empty());
+  };
+
+  SECTION("Event lookup")
+  {
+    std::vector<ResourceId> res = index.GetEventResources(5);
+    REQUIRE(res.size() == 2);
+    CHECK(res[0] == a);
+    CHECK(res[1] == b);
+
+    CHECK(index.GetEventResources(9) == std::vector<ResourceId>({a}));
+    CHECK(index.GetEventResources(12) == std::vector<ResourceId>({b}));
+    CHECK(index.GetEventResources(6).empty());
+    CHECK(index.GetEventResources(100).empty());
+    CHECK(index.GetEventResources(~0U).empty());
+    CHECK(ResourceUsageIndex().GetEventResources(0).empty());
+  };
+}
+
+TEST_CASE("Benchmark batched vertex position decoding", "[mesh][.benchmark]")
+{
+  // small enough to stay in cache, so this measures decoding rather than memory bandwidth
+  const uint32_t numVerts = 64 * 1024;
+  const int iterations = 100;
+
+  std::vector<byte> data(numVerts * 16);
+  for(size_t i = 0; i < data.size(); i++)
+    data[i] = byte(i * 13);
+
+  std::vector<FloatVector> out(numVerts);
+
+  for(const MeshDisplay &cfg : {
+          GetVertexTestConfig(CompType::Float, 4, 3, 12),
+          GetVertexTestConfig(CompType::Float, 4, 4, 16),
+          GetVertexTestConfig(CompType::Float, 2, 4, 8),
+          GetVertexTestConfig(CompType::SNorm, 2, 4, 8),
+      })
+  {
+    byte *begin = data.data();
+    byte *end = begin + data.size();
+
+    double singleTime = 0.0, batchedTime = 0.0;
+
+    {
+      PerformanceTimer timer;
+
+      bool valid = true;
+      for(int i = 0; i < iterations; i++)
+        for(uint32_t v = 0; v < numVerts; v++)
+          out[v] = HighlightCache::InterpretVertex(begin, v, cfg, end, valid);
+
+      singleTime = timer.GetMilliseconds();
+    }
+
+    {
+      PerformanceTimer timer;
+
+      for(int i = 0; i < iterations; i++)
+        HighlightCache::InterpretVertices(begin, 0, numVerts, cfg, end, out.data());
+
+      batchedTime = timer.GetMilliseconds();
+    }
+
+    RDCLOG("%u x %u-byte %s x %u: per-vertex %.3f ms, batched %.3f ms", numVerts * iterations,
+           cfg.position.format.compByteWidth, ToStr(cfg.position.format.compType).c_str(),
+           cfg.position.format.compCount, singleTime, batchedTime);
+  }
+}
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
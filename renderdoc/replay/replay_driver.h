@@ -38,6 +38,32 @@ struct FrameRecord
 
 DECLARE_REFLECTION_STRUCT(FrameRecord);
 
+// every resource's usage through the frame, packed so that it can be fetched from the driver in one
+// go when a capture is loaded. Resources are sorted by original ID, and the usage of resources[i]
+// is the range [offsets[i], offsets[i+1]) of usage, in event order.
+//
+// The reverse view from each event to the resources it uses isn't transferred, since it can be
+// rebuilt locally from the same data by BuildEventView().
+struct ResourceUsageIndex
+{
+  std::vector<ResourceId> resources;
+  std::vector<uint32_t> offsets;
+  std::vector<EventUsage> usage;
+
+  // resource indices for each event, with the same layout as above indexed by eventId.
+  std::vector<uint32_t> eventOffsets;
+  std::vector<uint32_t> eventResources;
+
+  void Build(const std::map<ResourceId, std::vector<EventUsage> > &uses,
+             std::function<ResourceId(ResourceId)> getOriginalID);
+  void BuildEventView();
+
+  std::vector<EventUsage> GetUsage(ResourceId id) const;
+  std::vector<ResourceId> GetEventResources(uint32_t eventId) const;
+};
+
+DECLARE_REFLECTION_STRUCT(ResourceUsageIndex);
+
 enum class RemapTexture : uint32_t
 {
   NoRemap,
@@ -108,6 +134,7 @@ public:
                                    const string &target) = 0;
 
   virtual vector<EventUsage> GetUsage(ResourceId id) = 0;
+  virtual ResourceUsageIndex GetUsageIndex() = 0;
 
   virtual void SavePipelineState() = 0;
   virtual const D3D11Pipe::State &GetD3D11PipelineState() = 0;
@@ -256,6 +283,12 @@ struct HighlightCache
   static FloatVector InterpretVertex(byte *data, uint32_t vert, const MeshDisplay &cfg, byte *end,
                                      bool &valid);
 
+  // decodes the positions of vertices [first, first+count) into out. Equivalent to calling
+  // InterpretVertex on each in turn, but the format is only dispatched once for the whole range.
+  // Vertices that lie past the end of the data are set to (0, 0, 0, 1).
+  static void InterpretVertices(byte *data, uint32_t first, uint32_t count, const MeshDisplay &cfg,
+                                byte *end, FloatVector *out);
+
   FloatVector InterpretVertex(byte *data, uint32_t vert, const MeshDisplay &cfg, byte *end,
                               bool useidx, bool &valid);
 };
\ No newline at end of file
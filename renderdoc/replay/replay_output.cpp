@@ -23,6 +23,7 @@
  * THE SOFTWARE.
  ******************************************************************************/
 
+#include <algorithm>
 #include "common/common.h"
 #include "maths/matrix.h"
 #include "strings/string_utils.h"
@@ -148,19 +149,144 @@ void ReplayOutput::SetMeshDisplay(const MeshDisplay &o)
   m_MainOutput.dirty = true;
 }
 
-void ReplayOutput::SetFrameEvent(int eventId)
+void ReplayOutput::SetFrameEvent(int eventId, bool force)
 {
+  uint32_t prevEventID = m_EventID;
+
   m_EventID = eventId;
 
   m_OverlayDirty = true;
   m_MainOutput.dirty = true;
 
+  // a forced refresh means the replay itself was modified, e.g. by replacing a resource, so any
+  // texture contents could have changed regardless of where they're written.
+  if(force)
+    m_TextureWrites.clear();
+
   for(size_t i = 0; i < m_Thumbnails.size(); i++)
-    m_Thumbnails[i].dirty = true;
+  {
+    if(force || TextureWrittenBetween(m_Thumbnails[i].texture, prevEventID, m_EventID))
+      m_Thumbnails[i].dirty = true;
+  }
+
+  m_MinMaxCache.clear();
+  m_HistogramCache.clear();
 
   RefreshOverlay();
 }
 
+bool ReplayOutput::TextureWrittenBetween(ResourceId texture, uint32_t eventA, uint32_t eventB)
+{
+  if(texture == ResourceId())
+    return false;
+
+  // GL and D3D11 can update texture contents from the CPU with glTexSubImage*, Map or
+  // UpdateSubresource, which isn't recorded as usage. Any texture could change on any event there.
+  const GraphicsAPI api = m_pRenderer->m_APIProps.pipelineType;
+  if(api == GraphicsAPI::OpenGL || api == GraphicsAPI::D3D11)
+    return eventA != eventB;
+
+  // the contents at an event include that event's own writes, so the texture differs between the
+  // two events if it's written after the earlier one, up to and including the later one.
+  uint32_t lo = RDCMIN(eventA, eventB);
+  uint32_t hi = RDCMAX(eventA, eventB);
+
+  // Vulkan and D3D12 can write mapped memory from the CPU, which isn't recorded as usage either.
+  // We don't know which textures live in the written memory, so any such write counts for all.
+  if(!m_CPUWritesFetched)
+    FetchCPUWriteEvents();
+
+  auto cpu = std::upper_bound(m_CPUWriteEvents.begin(), m_CPUWriteEvents.end(), lo);
+  if(cpu != m_CPUWriteEvents.end() && *cpu <= hi)
+    return true;
+
+  auto it = m_TextureWrites.find(texture);
+
+  if(it == m_TextureWrites.end())
+  {
+    std::vector<uint32_t> &writes = m_TextureWrites[texture];
+
+    for(const EventUsage &u : m_pRenderer->m_UsageIndex.GetUsage(texture))
+    {
+      switch(u.usage)
+      {
+        case ResourceUsage::VertexBuffer:
+        case ResourceUsage::IndexBuffer:
+        case ResourceUsage::VS_Constants:
+        case ResourceUsage::HS_Constants:
+        case ResourceUsage::DS_Constants:
+        case ResourceUsage::GS_Constants:
+        case ResourceUsage::PS_Constants:
+        case ResourceUsage::CS_Constants:
+        case ResourceUsage::All_Constants:
+        case ResourceUsage::VS_Resource:
+        case ResourceUsage::HS_Resource:
+        case ResourceUsage::DS_Resource:
+        case ResourceUsage::GS_Resource:
+        case ResourceUsage::PS_Resource:
+        case ResourceUsage::CS_Resource:
+        case ResourceUsage::All_Resource:
+        case ResourceUsage::InputTarget:
+        case ResourceUsage::CopySrc:
+        case ResourceUsage::ResolveSrc:
+        case ResourceUsage::Indirect:
+          // read-only
+          break;
+
+        // anything else, including layout transitions in barriers, might modify the contents
+        default: writes.push_back(u.eventId); break;
+      }
+    }
+
+    std::sort(writes.begin(), writes.end());
+
+    it = m_TextureWrites.find(texture);
+  }
+
+  auto w = std::upper_bound(it->second.begin(), it->second.end(), lo);
+
+  return w != it->second.end() && *w <= hi;
+}
+
+void ReplayOutput::FetchCPUWriteEvents()
+{
+  m_CPUWritesFetched = true;
+  m_CPUWriteEvents.clear();
+
+  // chunks that write mapped memory from the CPU
+  static const char *cpuWriteChunks[] = {
+      "vkUnmapMemory", "vkFlushMappedMemoryRanges", "ID3D12Resource::Unmap",
+      "ID3D12Resource::WriteToSubresource",
+  };
+
+  const SDFile &file = m_pRenderer->GetStructuredFile();
+
+  for(const DrawcallDescription *draw : m_pRenderer->m_Drawcalls)
+  {
+    if(draw == NULL)
+      continue;
+
+    for(const APIEvent &ev : draw->events)
+    {
+      if(ev.chunkIndex >= file.chunks.size())
+        continue;
+
+      const rdcstr &name = file.chunks[ev.chunkIndex]->name;
+
+      for(const char *cpuWrite : cpuWriteChunks)
+      {
+        if(name == cpuWrite)
+        {
+          m_CPUWriteEvents.push_back(ev.eventId);
+          break;
+        }
+      }
+    }
+  }
+
+  std::sort(m_CPUWriteEvents.begin(), m_CPUWriteEvents.end());
+}
+
 void ReplayOutput::RefreshOverlay()
 {
   DrawcallDescription *draw = m_pRenderer->GetDrawcallByEID(m_EventID);
@@ -284,56 +410,109 @@ bool ReplayOutput::AddThumbnail(WindowingData window, ResourceId texID, CompType
   return true;
 }
 
-rdcpair<PixelValue, PixelValue> ReplayOutput::GetMinMax()
+bool ReplayOutput::TextureStatsKey::operator<(const TextureStatsKey &o) const
 {
-  PixelValue minval;
-  PixelValue maxval;
+  if(texture != o.texture)
+    return texture < o.texture;
+  if(sliceFace != o.sliceFace)
+    return sliceFace < o.sliceFace;
+  if(mip != o.mip)
+    return mip < o.mip;
+  if(sample != o.sample)
+    return sample < o.sample;
+  return typeHint < o.typeHint;
+}
 
-  ResourceId tex = m_pDevice->GetLiveID(m_RenderData.texDisplay.resourceId);
+bool ReplayOutput::HistogramKey::operator<(const HistogramKey &o) const
+{
+  if(tex < o.tex || o.tex < tex)
+    return tex < o.tex;
+  if(minval != o.minval)
+    return minval < o.minval;
+  if(maxval != o.maxval)
+    return maxval < o.maxval;
+  return channels < o.channels;
+}
 
-  CompType typeHint = m_RenderData.texDisplay.typeHint;
-  uint32_t slice = m_RenderData.texDisplay.sliceFace;
-  uint32_t mip = m_RenderData.texDisplay.mip;
-  uint32_t sample = m_RenderData.texDisplay.sampleIdx;
+bool ReplayOutput::GetTextureStatsKey(TextureStatsKey &key)
+{
+  key.texture = m_pDevice->GetLiveID(m_RenderData.texDisplay.resourceId);
+  key.typeHint = m_RenderData.texDisplay.typeHint;
+  key.sliceFace = m_RenderData.texDisplay.sliceFace;
+  key.mip = m_RenderData.texDisplay.mip;
+  key.sample = m_RenderData.texDisplay.sampleIdx;
 
   if(m_RenderData.texDisplay.customShaderId != ResourceId() &&
      m_CustomShaderResourceId != ResourceId())
   {
-    tex = m_CustomShaderResourceId;
-    typeHint = CompType::Typeless;
-    slice = 0;
-    sample = 0;
+    key.texture = m_CustomShaderResourceId;
+    key.typeHint = CompType::Typeless;
+    key.sliceFace = 0;
+    key.sample = 0;
+
+    // the custom shader output is re-rendered with the current display settings every time it's
+    // displayed, so it can change without the event changing and can't be cached.
+    return false;
   }
 
-  m_pDevice->GetMinMax(tex, slice, mip, sample, typeHint, &minval.floatValue[0],
-                       &maxval.floatValue[0]);
+  return true;
+}
+
+rdcpair<PixelValue, PixelValue> ReplayOutput::GetMinMax()
+{
+  TextureStatsKey key;
+  bool cacheable = GetTextureStatsKey(key);
 
-  return make_rdcpair(minval, maxval);
+  if(cacheable)
+  {
+    auto it = m_MinMaxCache.find(key);
+    if(it != m_MinMaxCache.end())
+      return it->second;
+  }
+
+  PixelValue minval;
+  PixelValue maxval;
+
+  m_pDevice->GetMinMax(key.texture, key.sliceFace, key.mip, key.sample, key.typeHint,
+                       &minval.floatValue[0], &maxval.floatValue[0]);
+
+  rdcpair<PixelValue, PixelValue> ret = make_rdcpair(minval, maxval);
+
+  if(cacheable)
+    m_MinMaxCache[key] = ret;
+
+  return ret;
 }
 
 rdcarray<uint32_t> ReplayOutput::GetHistogram(float minval, float maxval, bool channels[4])
 {
-  vector<uint32_t> hist;
-
-  ResourceId tex = m_pDevice->GetLiveID(m_RenderData.texDisplay.resourceId);
+  HistogramKey key;
+  bool cacheable = GetTextureStatsKey(key.tex);
 
-  CompType typeHint = m_RenderData.texDisplay.typeHint;
-  uint32_t slice = m_RenderData.texDisplay.sliceFace;
-  uint32_t mip = m_RenderData.texDisplay.mip;
-  uint32_t sample = m_RenderData.texDisplay.sampleIdx;
+  key.minval = minval;
+  key.maxval = maxval;
+  key.channels = 0;
+  for(uint32_t i = 0; i < 4; i++)
+    key.channels |= channels[i] ? (1U << i) : 0;
 
-  if(m_RenderData.texDisplay.customShaderId != ResourceId() &&
-     m_CustomShaderResourceId != ResourceId())
+  if(cacheable)
   {
-    tex = m_CustomShaderResourceId;
-    typeHint = CompType::Typeless;
-    slice = 0;
-    sample = 0;
+    auto it = m_HistogramCache.find(key);
+    if(it != m_HistogramCache.end())
+      return it->second;
   }
 
-  m_pDevice->GetHistogram(tex, slice, mip, sample, typeHint, minval, maxval, channels, hist);
+  vector<uint32_t> hist;
+
+  m_pDevice->GetHistogram(key.tex.texture, key.tex.sliceFace, key.tex.mip, key.tex.sample,
+                          key.tex.typeHint, minval, maxval, channels, hist);
+
+  rdcarray<uint32_t> ret = hist;
 
-  return hist;
+  if(cacheable)
+    m_HistogramCache[key] = ret;
+
+  return ret;
 }
 
 PixelValue ReplayOutput::PickPixel(ResourceId tex, bool customShader, uint32_t x, uint32_t y,
@@ -0,0 +1,387 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017-2018 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "blobstore.h"
+#include "3rdparty/zstd/xxhash.h"
+#include "lz4io.h"
+#include "rdcfile.h"
+#include "serialiser.h"
+
+/*
+
+ ContentBlobs section format, version 1:
+
+ byte blobData[]; // each blob compressed as a separate LZ4 stream, tightly packed
+
+ BlobEntry
+ {
+   uint64_t hash;             // 64-bit content hash of the uncompressed data
+   uint64_t reserved;         // unused, zero
+   uint64_t offset;           // offset of the compressed data from the start of the section
+   uint64_t compressedSize;   // byte length of the compressed data
+   uint64_t uncompressedSize; // byte length of the blob itself
+ } index[blobCount];
+
+ uint64_t blobCount;
+
+ The index comes last so that blobs can be compressed straight into the section without buffering.
+*/
+
+static const uint64_t BlobSectionVersion = 1;
+
+BlobStore::~BlobStore()
+{
+  for(byte *data : m_BlobData)
+    FreeAlignedBuffer(data);
+}
+
+// Any hash matches are compared in full, so the hash only needs to make collisions rare rather than
+// impossible and a single 64-bit pass is enough.
+
+uint32_t BlobStore::AddBlob(const byte *data, uint64_t byteSize)
+{
+  uint64_t hash = XXH64(data, (size_t)byteSize, 0);
+
+  return AddBlob(hash, byteSize,
+                 [data, byteSize](const byte *stored) {
+                   return memcmp(stored, data, (size_t)byteSize) == 0;
+                 },
+                 [data, byteSize](byte *dst) { memcpy(dst, data, (size_t)byteSize); });
+}
+
+uint32_t BlobStore::AddBlob(const StridedByteBuffer &data)
+{
+  // hashes identically to the packed data, so strided and packed copies of the same contents match
+  XXH64_state_t *state = XXH64_createState();
+  XXH64_reset(state, 0);
+
+  for(uint64_t s = 0; s < data.sliceCount; s++)
+  {
+    const byte *src = data.data + s * data.sliceStride;
+    for(uint64_t r = 0; r < data.rowCount; r++)
+    {
+      XXH64_update(state, src, (size_t)data.rowSize);
+      src += data.rowStride;
+    }
+  }
+
+  uint64_t hash = XXH64_digest(state);
+  XXH64_freeState(state);
+
+  return AddBlob(hash, data.GetSize(),
+                 [&data](const byte *stored) {
+                   for(uint64_t s = 0; s < data.sliceCount; s++)
+                   {
+                     const byte *src = data.data + s * data.sliceStride;
+                     for(uint64_t r = 0; r < data.rowCount; r++)
+                     {
+                       if(memcmp(stored, src, (size_t)data.rowSize) != 0)
+                         return false;
+                       stored += data.rowSize;
+                       src += data.rowStride;
+                     }
+                   }
+                   return true;
+                 },
+                 [&data](byte *dst) { data.CopyTo(dst); });
+}
+
+uint32_t BlobStore::AddBlob(uint64_t hash, uint64_t byteSize,
+                            std::function<bool(const byte *)> matches,
+                            std::function<void(byte *)> copy)
+{
+  m_AddedSize += byteSize;
+
+  auto range = m_Lookup.equal_range(hash);
+  for(auto it = range.first; it != range.second; ++it)
+  {
+    const uint32_t idx = it->second;
+    if(m_Blobs[idx].uncompressedSize == byteSize && matches(m_BlobData[idx]))
+      return idx;
+  }
+
+  const uint32_t idx = (uint32_t)m_Blobs.size();
+
+  BlobEntry entry = {};
+  entry.hash = hash;
+  entry.uncompressedSize = byteSize;
+  m_Blobs.push_back(entry);
+
+  byte *stored = AllocAlignedBuffer(byteSize);
+  copy(stored);
+  m_BlobData.push_back(stored);
+
+  m_Lookup.insert(std::make_pair(hash, idx));
+
+  m_StoredSize += byteSize;
+
+  return idx;
+}
+
+bool BlobStore::WriteSection(RDCFile *rdc) const
+{
+  if(m_Blobs.empty())
+    return true;
+
+  SectionProperties props;
+  props.type = SectionType::ContentBlobs;
+  props.version = BlobSectionVersion;
+
+  StreamWriter *writer = rdc->WriteSection(props);
+
+  std::vector<BlobEntry> index = m_Blobs;
+
+  for(size_t i = 0; i < index.size(); i++)
+  {
+    index[i].offset = writer->GetOffset();
+
+    {
+      StreamWriter compWriter(new LZ4Compressor(writer, Ownership::Nothing), Ownership::Stream);
+      compWriter.Write(m_BlobData[i], index[i].uncompressedSize);
+      compWriter.Finish();
+    }
+
+    index[i].compressedSize = writer->GetOffset() - index[i].offset;
+  }
+
+  uint64_t blobCount = index.size();
+
+  writer->Write(index.data(), index.size() * sizeof(BlobEntry));
+  writer->Write(blobCount);
+
+  writer->Finish();
+
+  bool success = !writer->IsErrored();
+
+  delete writer;
+
+  RDCLOG("Wrote %zu unique blobs for %.2f MB of buffer data, %.2f MB before deduplication",
+         m_Blobs.size(), double(m_StoredSize) / (1024.0 * 1024.0),
+         double(m_AddedSize) / (1024.0 * 1024.0));
+
+  return success;
+}
+
+bool BlobStore::Open(RDCFile *rdc)
+{
+  m_RDC = NULL;
+  m_Blobs.clear();
+
+  int idx = rdc->SectionIndex(SectionType::ContentBlobs);
+
+  if(idx < 0)
+    return false;
+
+  const SectionProperties &props = rdc->GetSectionProperties(idx);
+
+  if(props.version != BlobSectionVersion || props.flags != SectionFlags::NoFlags)
+  {
+    RDCERR("Unsupported content blob section, version %llu flags %x", props.version, props.flags);
+    return false;
+  }
+
+  const uint64_t sectionSize = props.uncompressedSize;
+
+  uint64_t blobCount = 0;
+
+  if(sectionSize < sizeof(blobCount) ||
+     !rdc->ReadSectionData(idx, sectionSize - sizeof(blobCount), &blobCount, sizeof(blobCount)))
+  {
+    RDCERR("Couldn't read content blob count");
+    return false;
+  }
+
+  const uint64_t indexSize = blobCount * sizeof(BlobEntry);
+
+  if(blobCount > (sectionSize / sizeof(BlobEntry)) || indexSize + sizeof(blobCount) > sectionSize)
+  {
+    RDCERR("Corrupt content blob section, %llu blobs don't fit in %llu bytes", blobCount,
+           sectionSize);
+    return false;
+  }
+
+  const uint64_t indexOffset = sectionSize - sizeof(blobCount) - indexSize;
+
+  m_Blobs.resize((size_t)blobCount);
+
+  if(!rdc->ReadSectionData(idx, indexOffset, m_Blobs.data(), indexSize))
+  {
+    RDCERR("Couldn't read content blob index");
+    m_Blobs.clear();
+    return false;
+  }
+
+  for(const BlobEntry &entry : m_Blobs)
+  {
+    if(entry.offset > indexOffset || entry.compressedSize > indexOffset - entry.offset)
+    {
+      RDCERR("Corrupt content blob index entry");
+      m_Blobs.clear();
+      return false;
+    }
+  }
+
+  m_RDC = rdc;
+  m_SectionIndex = idx;
+
+  return true;
+}
+
+bool BlobStore::ReadBlob(uint32_t index, byte *data, uint64_t byteSize) const
+{
+  if(m_RDC == NULL || index >= m_Blobs.size())
+  {
+    RDCERR("Invalid content blob %u referenced", index);
+    return false;
+  }
+
+  const BlobEntry &entry = m_Blobs[index];
+
+  if(entry.uncompressedSize != byteSize)
+  {
+    RDCERR("Content blob %u is %llu bytes, expected %llu", index, entry.uncompressedSize,
+           byteSize);
+    return false;
+  }
+
+  std::vector<byte> compressed;
+  compressed.resize((size_t)entry.compressedSize);
+
+  if(!m_RDC->ReadSectionData(m_SectionIndex, entry.offset, compressed.data(), entry.compressedSize))
+    return false;
+
+  StreamReader reader(new LZ4Decompressor(new StreamReader(compressed), Ownership::Stream),
+                      byteSize, Ownership::Stream);
+
+  return reader.Read(data, byteSize);
+}
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#include "3rdparty/catch/catch.hpp"
+#include "serialiser.h"
+
+TEST_CASE("Test content blob deduplication", "[blobstore]")
+{
+  std::vector<byte> zeros(64 * 1024, 0);
+  std::vector<byte> pattern(BlobStore::MinimumBlobSize);
+  for(size_t i = 0; i < pattern.size(); i++)
+    pattern[i] = byte(i * 7);
+
+  // the same contents as pattern, in padded rows
+  const uint64_t rowSize = 256, rowStride = 320;
+  std::vector<byte> padded(size_t(pattern.size() / rowSize * rowStride), 0xcc);
+  for(size_t r = 0; r < pattern.size() / rowSize; r++)
+    memcpy(&padded[r * rowStride], &pattern[r * rowSize], (size_t)rowSize);
+
+  StridedByteBuffer strided;
+  strided.data = padded.data();
+  strided.rowSize = rowSize;
+  strided.rowStride = rowStride;
+  strided.rowCount = pattern.size() / rowSize;
+
+  RDCFile rdc;
+  rdc.SetData(RDCDriver::Vulkan, "Vulkan", 0, NULL);
+
+  {
+    SectionProperties props;
+    props.type = SectionType::FrameCapture;
+    props.version = 1;
+
+    StreamWriter *writer = rdc.WriteSection(props);
+
+    BlobStore blobs;
+
+    {
+      WriteSerialiser ser(writer, Ownership::Nothing);
+      ser.SetBlobStore(&blobs);
+
+      ser.BeginChunk(1, 0);
+      for(int i = 0; i < 3; i++)
+      {
+        byte *buf = zeros.data();
+        ser.Serialise("zeros", buf, zeros.size());
+        buf = pattern.data();
+        ser.Serialise("pattern", buf, pattern.size());
+      }
+      // strided data is deduplicated against the packed contents
+      ser.SerialiseStrided("strided", strided);
+      // small buffers are never deduplicated
+      byte *buf = pattern.data();
+      ser.Serialise("small", buf, 16ULL);
+      ser.EndChunk();
+    }
+
+    writer->Finish();
+
+    // the frame capture only contains references, nowhere near the buffer contents
+    CHECK(writer->GetOffset() < zeros.size());
+
+    delete writer;
+
+    CHECK(blobs.GetStoredSize() == zeros.size() + pattern.size());
+    CHECK(blobs.GetAddedSize() == (zeros.size() + pattern.size()) * 3 + pattern.size());
+
+    CHECK(blobs.WriteSection(&rdc));
+  }
+
+  BlobStore blobs;
+  REQUIRE(blobs.Open(&rdc));
+
+  ReadSerialiser ser(rdc.ReadSection(rdc.SectionIndex(SectionType::FrameCapture)),
+                     Ownership::Stream);
+  ser.SetBlobStore(&blobs);
+
+  CHECK(ser.ReadChunk<uint32_t>() == 1);
+
+  for(int i = 0; i < 3; i++)
+  {
+    byte *buf = NULL;
+    ser.Serialise("zeros", buf, 0ULL, SerialiserFlags::AllocateMemory);
+    CHECK(!memcmp(buf, zeros.data(), zeros.size()));
+    FreeAlignedBuffer(buf);
+
+    buf = NULL;
+    ser.Serialise("pattern", buf, 0ULL, SerialiserFlags::AllocateMemory);
+    CHECK(!memcmp(buf, pattern.data(), pattern.size()));
+    FreeAlignedBuffer(buf);
+  }
+
+  byte *buf = NULL;
+  ser.Serialise("strided", buf, 0ULL, SerialiserFlags::AllocateMemory);
+  CHECK(!memcmp(buf, pattern.data(), pattern.size()));
+  FreeAlignedBuffer(buf);
+
+  buf = NULL;
+  ser.Serialise("small", buf, 0ULL, SerialiserFlags::AllocateMemory);
+  CHECK(!memcmp(buf, pattern.data(), 16));
+  FreeAlignedBuffer(buf);
+
+  ser.EndChunk();
+
+  CHECK(!ser.IsErrored());
+}
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
@@ -0,0 +1,106 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017-2018 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <vector>
+#include "common/common.h"
+
+class RDCFile;
+struct StridedByteBuffer;
+
+// Content-addressed storage for large byte buffers. When a serialiser has a blob store attached,
+// any byte buffer of at least MinimumBlobSize is stored here once per unique contents, and the
+// serialised stream only contains a reference to it. This is mostly useful for initial contents,
+// where zero-filled buffers and duplicated textures are common.
+//
+// The blobs are written into their own section of the capture, each compressed separately so that
+// they can be read back in any order.
+class BlobStore
+{
+public:
+  // buffers smaller than this are always written inline, since hashing and looking them up isn't
+  // worth it.
+  static const uint64_t MinimumBlobSize = 4096;
+
+  // set in the serialised byte size of a buffer to indicate it's a reference to a blob
+  static const uint64_t ReferenceFlag = 0x8000000000000000ULL;
+
+  BlobStore() = default;
+  ~BlobStore();
+
+  // no copies
+  BlobStore(const BlobStore &other) = delete;
+
+  // for writing: returns the index of the blob with these contents, adding a copy of it if this is
+  // the first time the contents have been seen.
+  uint32_t AddBlob(const byte *data, uint64_t byteSize);
+  // as above for rows gathered from a strided buffer. The rows are only packed into a copy if the
+  // contents are new.
+  uint32_t AddBlob(const StridedByteBuffer &data);
+
+  // writes all blobs added above into a ContentBlobs section in the given file.
+  bool WriteSection(RDCFile *rdc) const;
+
+  // the total uncompressed size of the unique blobs held in memory for writing.
+  uint64_t GetStoredSize() const { return m_StoredSize; }
+  // the total size of all buffers added, including duplicates.
+  uint64_t GetAddedSize() const { return m_AddedSize; }
+  // for reading: loads the blob index from the file's ContentBlobs section. Returns false if there
+  // isn't one or it's corrupt.
+  bool Open(RDCFile *rdc);
+
+  // for reading: decompresses the given blob into data, which must be byteSize bytes.
+  bool ReadBlob(uint32_t index, byte *data, uint64_t byteSize) const;
+
+private:
+  struct BlobEntry
+  {
+    uint64_t hash;
+    uint64_t reserved;
+    uint64_t offset;
+    uint64_t compressedSize;
+    uint64_t uncompressedSize;
+  };
+
+  // returns the index of an existing blob with this hash and size for which matches() is true, or
+  // adds a new one filled by copy() if there isn't one.
+  uint32_t AddBlob(uint64_t hash, uint64_t byteSize, std::function<bool(const byte *)> matches,
+                   std::function<void(byte *)> copy);
+
+  // writing
+  std::multimap<uint64_t, uint32_t> m_Lookup;
+  std::vector<byte *> m_BlobData;
+  uint64_t m_StoredSize = 0;
+  uint64_t m_AddedSize = 0;
+
+  // reading
+  RDCFile *m_RDC = NULL;
+  int m_SectionIndex = -1;
+
+  std::vector<BlobEntry> m_Blobs;
+};
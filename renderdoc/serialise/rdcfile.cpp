@@ -721,7 +721,10 @@ StreamReader *RDCFile::ReadSection(int index) const
 
   const SectionProperties &props = m_Sections[index];
   SectionLocation offsetSize = m_SectionLocations[index];
-  FileIO::fseek64(m_File, offsetSize.dataOffset, SEEK_SET);
+  {
+    SCOPED_LOCK(m_FileLock);
+    FileIO::fseek64(m_File, offsetSize.dataOffset, SEEK_SET);
+  }
 
   StreamReader *fileReader = new StreamReader(m_File, offsetSize.diskLength, Ownership::Nothing);
 
@@ -744,6 +747,52 @@ StreamReader *RDCFile::ReadSection(int index) const
   return compReader ? compReader : fileReader;
 }
 
+bool RDCFile::ReadSectionData(int index, uint64_t offset, void *data, uint64_t length) const
+{
+  if(m_Error != ContainerError::NoError || index < 0 || index >= NumSections())
+    return false;
+
+  const SectionProperties &props = m_Sections[index];
+
+  if(props.flags & (SectionFlags::LZ4Compressed | SectionFlags::ZstdCompressed))
+  {
+    RDCERR("Can't read directly from compressed section %d", index);
+    return false;
+  }
+
+  if(offset > props.uncompressedSize || length > props.uncompressedSize - offset)
+  {
+    RDCERR("Reading %llu bytes at %llu is out of bounds of section %d", length, offset, index);
+    return false;
+  }
+
+  if(m_File == NULL)
+  {
+    if(index >= (int)m_MemorySections.size())
+    {
+      RDCERR("Section %d is not available in memory.", index);
+      return false;
+    }
+
+    memcpy(data, m_MemorySections[index].data() + offset, (size_t)length);
+    return true;
+  }
+
+  SCOPED_LOCK(m_FileLock);
+
+  // a section reader from ReadSection() may be part-way through the file, so restore the position
+  // afterwards.
+  uint64_t prevOffs = FileIO::ftell64(m_File);
+
+  FileIO::fseek64(m_File, m_SectionLocations[index].dataOffset + offset, SEEK_SET);
+
+  bool success = FileIO::fread(data, 1, (size_t)length, m_File) == (size_t)length;
+
+  FileIO::fseek64(m_File, prevOffs, SEEK_SET);
+
+  return success;
+}
+
 StreamWriter *RDCFile::WriteSection(const SectionProperties &props)
 {
   if(m_Error != ContainerError::NoError)
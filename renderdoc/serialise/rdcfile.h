@@ -84,6 +84,8 @@ public:
   int NumSections() const { return int(m_Sections.size()); }
   const SectionProperties &GetSectionProperties(int index) const { return m_Sections[index]; }
   StreamReader *ReadSection(int index) const;
+  // reads a range of an uncompressed section directly, without disturbing any open section reader
+  bool ReadSectionData(int index, uint64_t offset, void *data, uint64_t length) const;
   StreamWriter *WriteSection(const SectionProperties &props);
 
   // Only valid if GetDriver returns RDCDriver::Image, passes over the underlying FILE * for use
@@ -95,6 +97,10 @@ private:
 
   FILE *m_File = NULL;
   std::string m_Filename;
+
+  // ReadSectionData can be called from other threads, e.g. blob reads, so any seeking of m_File to
+  // read from it must hold this lock.
+  mutable Threading::CriticalSection m_FileLock;
   std::vector<byte> m_Buffer;
 
   SectionProperties m_CurrentWritingProps;
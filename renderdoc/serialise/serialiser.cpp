@@ -256,6 +256,8 @@ void Serialiser<SerialiserMode::Writing>::SetChunkMetadataRecording(uint32_t fla
 template <>
 uint32_t Serialiser<SerialiserMode::Writing>::BeginChunk(uint32_t chunkID, uint32_t byteLength)
 {
+  SCOPED_PROBE(BeginChunk);
+
   {
     // chunk index needs to be valid
     RDCASSERT(chunkID > 0);
@@ -29,6 +29,7 @@
 #include <string>
 #include <vector>
 #include "api/replay/renderdoc_replay.h"
+#include "blobstore.h"
 #include "streamio.h"
 
 // function to deallocate anything from a serialise. Default impl
@@ -61,6 +62,36 @@ enum class SerialiserFlags
 
 BITMASK_OPERATORS(SerialiserFlags);
 
+// describes a byte buffer that is laid out in memory as regularly strided rows, optionally grouped
+// into regularly strided slices. This allows serialising tightly packed data directly out of
+// padded or offset source memory without repacking it into a temporary buffer first.
+struct StridedByteBuffer
+{
+  const byte *data = NULL;
+  uint64_t rowSize = 0;
+  uint64_t rowStride = 0;
+  uint64_t rowCount = 1;
+  uint64_t sliceStride = 0;
+  uint64_t sliceCount = 1;
+
+  // the size of the data once it's tightly packed
+  uint64_t GetSize() const { return rowSize * rowCount * sliceCount; }
+  // copy the rows out tightly packed to dst, which must be at least GetSize() bytes
+  void CopyTo(byte *dst) const
+  {
+    for(uint64_t s = 0; s < sliceCount; s++)
+    {
+      const byte *src = data + s * sliceStride;
+      for(uint64_t r = 0; r < rowCount; r++)
+      {
+        memcpy(dst, src, (size_t)rowSize);
+        dst += rowSize;
+        src += rowStride;
+      }
+    }
+  }
+};
+
 // This class is used to read and write arbitrary structured data from a stream. The primary
 // mechanism is in template overloads of DoSerialise functions for each struct that can be
 // serialised, down to primitive types (ints, floats, strings, etc).
@@ -123,6 +154,9 @@ public:
   void *GetUserData() { return m_pUserData; }
   void SetUserData(void *userData) { m_pUserData = userData; }
   void SetStringDatabase(std::set<std::string> *db) { m_ExtStringDB = db; }
+  // when set, large byte buffers are written as references to deduplicated blobs in the store, and
+  // any such references are resolved from it when reading.
+  void SetBlobStore(BlobStore *blobs) { m_BlobStore = blobs; }
   // jumps to the byte after the current chunk, can be called any time after BeginChunk
   void SkipCurrentChunk();
 
@@ -215,15 +249,37 @@ public:
     if(IsWriting() && el == NULL)
       byteSize = 0;
 
+    bool isBlob = false;
+    uint32_t blobIndex = 0;
+
+    if(IsWriting() && m_BlobStore && byteSize >= BlobStore::MinimumBlobSize)
+    {
+      isBlob = true;
+      blobIndex = m_BlobStore->AddBlob(el, byteSize);
+    }
+
     {
       m_InternalElement = true;
-      DoSerialise(*this, byteSize);
+
+      // blob references are marked in the size, which can never legitimately be that large
+      uint64_t serialisedSize = isBlob ? (byteSize | BlobStore::ReferenceFlag) : byteSize;
+      DoSerialise(*this, serialisedSize);
+
+      if(IsReading())
+      {
+        isBlob = (serialisedSize & BlobStore::ReferenceFlag) != 0;
+        byteSize = serialisedSize & ~BlobStore::ReferenceFlag;
+      }
+
+      if(isBlob)
+        DoSerialise(*this, blobIndex);
+
       m_InternalElement = false;
     }
 
     if(IsReading())
     {
-      VerifyArraySize(byteSize);
+      VerifyArraySize(byteSize, isBlob);
     }
 
     if(ExportStructure())
@@ -247,6 +303,27 @@ public:
 
     byte *tempAlloc = NULL;
 
+    if(isBlob)
+    {
+      // the contents live in the blob store, nothing else to write
+      if(IsReading())
+      {
+#if !defined(__COVERITY__)
+        if(flags & SerialiserFlags::AllocateMemory)
+          el = byteSize > 0 ? AllocAlignedBuffer(byteSize) : NULL;
+
+        if(el == NULL && ExportStructure() && m_ExportBuffers && byteSize > 0)
+          el = tempAlloc = AllocAlignedBuffer(byteSize);
+#endif
+
+        if(el && m_BlobStore && !m_BlobStore->ReadBlob(blobIndex, el, byteSize))
+        {
+          RDCERR("Couldn't read content blob %u for byte buffer", blobIndex);
+          SetReadErrored();
+        }
+      }
+    }
+    else
     {
       if(IsWriting())
       {
@@ -1163,6 +1240,74 @@ public:
     return *this;
   }
 
+  // writes a strided byte buffer so that it reads back identically to a tightly packed byte buffer
+  // serialised with Serialise() above, but without needing a packed copy. Rows are written one by
+  // one straight into the stream.
+  Serialiser &SerialiseStrided(const char *name, const StridedByteBuffer &el)
+  {
+    if(IsReading())
+    {
+      RDCERR("Strided byte buffers can only be written, not read");
+      return *this;
+    }
+
+    uint64_t byteSize = el.data ? el.GetSize() : 0;
+
+    // large buffers go to the blob store, which only packs the rows if the contents are new. This
+    // writes the same reference as Serialise() would for the packed data.
+    if(m_BlobStore && byteSize >= BlobStore::MinimumBlobSize)
+    {
+      uint32_t blobIndex = m_BlobStore->AddBlob(el);
+
+      m_InternalElement = true;
+      uint64_t serialisedSize = byteSize | BlobStore::ReferenceFlag;
+      DoSerialise(*this, serialisedSize);
+      DoSerialise(*this, blobIndex);
+      m_InternalElement = false;
+
+      return *this;
+    }
+
+    {
+      m_InternalElement = true;
+      DoSerialise(*this, byteSize);
+      m_InternalElement = false;
+    }
+
+    // ensure byte alignment
+    m_Write->AlignTo<ChunkAlignment>();
+
+    if(byteSize == 0)
+      return *this;
+
+    // when the rows are contiguous we can write whole slices, or the whole buffer, at once
+    if(el.rowStride == el.rowSize && el.sliceStride == el.rowSize * el.rowCount)
+    {
+      m_Write->Write(el.data, byteSize);
+    }
+    else
+    {
+      for(uint64_t s = 0; s < el.sliceCount; s++)
+      {
+        const byte *src = el.data + s * el.sliceStride;
+
+        if(el.rowStride == el.rowSize)
+        {
+          m_Write->Write(src, el.rowSize * el.rowCount);
+          continue;
+        }
+
+        for(uint64_t r = 0; r < el.rowCount; r++)
+        {
+          m_Write->Write(src, el.rowSize);
+          src += el.rowStride;
+        }
+      }
+    }
+
+    return *this;
+  }
+
   template <class T>
   Serialiser &SerialiseNullable(const char *name, const T *&el,
                                 SerialiserFlags flags = SerialiserFlags::NoFlags)
@@ -1534,7 +1679,7 @@ private:
     }
   };
 
-  void VerifyArraySize(uint64_t &count)
+  void VerifyArraySize(uint64_t &count, bool isBlob = false)
   {
     uint64_t size = m_Read->GetSize();
 
@@ -1542,24 +1687,42 @@ private:
     if(m_DataStreaming)
       size = 0xFFFFFFFFU;
 
+    // blobs are stored outside of the stream, so the stream size doesn't bound them
+    if(isBlob)
+    {
+      if(!m_BlobStore)
+      {
+        RDCERR("Reading byte buffer stored as a content blob, but no blob store is available.");
+        SetReadErrored();
+        count = 0;
+      }
+
+      return;
+    }
+
     if(count > size)
     {
       RDCERR("Reading invalid array or byte buffer - %llu larger than total stream size %llu.",
              count, size);
 
-      // if we owned the previous stream, delete it
-      if(m_Ownership == Ownership::Stream)
-        delete m_Read;
-
-      // replace our stream with an invalid one so all subsequent reads fail
-      m_Read = new StreamReader(StreamReader::InvalidStream);
-      m_Ownership = Ownership::Stream;
+      SetReadErrored();
 
       // set the count to 0
       count = 0;
     }
   }
 
+  void SetReadErrored()
+  {
+    // if we owned the previous stream, delete it
+    if(m_Ownership == Ownership::Stream)
+      delete m_Read;
+
+    // replace our stream with an invalid one so all subsequent reads fail
+    m_Read = new StreamReader(StreamReader::InvalidStream);
+    m_Ownership = Ownership::Stream;
+  }
+
   void *m_pUserData = NULL;
 
   StreamWriter *m_Write = NULL;
@@ -1569,6 +1732,7 @@ private:
 
   // See SetStreamingMode
   bool m_DataStreaming = false;
+  BlobStore *m_BlobStore = NULL;
   bool m_DrawChunk = false;
 
   uint64_t m_LastChunkOffset = 0;
@@ -1317,4 +1317,117 @@ TEST_CASE("Read/write complex types", "[serialiser][structured]")
   delete buf;
 };
 
+TEST_CASE("Extract columns from structured chunks", "[serialiser][structured]")
+{
+  SDFile file;
+
+  for(int i = 0; i < 4; i++)
+  {
+    SDChunk *chunk = new SDChunk(i % 2 ? "vkCmdDraw" : "vkCmdDispatch");
+    chunk->metadata.chunkID = 100 + i;
+    chunk->metadata.durationMicro = -1;
+
+    chunk->data.children.push_back(makeSDObject("count", uint64_t(i * 10)));
+    chunk->data.children.push_back(makeSDObject("scale", float(i) + 0.5f));
+
+    SDObject *arr = makeSDArray("offsets");
+    arr->data.children.push_back(makeSDObject("$el", int64_t(-i)));
+    arr->data.children.push_back(makeSDObject("$el", int64_t(i * 2)));
+
+    SDObject *info = makeSDStruct("info");
+    info->data.children.push_back(arr);
+    chunk->data.children.push_back(info);
+
+    file.chunks.push_back(chunk);
+  }
+
+  SECTION("Single column")
+  {
+    bytebuf col = file.ExtractColumn("vkCmdDraw", "count", SDBasic::UnsignedInteger);
+
+    REQUIRE(col.size() == 2 * sizeof(uint64_t));
+
+    const uint64_t *u = (const uint64_t *)col.data();
+    CHECK(u[0] == 10);
+    CHECK(u[1] == 30);
+
+    col = file.ExtractColumn("", "scale", SDBasic::Float);
+
+    REQUIRE(col.size() == 4 * sizeof(double));
+
+    const double *d = (const double *)col.data();
+    CHECK(d[0] == 0.5);
+    CHECK(d[3] == 3.5);
+
+    col = file.ExtractColumn("vkCmdQueueSubmit", "count", SDBasic::UnsignedInteger);
+
+    CHECK(col.empty());
+  };
+
+  SECTION("Table with paths and metadata")
+  {
+    bytebuf table = file.ExtractTable(
+        "vkCmdDispatch", {"$index", "$chunkID", "$duration", "info.offsets.1", "info.offsets.0",
+                          "info.offsets.5", "missing", "scale"},
+        SDBasic::SignedInteger);
+
+    REQUIRE(table.size() == 2 * 8 * sizeof(int64_t));
+
+    const int64_t *row = (const int64_t *)table.data();
+    CHECK(row[0] == 0);
+    CHECK(row[1] == 100);
+    CHECK(row[2] == -1);
+    CHECK(row[3] == 0);
+    CHECK(row[4] == 0);
+    CHECK(row[5] == 0);
+    CHECK(row[6] == 0);
+    CHECK(row[7] == 0);
+
+    row += 8;
+    CHECK(row[0] == 2);
+    CHECK(row[1] == 102);
+    CHECK(row[2] == -1);
+    CHECK(row[3] == 4);
+    CHECK(row[4] == -2);
+    CHECK(row[5] == 0);
+    CHECK(row[6] == 0);
+    CHECK(row[7] == 2);
+  };
+
+  SECTION("Unrepresentable values and malformed indices")
+  {
+    const float values[] = {NAN, INFINITY, -INFINITY, 1.0e30f, -1.0e30f};
+
+    for(float v : values)
+    {
+      SDChunk *chunk = new SDChunk("vkCmdSetDepthBias");
+      chunk->data.children.push_back(makeSDObject("bias", v));
+      file.chunks.push_back(chunk);
+    }
+
+    bytebuf col = file.ExtractColumn("vkCmdSetDepthBias", "bias", SDBasic::SignedInteger);
+
+    REQUIRE(col.size() == 5 * sizeof(int64_t));
+
+    const int64_t *i = (const int64_t *)col.data();
+    CHECK(i[0] == 0);
+    CHECK(i[1] == INT64_MAX);
+    CHECK(i[2] == INT64_MIN);
+    CHECK(i[3] == INT64_MAX);
+    CHECK(i[4] == INT64_MIN);
+
+    // only all-digit names index into arrays, and huge indices don't wrap around
+    bytebuf table = file.ExtractTable(
+        "vkCmdDraw", {"info.offsets.1x", "info.offsets.01", "info.offsets.18446744073709551617"},
+        SDBasic::SignedInteger);
+
+    REQUIRE(table.size() == 2 * 3 * sizeof(int64_t));
+
+    const int64_t *row = (const int64_t *)table.data();
+    CHECK(row[0] == 0);
+    CHECK(row[1] == 2);
+    CHECK(row[2] == 0);
+  };
+};
+
 #endif    // ENABLED(ENABLE_UNIT_TESTS)
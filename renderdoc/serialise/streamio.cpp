@@ -407,34 +407,27 @@ StreamWriter::~StreamWriter()
 bool StreamWriter::SendSocketData(const void *data, uint64_t numBytes)
 {
   // try to coalesce small writes without doing blocking sends, at least until we're flushed.
-  // if the buffer is already full, flush it.
-  if(m_BufferHead + numBytes >= m_BufferEnd)
+  if(m_BufferHead + numBytes < m_BufferEnd)
   {
-    bool success = FlushSocketData();
-    if(!success)
-    {
-      HandleError();
-      return false;
-    }
-  }
+    memcpy(m_BufferHead, data, (size_t)numBytes);
+    m_BufferHead += numBytes;
 
-  // if it's larger than our buffer (even after flushing) just write directly
-  if(m_BufferHead + numBytes >= m_BufferEnd)
-  {
-    bool success = m_Sock->SendDataBlocking(data, (uint32_t)numBytes);
-    if(!success)
-    {
-      HandleError();
-      return false;
-    }
+    return true;
   }
-  else
+
+  // if it doesn't fit, send what's buffered and the new data together. This avoids a separate
+  // send for e.g. a packet header followed by a large payload, and never copies the payload.
+  bool success = m_Sock->SendDataBlocking(m_BufferBase, uint32_t(m_BufferHead - m_BufferBase),
+                                          data, (uint32_t)numBytes);
+  if(!success)
   {
-    // otherwise, write it into the in-memory buffer
-    memcpy(m_BufferHead, data, (size_t)numBytes);
-    m_BufferHead += numBytes;
+    HandleError();
+    return false;
   }
 
+  // reset buffer to the start
+  m_BufferHead = m_BufferBase;
+
   return true;
 }
 
@@ -488,6 +481,53 @@ void StreamWriter::HandleError()
   m_InMemory = false;
 }
 
+MemoryBlockCompressor::~MemoryBlockCompressor()
+{
+  for(byte *block : m_Blocks)
+    FreeAlignedBuffer(block);
+}
+
+bool MemoryBlockCompressor::Write(const void *data, uint64_t numBytes)
+{
+  const byte *src = (const byte *)data;
+
+  while(numBytes > 0)
+  {
+    uint64_t blockOffset = m_Size % BlockSize;
+
+    // the last block is full (or we don't have one yet)
+    if(blockOffset == 0)
+      m_Blocks.push_back(AllocAlignedBuffer(BlockSize));
+
+    uint64_t copySize = RDCMIN(numBytes, BlockSize - blockOffset);
+
+    memcpy(m_Blocks.back() + blockOffset, src, (size_t)copySize);
+
+    src += copySize;
+    numBytes -= copySize;
+    m_Size += copySize;
+  }
+
+  return true;
+}
+
+bool MemoryBlockCompressor::WriteTo(StreamWriter *writer) const
+{
+  uint64_t remaining = m_Size;
+
+  for(byte *block : m_Blocks)
+  {
+    uint64_t blockSize = RDCMIN(remaining, uint64_t(BlockSize));
+
+    if(!writer->Write(block, blockSize))
+      return false;
+
+    remaining -= blockSize;
+  }
+
+  return true;
+}
+
 void StreamTransfer(StreamWriter *writer, StreamReader *reader, RENDERDOC_ProgressCallback progress)
 {
   uint64_t totalSize = reader->GetSize();
@@ -488,4 +488,27 @@ private:
   std::vector<StreamCloseCallback> m_Callbacks;
 };
 
+// not a real compressor - this just accumulates everything written into a list of fixed-size
+// blocks. That lets a large amount of data be buffered in memory without repeatedly reallocating
+// and copying one contiguous buffer as it grows, so that it can be written on to its real
+// destination later, e.g. on another thread.
+class MemoryBlockCompressor : public Compressor
+{
+public:
+  static const uint64_t BlockSize = 4 * 1024 * 1024;
+
+  MemoryBlockCompressor() : Compressor(NULL, Ownership::Nothing) {}
+  ~MemoryBlockCompressor();
+
+  bool Write(const void *data, uint64_t numBytes);
+  bool Finish() { return true; }
+  uint64_t GetSize() const { return m_Size; }
+  // write everything that's been accumulated to the given writer
+  bool WriteTo(StreamWriter *writer) const;
+
+private:
+  std::vector<byte *> m_Blocks;
+  uint64_t m_Size = 0;
+};
+
 void StreamTransfer(StreamWriter *writer, StreamReader *reader, RENDERDOC_ProgressCallback progress);
\ No newline at end of file
@@ -308,4 +308,121 @@ TEST_CASE("Test stream I/O operations over the network", "[streamio][network]")
   delete server;
 };
 
+// not run by default. Sends traffic shaped like the replay proxy over a loopback socket: large
+// packets like GetTextureData responses (a small header and then the texture contents), and bursts
+// of small packets like most other calls, where each packet is flushed as it's finished.
+TEST_CASE("Benchmark stream I/O throughput over the network", "[streamio][network][.benchmark]")
+{
+  uint16_t port = 8335;
+  Network::Socket *server = NULL;
+
+  for(uint16_t probe = 0; probe < 20; probe++)
+  {
+    server = Network::CreateServerSocket("localhost", port, 2);
+
+    if(server)
+      break;
+
+    port++;
+  }
+
+  REQUIRE(server);
+
+  Network::Socket *sender = Network::CreateClientSocket("localhost", port, 10);
+
+  REQUIRE(sender);
+
+  Network::Socket *receiver = server->AcceptClient(false);
+
+  REQUIRE(receiver);
+
+  const uint64_t payloadSize = 16 * 1024 * 1024;
+  const uint32_t largePackets = 64;
+  const uint32_t smallPackets = 200000;
+
+  byte *payload = new byte[payloadSize];
+  for(uint64_t i = 0; i < payloadSize; i++)
+    payload[i] = byte(i);
+
+  double largeTime = 0.0, smallTime = 0.0;
+
+  {
+    StreamWriter writer(sender, Ownership::Nothing);
+    StreamReader reader(receiver, Ownership::Nothing);
+
+    byte *dest = new byte[payloadSize];
+
+    Threading::ThreadHandle recvThread = Threading::CreateThread([&]() {
+      for(uint32_t p = 0; p < largePackets; p++)
+      {
+        uint64_t header[4];
+        reader.Read(header);
+        reader.Read(dest, header[3]);
+      }
+    });
+
+    PerformanceTimer timer;
+
+    for(uint32_t p = 0; p < largePackets; p++)
+    {
+      uint64_t header[4] = {p, 0, 0, payloadSize};
+      writer.Write(header);
+      writer.Write(payload, payloadSize);
+      writer.Flush();
+    }
+
+    Threading::JoinThread(recvThread);
+    Threading::CloseThread(recvThread);
+
+    largeTime = timer.GetMilliseconds();
+
+    CHECK_FALSE(writer.IsErrored());
+    CHECK_FALSE(reader.IsErrored());
+    CHECK(memcmp(dest, payload, (size_t)payloadSize) == 0);
+
+    delete[] dest;
+  }
+
+  {
+    StreamWriter writer(sender, Ownership::Nothing);
+    StreamReader reader(receiver, Ownership::Nothing);
+
+    Threading::ThreadHandle recvThread = Threading::CreateThread([&]() {
+      for(uint32_t p = 0; p < smallPackets; p++)
+      {
+        uint64_t packet[8];
+        reader.Read(packet);
+      }
+    });
+
+    PerformanceTimer timer;
+
+    for(uint32_t p = 0; p < smallPackets; p++)
+    {
+      uint64_t packet[8] = {p};
+      writer.Write(packet);
+      writer.Flush();
+    }
+
+    Threading::JoinThread(recvThread);
+    Threading::CloseThread(recvThread);
+
+    smallTime = timer.GetMilliseconds();
+
+    CHECK_FALSE(writer.IsErrored());
+    CHECK_FALSE(reader.IsErrored());
+  }
+
+  delete[] payload;
+
+  delete sender;
+  delete receiver;
+  delete server;
+
+  RDCLOG("%u x %llu MB packets: %.2f ms (%.1f MB/s). %u small packets: %.2f ms (%.2f us each)",
+         largePackets, payloadSize / (1024 * 1024), largeTime,
+         double(largePackets * payloadSize) / (1024.0 * 1024.0) / (largeTime / 1000.0),
+         smallPackets, smallTime, smallTime * 1000.0 / double(smallPackets));
+};
+
 #endif    // ENABLED(ENABLE_UNIT_TESTS)
\ No newline at end of file
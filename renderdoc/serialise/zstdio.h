@@ -30,7 +30,7 @@
 class ZSTDCompressor : public Compressor
 {
 public:
-  ZSTDCompressor(StreamWriter *write, Ownership own);
+  ZSTDCompressor(StreamWriter *write, Ownership own, int level = 7);
   ~ZSTDCompressor();
 
   bool Write(const void *data, uint64_t numBytes);
@@ -44,6 +44,7 @@ private:
   byte *m_Page;
   byte *m_CompressBuffer;
   uint64_t m_PageOffset;
+  int m_Level;
 
   ZSTD_CStream *m_Stream;
 };
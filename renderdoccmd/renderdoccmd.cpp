@@ -26,7 +26,14 @@
 #include "renderdoccmd.h"
 #include <app/renderdoc_app.h>
 #include <replay/version.h>
+#include <cmath>
+#include <condition_variable>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
 #include <string>
+#include <thread>
 
 // normally this is in the renderdoc core library, but it's needed for the 'unknown enum' path,
 // so we implement it here using ostringstream. It's not great, but this is a very uncommon path -
@@ -755,6 +762,447 @@ struct ConvertCommand : public Command
   }
 };
 
+struct BatchCommand : public Command
+{
+  BatchCommand(const GlobalEnvironment &env) : Command(env) {}
+  virtual void AddOptions(cmdline::parser &parser)
+  {
+    parser.set_footer("<manifest.txt>");
+    parser.add<string>("analyses", 'a',
+                       "Comma-separated analyses to run: stats, counters, textures, structured.",
+                       false, "stats");
+    parser.add<string>("output", 'o', "The file to write JSON lines results to. Default is stdout.",
+                       false, "");
+    parser.add<string>("output-dir", 'd', "The directory to write textures and exports to.", false,
+                       ".");
+    parser.add<uint32_t>("jobs", 'j', "The number of captures to process at once.", false, 1);
+    parser.add<uint32_t>(
+        "memory-budget", 'm',
+        "Don't start a capture if the captures in progress would exceed this many MB on disk. "
+        "Default is 0, which is unlimited.",
+        false, 0);
+  }
+  virtual const char *Description()
+  {
+    return "Run analyses over a list of captures and write the results as JSON lines.";
+  }
+  virtual bool IsInternalOnly() { return false; }
+  virtual bool IsCaptureCommand() { return false; }
+  virtual int Execute(cmdline::parser &parser, const CaptureOptions &)
+  {
+    std::vector<std::string> rest = parser.rest();
+    if(rest.empty())
+    {
+      std::cerr << "Error: batch command requires a manifest filename." << std::endl
+                << std::endl
+                << parser.usage();
+      return 0;
+    }
+
+    string manifest = rest[0];
+
+    rest.erase(rest.begin());
+
+    std::ifstream manifestFile(manifest.c_str());
+
+    if(!manifestFile)
+    {
+      std::cerr << "Couldn't open manifest '" << manifest << "'." << std::endl;
+      return 1;
+    }
+
+    // one capture per line, ignoring blank lines and # comments
+    std::string line;
+    while(std::getline(manifestFile, line))
+    {
+      size_t start = line.find_first_not_of(" \t\r\n");
+      size_t end = line.find_last_not_of(" \t\r\n");
+
+      if(start == std::string::npos || line[start] == '#')
+        continue;
+
+      m_Captures.push_back(line.substr(start, end - start + 1));
+    }
+
+    std::istringstream analyses(parser.get<string>("analyses"));
+    std::string analysis;
+    while(std::getline(analyses, analysis, ','))
+    {
+      if(analysis == "stats")
+        m_Stats = true;
+      else if(analysis == "counters")
+        m_Counters = true;
+      else if(analysis == "textures")
+        m_Textures = true;
+      else if(analysis == "structured")
+        m_Structured = true;
+      else if(!analysis.empty())
+        std::cerr << "Ignoring unknown analysis '" << analysis << "'." << std::endl;
+    }
+
+    m_OutputDir = parser.get<string>("output-dir");
+    m_Budget = uint64_t(parser.get<uint32_t>("memory-budget")) * 1024 * 1024;
+
+    std::ofstream outFile;
+    m_Out = &std::cout;
+
+    if(!parser.get<string>("output").empty())
+    {
+      outFile.open(parser.get<string>("output").c_str());
+
+      if(!outFile)
+      {
+        std::cerr << "Couldn't open output file '" << parser.get<string>("output") << "'."
+                  << std::endl;
+        return 1;
+      }
+
+      m_Out = &outFile;
+    }
+
+    RENDERDOC_InitGlobalEnv(m_Env, convertArgs(rest));
+
+    // the file size is used as the estimate of how much memory a capture will need to process
+    for(const std::string &capture : m_Captures)
+    {
+      std::ifstream f(capture.c_str(), std::ios::binary | std::ios::ate);
+      m_Sizes.push_back(f ? uint64_t(f.tellg()) : 0);
+    }
+
+    uint32_t jobs = std::max(1U, parser.get<uint32_t>("jobs"));
+
+    std::vector<std::thread> workers;
+    for(uint32_t i = 0; i < jobs; i++)
+      workers.push_back(std::thread([this]() { Worker(); }));
+
+    for(std::thread &t : workers)
+      t.join();
+
+    std::cerr << "Processed " << m_Captures.size() << " captures, " << m_Failed << " failed."
+              << std::endl;
+
+    return m_Failed > 0 ? 1 : 0;
+  }
+
+private:
+  std::vector<std::string> m_Captures;
+  std::vector<uint64_t> m_Sizes;
+
+  bool m_Stats = false, m_Counters = false, m_Textures = false, m_Structured = false;
+  std::string m_OutputDir;
+  std::ostream *m_Out = NULL;
+
+  // protects the scheduling state below and the output stream
+  std::mutex m_Lock;
+  std::condition_variable m_BudgetCondition;
+  size_t m_Next = 0;
+  size_t m_InFlight = 0;
+  uint64_t m_InFlightBytes = 0;
+  uint64_t m_Budget = 0;
+  size_t m_Failed = 0;
+
+  // drivers don't support several replays at once in the same process, so anything that needs a
+  // replay is serialised. Exporting structured data is too, since for some APIs it creates a
+  // temporary driver that sets process-wide state. Only opening files can overlap.
+  std::mutex m_ReplayLock;
+
+  void Worker()
+  {
+    for(;;)
+    {
+      size_t idx = 0;
+
+      {
+        std::unique_lock<std::mutex> lock(m_Lock);
+
+        // wait until the next capture fits in the budget. A capture is always started if nothing
+        // else is in progress, so one that is larger than the whole budget can't stall the queue.
+        for(;;)
+        {
+          if(m_Next >= m_Captures.size())
+            return;
+
+          if(m_Budget == 0 || m_InFlight == 0 || m_InFlightBytes + m_Sizes[m_Next] <= m_Budget)
+            break;
+
+          m_BudgetCondition.wait(lock);
+        }
+
+        idx = m_Next++;
+        m_InFlight++;
+        m_InFlightBytes += m_Sizes[idx];
+      }
+
+      bool success = true;
+      std::string result = ProcessCapture(idx, success);
+
+      {
+        std::unique_lock<std::mutex> lock(m_Lock);
+
+        *m_Out << result << std::endl;
+
+        if(!success)
+          m_Failed++;
+
+        m_InFlight--;
+        m_InFlightBytes -= m_Sizes[idx];
+      }
+
+      m_BudgetCondition.notify_all();
+    }
+  }
+
+  std::string ProcessCapture(size_t idx, bool &success)
+  {
+    const std::string &filename = m_Captures[idx];
+
+    std::ostringstream json;
+    json << "{\"capture\": " << JSONString(filename);
+
+    ICaptureFile *file = RENDERDOC_OpenCaptureFile();
+
+    ReplayStatus st = file->OpenFile(filename.c_str(), "rdc", NULL);
+
+    json << ", \"status\": " << JSONString(ToStr(st));
+
+    if(st != ReplayStatus::Succeeded)
+    {
+      file->Shutdown();
+      success = false;
+      json << "}";
+      return json.str();
+    }
+
+    // outputs are prefixed with the manifest index so that captures with the same name in
+    // different directories don't collide.
+    std::string basename = filename;
+    size_t slash = basename.find_last_of("/\\");
+    if(slash != std::string::npos)
+      basename = basename.substr(slash + 1);
+    size_t dot = basename.rfind('.');
+    if(dot != std::string::npos)
+      basename = basename.substr(0, dot);
+
+    std::ostringstream prefix;
+    prefix << m_OutputDir << "/" << idx << "_" << basename;
+
+    if(m_Structured)
+    {
+      std::string xml = prefix.str() + ".xml";
+
+      std::lock_guard<std::mutex> replayLock(m_ReplayLock);
+
+      st = file->Convert(xml.c_str(), "xml", NULL, NULL);
+
+      json << ", \"structured\": {\"file\": " << JSONString(xml)
+           << ", \"chunks\": " << file->GetStructuredData().chunks.size()
+           << ", \"status\": " << JSONString(ToStr(st)) << "}";
+
+      if(st != ReplayStatus::Succeeded)
+        success = false;
+    }
+
+    if(m_Stats || m_Counters || m_Textures)
+    {
+      std::lock_guard<std::mutex> replayLock(m_ReplayLock);
+
+      IReplayController *renderer = NULL;
+      std::tie(st, renderer) = file->OpenCapture(NULL);
+
+      json << ", \"replayStatus\": " << JSONString(ToStr(st));
+
+      if(st == ReplayStatus::Succeeded)
+      {
+        if(m_Stats)
+          WriteStats(json, renderer);
+        if(m_Counters)
+          WriteCounters(json, renderer);
+        if(m_Textures)
+          WriteTextures(json, renderer, prefix.str(), success);
+
+        renderer->Shutdown();
+      }
+      else
+      {
+        success = false;
+      }
+    }
+
+    file->Shutdown();
+
+    json << "}";
+    return json.str();
+  }
+
+  struct DrawStats
+  {
+    uint64_t events = 0, drawcalls = 0, dispatches = 0, clears = 0, copies = 0, markers = 0;
+  };
+
+  static void CountDrawcalls(const rdcarray<DrawcallDescription> &draws, DrawStats &stats)
+  {
+    for(const DrawcallDescription &d : draws)
+    {
+      stats.events += d.events.size();
+
+      if(d.flags & DrawFlags::Drawcall)
+        stats.drawcalls++;
+      if(d.flags & DrawFlags::Dispatch)
+        stats.dispatches++;
+      if(d.flags & DrawFlags::Clear)
+        stats.clears++;
+      if(d.flags & (DrawFlags::Copy | DrawFlags::Resolve))
+        stats.copies++;
+      if(d.flags & DrawFlags::PushMarker)
+        stats.markers++;
+
+      CountDrawcalls(d.children, stats);
+    }
+  }
+
+  void WriteStats(std::ostream &json, IReplayController *renderer)
+  {
+    DrawStats stats;
+    CountDrawcalls(renderer->GetDrawcalls(), stats);
+
+    json << ", \"stats\": {\"events\": " << stats.events << ", \"drawcalls\": " << stats.drawcalls
+         << ", \"dispatches\": " << stats.dispatches << ", \"clears\": " << stats.clears
+         << ", \"copies\": " << stats.copies << ", \"markers\": " << stats.markers
+         << ", \"resources\": " << renderer->GetResources().size()
+         << ", \"textures\": " << renderer->GetTextures().size()
+         << ", \"buffers\": " << renderer->GetBuffers().size() << "}";
+  }
+
+  void WriteCounters(std::ostream &json, IReplayController *renderer)
+  {
+    // only the generic counters are fetched, so results are comparable across captures and GPUs
+    rdcarray<GPUCounter> counters;
+    for(GPUCounter c : renderer->EnumerateCounters())
+    {
+      if(!IsAMDCounter(c) && !IsIntelCounter(c) && !IsNvidiaCounter(c))
+        counters.push_back(c);
+    }
+
+    rdcarray<CounterResult> results = renderer->FetchCounters(counters);
+
+    json << ", \"counters\": {";
+
+    for(size_t i = 0; i < counters.size(); i++)
+    {
+      CounterDescription desc = renderer->DescribeCounter(counters[i]);
+
+      const bool isFloat = desc.resultType == CompType::Float;
+
+      // integer counters are summed exactly, a double would lose precision past 2^53
+      double floatTotal = 0.0;
+      uint64_t intTotal = 0;
+
+      for(const CounterResult &r : results)
+      {
+        if(r.counter != counters[i])
+          continue;
+
+        if(isFloat)
+          floatTotal += desc.resultByteWidth == 8 ? r.value.d : r.value.f;
+        else
+          intTotal += desc.resultByteWidth == 8 ? r.value.u64 : r.value.u32;
+      }
+
+      if(i > 0)
+        json << ", ";
+
+      json << JSONString(desc.name) << ": {\"unit\": " << JSONString(ToStr(desc.unit))
+           << ", \"total\": ";
+
+      // JSON has no representation for NaN or infinity
+      if(!isFloat)
+        json << intTotal;
+      else if(std::isfinite(floatTotal))
+        json << std::setprecision(17) << floatTotal;
+      else
+        json << "null";
+
+      json << "}";
+    }
+
+    json << "}";
+  }
+
+  void WriteTextures(std::ostream &json, IReplayController *renderer, const std::string &prefix,
+                     bool &success)
+  {
+    json << ", \"textures\": [";
+
+    bool first = true;
+
+    for(const TextureDescription &tex : renderer->GetTextures())
+    {
+      if(!(tex.creationFlags & (TextureCategory::ColorTarget | TextureCategory::SwapBuffer)))
+        continue;
+
+      // ResourceId::123 -> 123, to keep the filename portable
+      std::string id = ToStr(tex.resourceId);
+      id = id.substr(id.find_last_of(':') + 1);
+
+      std::string path = prefix + "_" + id + ".png";
+
+      TextureSave save;
+      save.resourceId = tex.resourceId;
+      save.destType = FileType::PNG;
+      save.mip = 0;
+      save.slice.sliceIndex = 0;
+      save.sample.mapToArray = false;
+      save.sample.sampleIndex = ~0U;
+
+      bool saved = renderer->SaveTexture(save, path.c_str());
+
+      if(!saved)
+        success = false;
+
+      if(!first)
+        json << ", ";
+      first = false;
+
+      json << "{\"resource\": " << JSONString(ToStr(tex.resourceId))
+           << ", \"file\": " << JSONString(path) << ", \"saved\": " << (saved ? "true" : "false")
+           << "}";
+    }
+
+    json << "]";
+  }
+
+  static std::string JSONString(const std::string &str)
+  {
+    std::string ret = "\"";
+
+    for(char c : str)
+    {
+      if(c == '"' || c == '\\')
+      {
+        ret += '\\';
+        ret += c;
+      }
+      else if(c == '\n')
+      {
+        ret += "\\n";
+      }
+      else if((unsigned char)c < 0x20)
+      {
+        char buf[8];
+        snprintf(buf, sizeof(buf), "\\u%04x", c);
+        ret += buf;
+      }
+      else
+      {
+        ret += c;
+      }
+    }
+
+    ret += "\"";
+    return ret;
+  }
+};
+
 struct TestCommand : public Command
 {
   TestCommand(const GlobalEnvironment &env) : Command(env) {}
@@ -1106,6 +1554,139 @@ struct EmbeddedSectionCommand : public Command
   }
 };
 
+struct TelemetryCommand : public Command
+{
+  TelemetryCommand(const GlobalEnvironment &env) : Command(env) {}
+  virtual void AddOptions(cmdline::parser &parser)
+  {
+    parser.add<string>("host", 'h', "The host where the target is running.", false, "localhost");
+    parser.add<uint32_t>("ident", 'i',
+                         "The target ident to connect to, or 0 for the first target found.", false,
+                         0);
+    parser.add<uint32_t>("interval", 0, "How often to fetch statistics, in milliseconds.", false,
+                         1000, cmdline::range(10, 3600000));
+    parser.add<string>("log", 'l', "Append statistics to this file as CSV instead of printing.",
+                       false);
+  }
+  virtual const char *Description()
+  {
+    return "Connects to a running target and prints frame timing and overhead statistics.";
+  }
+  virtual bool IsInternalOnly() { return false; }
+  virtual bool IsCaptureCommand() { return false; }
+  virtual int Execute(cmdline::parser &parser, const CaptureOptions &)
+  {
+    RENDERDOC_InitGlobalEnv(m_Env, convertArgs(parser.rest()));
+
+    string host = parser.get<string>("host");
+    uint32_t ident = parser.get<uint32_t>("ident");
+
+    if(ident == 0)
+      ident = RENDERDOC_EnumerateRemoteTargets(host.c_str(), 0);
+
+    if(ident == 0)
+    {
+      std::cerr << "Error: couldn't find a running target on " << host << "." << std::endl;
+      return 1;
+    }
+
+    ITargetControl *conn =
+        RENDERDOC_CreateTargetControl(host.c_str(), ident, "renderdoccmd telemetry", false);
+
+    if(conn == NULL)
+    {
+      std::cerr << "Error: couldn't connect to " << host << ":" << ident << "." << std::endl;
+      return 1;
+    }
+
+    FILE *log = NULL;
+
+    if(parser.exist("log"))
+    {
+      log = fopen(parser.get<string>("log").c_str(), "a");
+
+      if(log == NULL)
+      {
+        std::cerr << "Error: couldn't open '" << parser.get<string>("log") << "' for writing."
+                  << std::endl;
+        conn->Shutdown();
+        return 1;
+      }
+
+      fprintf(log,
+              "timestamp_ms,frames,interval_ms,avg_ms,min_ms,max_ms,overhead_avg_ms,"
+              "overhead_max_ms,coherent_map_bytes,live_chunks,chunk_bytes,histogram\n");
+    }
+
+    std::cerr << "Connected to '" << conn->GetTarget() << "' [PID " << conn->GetPID() << "]."
+              << std::endl;
+
+    conn->SetTelemetryInterval(parser.get<uint32_t>("interval"));
+
+    usingKillSignal = true;
+
+    double elapsed = 0.0;
+
+    while(!killSignal)
+    {
+      TargetControlMessage msg = conn->ReceiveMessage();
+
+      if(msg.type == TargetControlMessageType::Disconnected ||
+         msg.type == TargetControlMessageType::Busy)
+      {
+        std::cerr << "Target disconnected." << std::endl;
+        break;
+      }
+
+      if(msg.type == TargetControlMessageType::RegisterAPI && msg.apiUse.presenting)
+        std::cerr << "Target is presenting with " << msg.apiUse.name.c_str() << "." << std::endl;
+
+      if(msg.type != TargetControlMessageType::FrameTelemetry)
+        continue;
+
+      const FrameTelemetryData &t = msg.telemetry;
+
+      elapsed += t.intervalTime;
+
+      std::string histogram;
+      for(size_t i = 0; i < t.frameTimeHistogram.size(); i++)
+      {
+        if(i > 0)
+          histogram += log ? ";" : " ";
+        histogram += std::to_string(t.frameTimeHistogram[i]);
+      }
+
+      if(log)
+      {
+        fprintf(log, "%.0f,%u,%.1f,%.3f,%.3f,%.3f,%.3f,%.3f,%llu,%llu,%llu,%s\n", elapsed,
+                t.frameCount, t.intervalTime, t.avgFrameTime, t.minFrameTime, t.maxFrameTime,
+                t.avgOverheadTime, t.maxOverheadTime, (unsigned long long)t.coherentMapBytes,
+                (unsigned long long)t.liveChunks, (unsigned long long)t.chunkMemory,
+                histogram.c_str());
+        fflush(log);
+      }
+      else
+      {
+        printf(
+            "%4u frames: %.2f ms (%.2f .. %.2f), overhead %.3f ms (max %.3f), "
+            "%llu map bytes, %llu chunks (%.2f MB) [%s]\n",
+            t.frameCount, t.avgFrameTime, t.minFrameTime, t.maxFrameTime, t.avgOverheadTime,
+            t.maxOverheadTime, (unsigned long long)t.coherentMapBytes,
+            (unsigned long long)t.liveChunks, double(t.chunkMemory) / (1024.0 * 1024.0),
+            histogram.c_str());
+        fflush(stdout);
+      }
+    }
+
+    if(log)
+      fclose(log);
+
+    conn->Shutdown();
+
+    return 0;
+  }
+};
+
 REPLAY_PROGRAM_MARKER()
 
 int renderdoccmd(const GlobalEnvironment &env, std::vector<std::string> &argv)
@@ -1141,8 +1722,10 @@ int renderdoccmd(const GlobalEnvironment &env, std::vector<std::string> &argv)
     add_command("capaltbit", new CapAltBitCommand(env));
     add_command("test", new TestCommand(env));
     add_command("convert", new ConvertCommand(env));
+    add_command("batch", new BatchCommand(env));
     add_command("embed", new EmbeddedSectionCommand(env, false));
     add_command("extract", new EmbeddedSectionCommand(env, true));
+    add_command("telemetry", new TelemetryCommand(env));
 
     if(argv.size() <= 1)
     {